@@ -44,7 +44,7 @@ namespace xk::core::async {
                     return;
             }
 
-            m_taskQueues[threadId].push(task);
+            m_taskQueues[threadId % m_threadCount].push(task);
         }
 
         /** Schedules a task with arguments and returns a future of the return type or an exception */
@@ -5,6 +5,10 @@
 #ifndef XK_APPLICATION_H
 #define XK_APPLICATION_H
 
+#include <optional>
+#include <filesystem>
+#include <string_view>
+
 #include <xk-graphics-engine/xk-engine/graphics_engine.h>
 #include <window/win_main_window.h>
 #include <utility/literal.h>
@@ -26,19 +30,49 @@ namespace xk::application
 
         using MainWindow = win::MainWindow<GraphicsApi, ValidationLayersEnable>;
 
+        //A tear-off panel, rendered on the device of the main window
+        struct Panel
+        {
+            std::shared_ptr<Window>     window;
+            GraphicsApi::WindowId       id;
+        };
+
         std::weak_ptr<MainWindow> getMainWindow();
 
+        //--headless [output.png], renders one frame without a window and writes it out
+        static std::optional<std::filesystem::path> headlessOutput(int argc, const char* argv[]);
+
+        void renderHeadless(const std::filesystem::path& output);
+
+        //--panels <count>, opens that many panel windows next to the main window
+        static u32 panelCount(int argc, const char* argv[]);
+
+        void openPanel(std::string_view title, u32 width, u32 height);
+
+        //Detaches and destroys the panels the user closed
+        void closePanels();
+
+        //Renders only when a window is damaged, otherwise sleeps in the event queue
+        void runEventLoop();
+
+        //Renders every damaged window and presents them together
+        void renderFrame();
+
     public:
         Core(int argc, const char* argv[]);
 
+        ~Core();
+
         void run();
 
     private:
+        std::optional<std::filesystem::path> m_headlessOutput;
+
         std::shared_ptr<GraphicsApi> m_graphicsEngine;
 
         std::shared_ptr<MainWindow> m_mainWindow;
 
-        std::vector<std::shared_ptr<Window>> m_widgets;
+        std::vector<Panel> m_widgets;
     };
 }
 
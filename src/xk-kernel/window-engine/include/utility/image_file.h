@@ -0,0 +1,27 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_IMAGE_FILE_H
+#define XK_IMAGE_FILE_H
+
+#include <span>
+#include <filesystem>
+
+#include <utility/literal.h>
+
+namespace xk::io
+{
+    /** Writes tightly packed 8 bit RGBA pixels as a PNG file
+     *    the image data is stored without compression, the files are meant for golden image
+     *    comparisons and thumbnails, not for size, so no zlib dependency is needed
+     *    throws std::invalid_argument when the pixel count does not match the size
+     *    and std::system_error when the file cannot be written
+     */
+    void writePng(const std::filesystem::path& path, u32 width, u32 height, std::span<const u8> rgba);
+
+    /** Writes bytes as they are, throws std::system_error when the file cannot be written */
+    void writeRaw(const std::filesystem::path& path, std::span<const u8> bytes);
+}
+
+#endif //XK_IMAGE_FILE_H
@@ -0,0 +1,50 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_MAPPED_FILE_H
+#define XK_MAPPED_FILE_H
+
+#include <span>
+#include <filesystem>
+
+#include <utility/literal.h>
+
+namespace xk::io
+{
+    /** Read-only memory mapping of a whole file, the mapping is page aligned and released on destruction */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+
+        /** Throws std::system_error when the file cannot be opened or mapped */
+        explicit MappedFile(const std::filesystem::path& path);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        [[nodiscard]] inline std::span<const u8> bytes() const { return { static_cast<const u8*>(m_data), m_size }; }
+
+        [[nodiscard]] inline bool isOpen() const { return m_data != nullptr; }
+
+    private:
+        void unmap();
+
+        const void* m_data{ nullptr };
+
+        Size_t      m_size{ 0 };
+
+#ifdef _WIN32
+        void*       m_file{ nullptr };
+        void*       m_mapping{ nullptr };
+#endif
+    };
+}
+
+#endif //XK_MAPPED_FILE_H
@@ -0,0 +1,88 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_TRACE_H
+#define XK_TRACE_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <string_view>
+
+#include <utility/literal.h>
+
+namespace xk::trace
+{
+    //Timelines shown as separate rows in chrome://tracing / Perfetto
+    enum class Timeline : u32
+    {
+        Cpu = 1,
+        Gpu = 2
+    };
+
+    struct Event
+    {
+        std::string name{};
+        std::string category{};
+        Timeline    timeline{ Timeline::Cpu };
+        u64         threadId{ 0 };
+        f64         startUs{ 0.0 };
+        f64         durationUs{ 0.0 };
+    };
+
+    /** Collects complete ("X") events from CPU and GPU zones and writes them as a Chrome trace */
+    class Collector
+    {
+    public:
+        static Collector& instance();
+
+        /** Microseconds since the collector was created, the common time base of all zones */
+        [[nodiscard]] f64 nowUs() const;
+
+        void add(Event&& event);
+
+        void setEnabled(bool enabled);
+
+        [[nodiscard]] inline bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+        /** Writes the collected events in the Chrome trace event JSON format */
+        bool writeChromeTrace(std::string_view path) const;
+
+        void clear();
+
+    private:
+        Collector();
+
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point   m_origin;
+
+        mutable std::mutex  m_mutex;
+
+        std::vector<Event>  m_events{};
+
+        std::atomic<bool>   m_enabled{ false };
+    };
+
+    /** RAII CPU zone, records the scope duration on the calling thread */
+    class ScopedZone
+    {
+    public:
+        explicit ScopedZone(std::string_view name, std::string_view category = "cpu");
+
+        ~ScopedZone();
+
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+
+    private:
+        std::string_view    m_name;
+        std::string_view    m_category;
+        f64                 m_startUs{ 0.0 };
+    };
+}
+
+#endif //XK_TRACE_H
@@ -0,0 +1,68 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_WIN_DAMAGE_REGION_H
+#define XK_WIN_DAMAGE_REGION_H
+
+#include <vector>
+
+#include <utility/literal.h>
+
+namespace xk::win
+{
+    /** Rectangle in framebuffer pixels, origin in the top left corner */
+    struct Rect
+    {
+        s32 x{ 0 };
+        s32 y{ 0 };
+        u32 width{ 0 };
+        u32 height{ 0 };
+
+        [[nodiscard]] inline bool isEmpty() const { return width == 0 || height == 0; }
+
+        [[nodiscard]] inline s32 right() const { return x + static_cast<s32>(width); }
+
+        [[nodiscard]] inline s32 bottom() const { return y + static_cast<s32>(height); }
+
+        bool operator==(const Rect&) const = default;
+    };
+
+    class DamageRegion
+    {
+        /** This class represents the parts of a window that have to be redrawn
+         *    rectangles are clipped to the window, a new one that overlaps or touches existing ones
+         *    absorbs them into their bounding box, which is repeated until no two rectangles touch,
+         *    past MaxRects the whole region collapses into one bounding box, a few larger rectangles
+         *    are cheaper for the compositor than many small ones
+         */
+
+    public:
+        static constexpr Size_t MaxRects{ 16 };
+
+        /** Size of the window, rectangles outside are dropped */
+        void setBounds(u32 width, u32 height);
+
+        void add(Rect rect);
+
+        /** Damages the whole window */
+        void addAll();
+
+        void clear();
+
+        [[nodiscard]] inline bool isEmpty() const { return m_rects.empty(); }
+
+        [[nodiscard]] inline auto& rects() const { return m_rects; }
+
+        /** Bounding box of every damaged rectangle, empty when nothing is damaged */
+        [[nodiscard]] Rect bounds() const;
+
+    private:
+        std::vector<Rect>   m_rects{};
+
+        u32                 m_width{ 0 };
+        u32                 m_height{ 0 };
+    };
+}
+
+#endif //XK_WIN_DAMAGE_REGION_H
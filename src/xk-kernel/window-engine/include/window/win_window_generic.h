@@ -13,6 +13,7 @@
 
 /*standard*/
 #include <array>
+#include <atomic>
 #include <string>
 #include <functional>
 #include <limits>
@@ -23,6 +24,7 @@
 
 #include <window/win_exceptions_generic.h>
 #include <window/win_keyboard.h>
+#include <window/win_damage_region.h>
 
 #include <xk-graphics-engine/xk-engine/graphics_engine.h>
 
@@ -39,6 +41,12 @@ namespace xk::win
 
     using WindowEngine = GLFWwindow;
 
+    namespace detail
+    {
+        //Windows alive across all GenericWindow types, GLFW is terminated with the last one
+        inline u32 OpenWindows{ 0 };
+    }
+
     template<typename GraphicsApi, bool IsValidationEnabled>
     class GenericWindow
     {
@@ -52,6 +60,8 @@ namespace xk::win
 
         static void windowCloseCallback(WindowEngine* window);
 
+        static void windowRefreshCallback(WindowEngine* window);
+
         virtual void keyPressedEvent(Key key, int scancode, int action, int mods) = 0;
 
         virtual void resizedEvent(u32 width, u32 height) = 0;
@@ -74,6 +84,27 @@ namespace xk::win
 
         void update();
 
+        /** Processes events, blocks for at most timeoutSeconds when nothing has to be redrawn
+         *    input, a resize, an expose or requestRedraw() wake it up earlier */
+        void waitEvents(f64 timeoutSeconds);
+
+        /** Marks the whole window for redraw */
+        void invalidate();
+
+        /** Marks rect for redraw, called by whatever changed what is shown there */
+        void invalidate(Rect rect);
+
+        /** Thread safe, wakes waitEvents() and redraws the whole window */
+        void requestRedraw();
+
+        /** True when something is damaged and the window is not minimized */
+        [[nodiscard]] bool needsRedraw() const;
+
+        /** Hands the damage over to the frame being rendered and clears it */
+        [[nodiscard]] DamageRegion takeDamage();
+
+        [[nodiscard]] inline bool isMinimized() const { return m_width == 0 || m_height == 0; }
+
         void show();
 
         void showFullWindow();
@@ -84,6 +115,9 @@ namespace xk::win
 
         [[nodiscard]] VkSurfaceKHR createVulkanWindowSurface(VkInstance vulkanInstance) const;
 
+        /** Identifies the window to the graphics engine, e.g. for Core::attachWindow */
+        [[nodiscard]] inline WindowEngine* nativeHandle() const { return m_window; }
+
     private:
         std::weak_ptr<GraphicsApi> m_graphicsEngine;
 
@@ -94,6 +128,11 @@ namespace xk::win
         WindowEngine* m_window{};
 
         bool m_isShown{};
+
+        //Only touched on the thread that polls events
+        DamageRegion m_damage{};
+
+        std::atomic<bool> m_redrawRequested{ false };
     };
 
     extern template class GenericWindow<graphics_engine::gl::Core<true>, true>;
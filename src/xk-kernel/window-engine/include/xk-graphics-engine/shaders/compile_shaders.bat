@@ -1,2 +0,0 @@
-C:\VulkanSDK\1.2.189.2\Bin\glslc.exe simple_shader.vert -o simple_shader.vert.spv
-C:\VulkanSDK\1.2.189.2\Bin\glslc.exe simple_shader.frag -o simple_shader.frag.spv
\ No newline at end of file
@@ -0,0 +1,49 @@
+# Turns a SPIR-V binary into a header with an aligned constexpr u32 array
+# invoked at build time: cmake -DSPIRV=<file.spv> -DSYMBOL=<identifier> -DOUTPUT=<header.h> -P embed_spirv.cmake
+
+file(READ "${SPIRV}" SPIRV_HEX HEX)
+
+string(LENGTH "${SPIRV_HEX}" SPIRV_HEX_LENGTH)
+math(EXPR SPIRV_WORD_REMAINDER "${SPIRV_HEX_LENGTH} % 8")
+
+if (NOT SPIRV_WORD_REMAINDER EQUAL 0)
+    message(FATAL_ERROR "${SPIRV} is not SPIR-V, its size is not a multiple of 4")
+endif()
+
+# SPIR-V words are little endian, so the bytes of each word are reversed when printed as hex
+string(REGEX MATCHALL "........" SPIRV_WORDS "${SPIRV_HEX}")
+
+set(SPIRV_ARRAY "")
+set(WORDS_ON_LINE 0)
+
+foreach(WORD ${SPIRV_WORDS})
+    string(SUBSTRING "${WORD}" 0 2 BYTE0)
+    string(SUBSTRING "${WORD}" 2 2 BYTE1)
+    string(SUBSTRING "${WORD}" 4 2 BYTE2)
+    string(SUBSTRING "${WORD}" 6 2 BYTE3)
+
+    string(APPEND SPIRV_ARRAY "0x${BYTE3}${BYTE2}${BYTE1}${BYTE0}, ")
+
+    math(EXPR WORDS_ON_LINE "${WORDS_ON_LINE} + 1")
+
+    if (WORDS_ON_LINE EQUAL 8)
+        string(APPEND SPIRV_ARRAY "\n        ")
+        set(WORDS_ON_LINE 0)
+    endif()
+endforeach()
+
+file(WRITE "${OUTPUT}"
+"// Generated from ${SPIRV} by embed_spirv.cmake, do not edit
+
+#pragma once
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::shaders
+{
+    alignas(u32) inline constexpr u32 ${SYMBOL}[]
+    {
+        ${SPIRV_ARRAY}
+    };
+}
+")
@@ -12,6 +12,9 @@
 namespace xk::graphics_engine::vulkan
 {
     static std::vector<const char*> DeviceExtensions{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+
+    //Enabled when the device supports them, features built on top check GpuWrapper::isDeviceExtensionEnabled
+    static std::vector<const char*> OptionalDeviceExtensions{ VK_EXT_MEMORY_BUDGET_EXTENSION_NAME };
 }
 
 #endif //XK_VK_DEVICE_EXTENSIONS_H
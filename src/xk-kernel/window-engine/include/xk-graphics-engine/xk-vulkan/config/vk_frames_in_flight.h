@@ -0,0 +1,16 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_FRAMES_IN_FLIGHT_H
+#define XK_VK_FRAMES_IN_FLIGHT_H
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    //Default number of frames the CPU may record ahead of the GPU, FramePacingPolicy chooses the actual one at runtime
+    static constexpr Size_t FramesInFlight{ 2 };
+}
+
+#endif //XK_VK_FRAMES_IN_FLIGHT_H
@@ -5,10 +5,29 @@
 #ifndef XK_VK_CORE
 #define XK_VK_CORE
 
+#include <span>
+#include <chrono>
 #include <memory>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <functional>
+#include <string_view>
 #include <xk-graphics-engine/xk-engine/graphics_engine_config.h>
 #include <xk-graphics-engine/xk-vulkan/vk_gpu_wrapper.h>
 #include <xk-graphics-engine/xk-vulkan/vk_pipeline.h>
+#include <xk-graphics-engine/xk-vulkan/vk_gpu_profiler.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_compiler.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_state_cache.h>
+#include <xk-graphics-engine/xk-vulkan/vk_shader_registry.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_layout_cache.h>
+#include <xk-graphics-engine/xk-vulkan/vk_shader_hot_reload.h>
+#include <xk-graphics-engine/xk-vulkan/vk_offscreen_target.h>
+#include <xk-graphics-engine/xk-vulkan/vk_swap_chain.h>
+#include <xk-graphics-engine/xk-vulkan/vk_frame_graph.h>
+#include <xk-graphics-engine/xk-vulkan/vk_frame_statistics.h>
+
+struct GLFWwindow;
 
 namespace xk::win
 {
@@ -24,24 +43,228 @@ namespace xk::graphics_engine::vulkan
 
         using PipelineT = Pipeline<ValidationLayersEnabled>;
         using InstanceT = GpuWrapper<ValidationLayersEnabled>;
+        using SwapChainT = SwapChain<ValidationLayersEnabled>;
 
     public:
+        using FrameGraphT = FrameGraph<ValidationLayersEnabled>;
+
+        using WindowId = u32;
+
+        using RecoveryClock = std::chrono::steady_clock;
+
+        //The window passed to setupForWindow
+        static constexpr WindowId MainWindowId{ 0 };
+
+        /** What drawWindows renders into one window */
+        struct WindowFrame
+        {
+            WindowId                            window{ MainWindowId };
+            std::function<void(VkCommandBuffer)> record{};
+            VkClearColorValue                   clearColor{};
+            std::span<const VkRect2D>           damage{};
+        };
+
+        /** Adds the passes of a frame, backBuffer is the swap image, imported and left ready for presentation
+         *    the last pass writing backBuffer composes the frame and converts it as swapChain()->outputEncoding() says */
+        using FrameGraphBuilder = std::function<void(FrameGraphT& graph, typename FrameGraphT::ResourceId backBuffer)>;
+
         static constexpr auto Type{ xk::graphics_engine::GraphicsApi::Vulkan };
 
         explicit Core();
 
+        ~Core();
+
         std::shared_ptr<Core> createCore();
 
         void setupForWindow(std::weak_ptr<ParentWindow> parent);
 
+        /** Sets up without a window, frames are rendered with OffscreenTargets created by createOffscreenTarget */
+        void setupHeadless();
+
+        /** The first target of a headless setup also gets the base pipeline requested for its attachments */
+        [[nodiscard]] std::unique_ptr<OffscreenTarget<ValidationLayersEnabled>> createOffscreenTarget(VkExtent2D extent);
+
+        /** Renders another window, e.g. a tear-off panel, on the device of the main window
+         *    the window gets its own surface and swapchain, paced by the main window */
+        WindowId attachWindow(GLFWwindow* window);
+
+        /** Waits for the device, destroys the swapchain and surface, call before the window is destroyed */
+        void detachWindow(WindowId id);
+
+        /** Framebuffer size of window changed, its swapchain is rebuilt at the next acquire without waiting for the device */
+        void resize(GLFWwindow* window, u32 width, u32 height);
+
+        /** Switches the pacing mode of the swapchain, logs the input to present latency measured in the previous one */
+        void setFramePacing(FramePacingMode mode);
+
+        /** Drops the depth buffer of the window from the next frame on, for pure 2D UI, see SwapChain::setDepthEnabled
+         *    the base pipeline is requested again for the new depth format by the frame that applies it */
+        void setDepthEnabled(bool enabled);
+
+        /** Switches the format and color space of every window from the next frame on, see SurfaceFormatPolicy
+         *    falls back to 8 bit sRGB on surfaces that do not offer the mode, a new color format
+         *    requests the base pipeline again like setDepthEnabled */
+        void setSurfaceFormat(SurfaceFormatMode mode);
+
+        /** Draws the frame times of the main window over every frame rendered by drawFrame or drawWindows
+         *    enabled from the start when XK_FRAME_OVERLAY is set, the statistics are recorded either way */
+        void setStatisticsOverlay(bool enabled);
+
+        /** Timestamps user input, see LatencyTracker */
+        void markInput();
+
+        /** Called once per frame before recording, applies changes that have to wait for a frame boundary
+         *    recreates lost surfaces and rebuilds a lost device, frames are skipped until that succeeded
+         *    true when one of them changed what a frame looks like, so the window has to be redrawn */
+        bool update();
+
+        /** True while frames of the window are skipped until update() recovered its surface or the device */
+        [[nodiscard]] bool isRecovering(WindowId id) const;
+
+        /** When update() tries again to recover a lost surface or device, nullopt while nothing is lost
+         *    nothing can be drawn before, so the caller may sleep until then */
+        [[nodiscard]] std::optional<RecoveryClock::time_point> nextRecoveryAttempt() const;
+
+        /** Renders and presents one frame of the window, record is called inside the rendering of the swap image
+         *    damage lists the changed pixels for VK_KHR_incremental_present, empty for the whole image
+         *    false when no image could be acquired, e.g. while the swapchain is being recreated */
+        bool drawFrame(const std::function<void(VkCommandBuffer)>& record, VkClearColorValue clearColor, std::span<const VkRect2D> damage = {});
+
+        /** Renders one frame for each window in frames and presents all of them with one vkQueuePresentKHR
+         *    returns per frame whether it was presented, see drawFrame */
+        std::vector<bool> drawWindows(std::span<const WindowFrame> frames);
+
+        /** Renders and presents one frame built as a FrameGraph, passes render through DynamicRendering::beginRendering
+         *    or record transfers and dispatches, barriers between them are placed by the graph */
+        bool drawFrameGraph(const FrameGraphBuilder& build, std::span<const VkRect2D> damage = {});
+
         [[nodiscard]] inline auto& pipeline() const { return m_pipeline; }
 
+        //Of the main window, nullptr when set up headless
+        [[nodiscard]] inline auto* swapChain() const { return m_windows.empty() ? nullptr : m_windows.front().swapChain.get(); }
+
+        [[nodiscard]] inline auto& gpuProfiler() const { return *m_gpuProfiler; }
+
+        [[nodiscard]] inline auto& shaderRegistry() const { return *m_shaderRegistry; }
+
+        [[nodiscard]] inline auto& pipelineLayoutCache() const { return *m_pipelineLayoutCache; }
+
+        [[nodiscard]] inline auto& pipelineCompiler() const { return *m_pipelineCompiler; }
+
+        [[nodiscard]] inline auto& pipelineStateCache() const { return *m_pipelineStateCache; }
+
     private:
+        //Between attempts to recreate a surface or rebuild the device, e.g. while a driver resets or a monitor is unplugged
+        static constexpr std::chrono::milliseconds RecoveryRetryInterval{ 1000 };
+
+        struct WindowTarget
+        {
+            WindowId                        id{ MainWindowId };
+            GLFWwindow*                     window{ nullptr };
+
+            //Owned by the target, except the one of the main window owned by the GpuWrapper
+            VkSurfaceKHR                    surface{ VK_NULL_HANDLE };
+
+            std::unique_ptr<SwapChainT>     swapChain{};
+
+            //One per frame slot of the swapchain, freed with the command pool of the GpuWrapper
+            std::vector<VkCommandBuffer>    commandBuffers{};
+
+            //Set when recreating the surface failed
+            RecoveryClock::time_point       nextSurfaceAttempt{};
+        };
+
+        /** What is rebuilt on a new device, captured when the loss is noticed, the objects holding it go with the device */
+        struct LostDevice
+        {
+            FramePacingPolicy                           pacing{};
+            SurfaceFormatPolicy                         surfaceFormat{};
+            bool                                        depthEnabled{ true };
+            bool                                        statisticsOverlay{ false };
+
+            //Windows besides the main window, with the ids handed out by attachWindow
+            std::vector<std::pair<WindowId, GLFWwindow*>> windows{};
+
+            //Restored with their ShaderIds, the retained pipeline keys refer to them
+            std::vector<ShaderSource>                   shaders{};
+
+            std::vector<PipelineKey>                    pipelines{};
+        };
+
+        //Shared by both setups, everything created after the GpuWrapper
+        //retainedShaders are restored into the new registry after a device loss
+        void createPipelineServices(std::span<const ShaderSource> retainedShaders = {});
+
+        [[nodiscard]] VkSurfaceKHR createWindowSurface(GLFWwindow* window) const;
+
+        [[nodiscard]] WindowTarget createMainWindowTarget(FramePacingPolicy pacing, SurfaceFormatPolicy surfaceFormat);
+
+        [[nodiscard]] WindowTarget createWindowTarget(WindowId id, GLFWwindow* window);
+
+        [[nodiscard]] std::vector<VkCommandBuffer> createFrameCommandBuffers() const;
+
+        [[nodiscard]] WindowTarget* findWindow(WindowId id);
+
+        /** Acquires, records the frame with record and submits it, the caller presents
+         *    false when no image could be acquired */
+        bool submitFrame(WindowTarget& target, const std::function<void(VkCommandBuffer, Index_t imageIndex)>& record, std::span<const VkRect2D> damage);
+
+        /** Requests the base pipeline and fallback again for the current render pass and formats of swapChain */
+        void retargetPipeline(const SwapChainT& swapChain);
+
+        bool recordFrame(WindowTarget& target, const std::function<void(VkCommandBuffer, Index_t imageIndex)>& record, std::span<const VkRect2D> damage);
+
+        /** Stops rendering and captures what rebuildDevice needs, the device is rebuilt by the next update */
+        void markDeviceLost(std::string_view reason);
+
+        /** Destroys everything created on the lost device and the GpuWrapper itself */
+        void releaseDevice();
+
+        void rebuildDevice(const LostDevice& lost);
+
+        bool recoverDevice();
+
+        bool recoverSurface(WindowTarget& target);
+
         std::weak_ptr<ParentWindow> m_parentWindow;
 
         std::shared_ptr<InstanceT> m_instance;
 
         std::shared_ptr<PipelineT> m_pipeline;
+
+        //Only filled for a window, the main window first, destroyed before the GpuWrapper it retires resources into
+        std::vector<WindowTarget> m_windows;
+
+        WindowId m_nextWindowId{ MainWindowId + 1 };
+
+        //Rebuilt every frame by drawFrameGraph, keeps its transient images between frames
+        std::unique_ptr<FrameGraphT> m_frameGraph;
+
+        std::unique_ptr<GpuProfiler> m_gpuProfiler;
+
+        //Outlive the compiler, compiles still running read their modules and layouts
+        std::unique_ptr<ShaderRegistry> m_shaderRegistry;
+
+        std::unique_ptr<PipelineLayoutCache> m_pipelineLayoutCache;
+
+        //Destroyed before the members above, waits for compiles still using the device
+        std::unique_ptr<PipelineCompiler> m_pipelineCompiler;
+
+        std::unique_ptr<PipelineStateCache> m_pipelineStateCache;
+
+        //SwapChain::renderTargetVersion of the main window the base pipeline was requested for
+        u64 m_pipelineTargetVersion{ 0 };
+
+        //Only created while the overlay is shown
+        std::unique_ptr<FrameStatisticsOverlay> m_statisticsOverlay;
+
+        //Only created when XK_SHADER_HOT_RELOAD is set, destroyed first
+        std::unique_ptr<ShaderHotReload> m_shaderHotReload;
+
+        //Set from the loss of the device until it is rebuilt
+        std::optional<LostDevice> m_lostDevice;
+
+        RecoveryClock::time_point m_nextRecoveryAttempt{};
     };
 
     extern template class Core<true>;
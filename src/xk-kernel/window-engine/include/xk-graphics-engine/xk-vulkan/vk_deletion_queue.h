@@ -0,0 +1,155 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_DELETION_QUEUE_H
+#define XK_VK_DELETION_QUEUE_H
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <type_traits>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    class DeletionQueue
+    {
+        /** This class represents a deferred destruction ring for Vulkan handles
+         *    handles are retired into the bucket of the frame that is currently being recorded
+         *    and released only once the GPU has signalled completion of that frame,
+         *    so swapping resources at runtime never needs vkDeviceWaitIdle
+         *    the frame number is one counter for the whole device, every window records into the same frame,
+         *    and a frame is complete once the fence of every submission recorded in it or before it has signalled
+         */
+
+    public:
+        using FrameNumber = u64;
+
+        using Deleter = std::function<void(VkDevice)>;
+
+        /** Moves the queue to the next recorded frame, later retirements are tagged with the returned number
+         *    called once per frame for all windows together */
+        FrameNumber beginFrame();
+
+        /** A submission recorded in frame was handed to the queue, its frame stays uncollected until markCompleted */
+        void markSubmitted(FrameNumber frame);
+
+        /** The fence of a submission passed to markSubmitted has signalled */
+        void markCompleted(FrameNumber frame);
+
+        /** Releases every handle retired in frames before the current one that no submission still in flight was recorded in or after */
+        void collect(VkDevice device);
+
+        /** Releases everything regardless of frame, the caller has to guarantee the device is idle */
+        void flush(VkDevice device);
+
+        /** Retires a custom deleter into the current frame bucket */
+        void push(Deleter&& deleter);
+
+        /** Retires a Vulkan handle into the current frame bucket */
+        template<typename Handle>
+        void destroyLater(Handle handle)
+        {
+            if (handle == VK_NULL_HANDLE)
+            {
+                return;
+            }
+
+            push([handle](VkDevice device) { destroy(device, handle); });
+        }
+
+        [[nodiscard]] inline auto currentFrame() const { return m_currentFrame; }
+
+        [[nodiscard]] Size_t pendingCount() const;
+
+    private:
+        template<typename Handle>
+        static void destroy(VkDevice device, Handle handle)
+        {
+            if constexpr (std::is_same_v<Handle, VkPipeline>)
+            {
+                vkDestroyPipeline(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkPipelineLayout>)
+            {
+                vkDestroyPipelineLayout(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkDescriptorSetLayout>)
+            {
+                vkDestroyDescriptorSetLayout(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkShaderModule>)
+            {
+                vkDestroyShaderModule(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkBuffer>)
+            {
+                vkDestroyBuffer(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkImage>)
+            {
+                vkDestroyImage(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkImageView>)
+            {
+                vkDestroyImageView(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkSampler>)
+            {
+                vkDestroySampler(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkFramebuffer>)
+            {
+                vkDestroyFramebuffer(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkRenderPass>)
+            {
+                vkDestroyRenderPass(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkSemaphore>)
+            {
+                vkDestroySemaphore(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkFence>)
+            {
+                vkDestroyFence(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkSwapchainKHR>)
+            {
+                vkDestroySwapchainKHR(device, handle, nullptr);
+            }
+            else if constexpr (std::is_same_v<Handle, VkDeviceMemory>)
+            {
+                vkFreeMemory(device, handle, nullptr);
+            }
+            else
+            {
+                static_assert(!sizeof(Handle), "DeletionQueue: unsupported handle type, use push() with a custom deleter");
+            }
+        }
+
+        struct Bucket
+        {
+            FrameNumber             frame{};
+            std::vector<Deleter>    deleters{};
+        };
+
+        mutable std::mutex  m_mutex;
+
+        //Ordered from the oldest retired frame to the current one
+        std::deque<Bucket>  m_buckets{};
+
+        //Submissions still in flight per frame they were recorded in
+        std::map<FrameNumber, u32> m_inFlight{};
+
+        FrameNumber         m_currentFrame{ 0 };
+    };
+}
+
+#endif //XK_VK_DELETION_QUEUE_H
@@ -0,0 +1,141 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_DESCRIPTOR_HEAP_H
+#define XK_VK_DESCRIPTOR_HEAP_H
+
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_deletion_queue.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    /** Free-list allocator handing out stable slots of a descriptor array */
+    class DescriptorIndexAllocator
+    {
+    public:
+        static constexpr u32 InvalidIndex{ ~u32{ 0 } };
+
+        explicit DescriptorIndexAllocator(u32 capacity = 0);
+
+        [[nodiscard]] u32 allocate();
+
+        void release(u32 index);
+
+        [[nodiscard]] inline auto capacity() const { return m_capacity; }
+
+        [[nodiscard]] inline auto used() const { return m_next - static_cast<u32>(m_freeList.size()); }
+
+    private:
+        u32 m_capacity{ 0 };
+
+        //Slots below m_next that were released and can be handed out again
+        std::vector<u32> m_freeList{};
+
+        u32 m_next{ 0 };
+    };
+
+    struct DescriptorHeapCapacity
+    {
+        u32 sampledImages{ 16384 };
+        u32 storageBuffers{ 4096 };
+        u32 samplers{ 256 };
+    };
+
+    class DescriptorHeap
+    {
+        /** This class represents the one global bindless descriptor set
+         *    it is created with update-after-bind and partially-bound arrays of sampled images,
+         *    storage buffers and samplers, resources get a stable index which shaders use directly
+         *    so draws never rebind descriptors, every pipeline shares a single pipeline layout
+         */
+
+        void createSetLayout();
+
+        void createPool();
+
+        void allocateSet();
+
+        void createPipelineLayout();
+
+        void deferRelease(DescriptorIndexAllocator& allocator, u32 index);
+
+    public:
+        //Bindings inside the global set, mirrored in the shaders
+        static constexpr u32 SampledImageBinding{ 0 };
+        static constexpr u32 StorageBufferBinding{ 1 };
+        static constexpr u32 SamplerBinding{ 2 };
+
+        //Push constants are the only per-draw data, 128 bytes is the guaranteed minimum
+        static constexpr u32 PushConstantSize{ 128 };
+
+        using Index = u32;
+
+        static constexpr Index InvalidIndex{ DescriptorIndexAllocator::InvalidIndex };
+
+        DescriptorHeap(VkPhysicalDevice gpu, VkDevice device, DeletionQueue& deletionQueue, DescriptorHeapCapacity capacity = {});
+
+        ~DescriptorHeap();
+
+        DescriptorHeap(const DescriptorHeap&) = delete;
+        DescriptorHeap& operator=(const DescriptorHeap&) = delete;
+
+        /** Returns true when the gpu is a Vulkan 1.2 device exposing every descriptor indexing feature the heap relies on */
+        static bool isSupported(VkPhysicalDevice gpu);
+
+        [[nodiscard]] Index registerSampledImage(VkImageView imageView, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        [[nodiscard]] Index registerStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+        [[nodiscard]] Index registerSampler(VkSampler sampler);
+
+        void updateSampledImage(Index index, VkImageView imageView, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        void updateStorageBuffer(Index index, VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+        /** Releases are deferred until no frame in flight can still index the slot */
+        void releaseSampledImage(Index index);
+
+        void releaseStorageBuffer(Index index);
+
+        void releaseSampler(Index index);
+
+        void bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS) const;
+
+        [[nodiscard]] inline auto& getSetLayout() const { return m_setLayout; }
+
+        [[nodiscard]] inline auto& getPipelineLayout() const { return m_pipelineLayout; }
+
+        [[nodiscard]] inline auto& getCapacity() const { return m_capacity; }
+
+    private:
+        VkDevice                    m_device{ VK_NULL_HANDLE };
+
+        DeletionQueue&              m_deletionQueue;
+
+        DescriptorHeapCapacity      m_capacity{};
+
+        VkDescriptorSetLayout       m_setLayout{ VK_NULL_HANDLE };
+
+        VkDescriptorPool            m_pool{ VK_NULL_HANDLE };
+
+        VkDescriptorSet             m_set{ VK_NULL_HANDLE };
+
+        //The one layout shared by every pipeline: global set + push constants
+        VkPipelineLayout            m_pipelineLayout{ VK_NULL_HANDLE };
+
+        std::mutex                  m_mutex;
+
+        DescriptorIndexAllocator    m_sampledImages{};
+        DescriptorIndexAllocator    m_storageBuffers{};
+        DescriptorIndexAllocator    m_samplers{};
+    };
+}
+
+#endif //XK_VK_DESCRIPTOR_HEAP_H
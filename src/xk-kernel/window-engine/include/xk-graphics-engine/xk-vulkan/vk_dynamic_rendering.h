@@ -0,0 +1,77 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_DYNAMIC_RENDERING_H
+#define XK_VK_DYNAMIC_RENDERING_H
+
+#include <string_view>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    /** Attachments of one dynamic rendering pass, mirrors the color and depth attachment of the render pass path */
+    struct RenderTarget
+    {
+        VkImage             colorImage{ VK_NULL_HANDLE };
+        VkImageView         colorView{ VK_NULL_HANDLE };
+
+        //Optional, no depth attachment when left empty
+        VkImage             depthImage{ VK_NULL_HANDLE };
+        VkImageView         depthView{ VK_NULL_HANDLE };
+        VkImageAspectFlags  depthAspect{ VK_IMAGE_ASPECT_DEPTH_BIT };
+
+        VkExtent2D          extent{};
+
+        VkClearColorValue   clearColor{};
+
+        //Layout the color image is left in by end(), the presentation layout for swapchain images, TRANSFER_SRC for readback
+        VkImageLayout       finalLayout{ VK_IMAGE_LAYOUT_PRESENT_SRC_KHR };
+    };
+
+    class DynamicRendering
+    {
+        /** This class represents rendering without VkRenderPass and VkFramebuffer objects
+         *    built on VK_KHR_dynamic_rendering, attachments are passed when recording, so resizing
+         *    only recreates images and views, pipelines are keyed on attachment formats instead of a
+         *    render pass handle and survive a resize, the layout transitions a render pass would do
+         *    are recorded as barriers around the pass
+         *    when the device lacks the extension the swapchain falls back to the render pass path
+         */
+
+    public:
+        //Set to "renderpass" to force the render pass path on devices supporting dynamic rendering
+        static constexpr std::string_view EnvironmentVariable{ "XK_RENDER_PATH" };
+
+        /** True when the device exposes the extension and its feature */
+        [[nodiscard]] static bool isSupported(VkPhysicalDevice gpu);
+
+        /** True when XK_RENDER_PATH asks for the render pass path */
+        [[nodiscard]] static bool isDisabled();
+
+        /** Loads the entry points, the device has to be created with the extension and feature enabled */
+        explicit DynamicRendering(VkDevice device);
+
+        /** Transitions the attachments and begins rendering into them, clearing both */
+        void begin(VkCommandBuffer commandBuffer, const RenderTarget& target) const;
+
+        /** Ends rendering and transitions the color image to target.finalLayout */
+        void end(VkCommandBuffer commandBuffer, const RenderTarget& target) const;
+
+        /** begin() without the transitions, for attachments already in their attachment layouts, e.g. FrameGraph passes */
+        void beginRendering(VkCommandBuffer commandBuffer, const RenderTarget& target) const;
+
+        /** end() without the transition */
+        void endRendering(VkCommandBuffer commandBuffer) const;
+
+    private:
+        PFN_vkCmdBeginRenderingKHR  m_cmdBeginRendering{ nullptr };
+
+        PFN_vkCmdEndRenderingKHR    m_cmdEndRendering{ nullptr };
+    };
+}
+
+#endif //XK_VK_DYNAMIC_RENDERING_H
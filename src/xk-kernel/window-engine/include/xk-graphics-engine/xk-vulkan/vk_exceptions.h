@@ -16,10 +16,20 @@ namespace xk::graphics_engine::vulkan
     {
         using Parent = std::runtime_error;
 
-        explicit Exception(std::string_view message)
+        explicit Exception(std::string_view message, VkResult result = VK_SUCCESS)
             : Parent{ message.data() }
+            , m_result{ result }
         {}
 
+        /** Result of the failed call, VK_SUCCESS when the error did not come from one */
+        [[nodiscard]] inline VkResult result() const { return m_result; }
+
+        /** The device has to be recreated, every object created on it is gone */
+        [[nodiscard]] inline bool isDeviceLost() const { return m_result == VK_ERROR_DEVICE_LOST; }
+
+        /** The surface has to be recreated, e.g. after its monitor was unplugged */
+        [[nodiscard]] inline bool isSurfaceLost() const { return m_result == VK_ERROR_SURFACE_LOST_KHR; }
+
         static Exception PipelineError(std::string_view message)
         {
             return Exception{ std::string{"Pipeline error: "} + message.data() };
@@ -27,7 +37,7 @@ namespace xk::graphics_engine::vulkan
 
         static Exception InstanceError(const std::string& message, const VkResult result)
         {
-            return Exception{ "GpuWrapper error: " + message + " error code: { "+ getVulkanErrorName(result).data() + " }" };
+            return Exception{ "GpuWrapper error: " + message + " error code: { "+ getVulkanErrorName(result).data() + " }", result };
         }
 
         static Exception InstanceError(const std::string& message)
@@ -37,7 +47,7 @@ namespace xk::graphics_engine::vulkan
 
         static Exception GPUError(const std::string& message, const VkResult result)
         {
-            return Exception{ "GPU error: " + message + " error code: { " + getVulkanErrorName(result).data() + " }" };
+            return Exception{ "GPU error: " + message + " error code: { " + getVulkanErrorName(result).data() + " }", result };
         }
 
         static Exception GPUError(const std::string& message)
@@ -49,6 +59,29 @@ namespace xk::graphics_engine::vulkan
         {
             return Exception{ "Swap chain error: " + message };
         }
+
+        static Exception SwapChainError(const std::string& message, const VkResult result)
+        {
+            return Exception{ "Swap chain error: " + message + " error code: { " + getVulkanErrorName(result).data() + " }", result };
+        }
+
+        static Exception OutOfMemoryError(const std::string& message, const VkResult result)
+        {
+            return Exception{ "Out of memory: " + message + " error code: { " + getVulkanErrorName(result).data() + " }", result };
+        }
+
+        static Exception DescriptorError(const std::string& message)
+        {
+            return Exception{ "Descriptor heap error: " + message };
+        }
+
+        static Exception FrameGraphError(const std::string& message)
+        {
+            return Exception{ "Frame graph error: " + message };
+        }
+
+    private:
+        VkResult m_result{ VK_SUCCESS };
     };
 }
 
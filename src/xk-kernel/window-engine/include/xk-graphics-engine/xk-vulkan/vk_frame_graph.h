@@ -0,0 +1,265 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_FRAME_GRAPH_H
+#define XK_VK_FRAME_GRAPH_H
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <string_view>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/cast.h>
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_gpu_wrapper.h>
+#include <xk-graphics-engine/xk-vulkan/vk_frame_graph_plan.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    /** How a pass uses a texture, decides the layout, stages and access of the barrier in front of the pass */
+    enum class ResourceAccess : Enum_t
+    {
+        ColorAttachment,
+        DepthAttachment,
+        DepthRead,
+        SampledFragment,
+        SampledCompute,
+        StorageRead,
+        StorageWrite,
+        TransferSource,
+        TransferDestination
+    };
+
+    [[nodiscard]] bool isWriteAccess(ResourceAccess access);
+
+    struct FrameGraphTexture
+    {
+        VkExtent2D  extent{};
+        VkFormat    format{ VK_FORMAT_UNDEFINED };
+
+        bool operator==(const FrameGraphTexture& other) const
+        {
+            return extent.width == other.extent.width && extent.height == other.extent.height && format == other.format;
+        }
+    };
+
+    template<bool ValidationEnabled>
+    class FrameGraph
+    {
+        /** This class represents the passes of one frame and the textures flowing between them
+         *    passes declare what they read and write in a setup callback and record their commands in an
+         *    execute callback, compile() then
+         *      culls passes whose outputs are never read, walking back from imported textures and kept passes
+         *      places one batched vkCmdPipelineBarrier in front of each pass, only for layout changes,
+         *      read after write, write after write and write after read, reads of the same layout share it
+         *      creates transient textures and aliases them in memory, textures whose lifetimes do not overlap
+         *      share one allocation, the first use of a texture waits for the last use of the previous one
+         *      attachments used by a single pass get VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT and lazily
+         *      allocated memory instead, on tiled GPUs they never leave tile memory
+         *    passes run in declaration order, which is a valid order since a pass can only use textures
+         *    declared before it, they are recorded into a single command buffer
+         *    transient images live across frames and are only recreated when the set of transients or their
+         *    lifetimes change, frames in flight serialize on them through the barrier of their first use
+         *    the graph is rebuilt every frame, reset() clears it and keeps the transient images
+         */
+
+        using InstanceT = GpuWrapper<ValidationEnabled>;
+
+    public:
+        using ResourceId = u32;
+
+        static constexpr ResourceId InvalidResource{ std::numeric_limits<u32>::max() };
+
+        class PassBuilder
+        {
+        public:
+            /** Declares a transient texture, the pass still has to write it */
+            ResourceId create(std::string_view name, const FrameGraphTexture& texture);
+
+            void read(ResourceId resource, ResourceAccess access);
+
+            void write(ResourceId resource, ResourceAccess access);
+
+            /** The pass has effects outside of the graph and is never culled */
+            void keep();
+
+        private:
+            friend class FrameGraph;
+
+            PassBuilder(FrameGraph& graph, Index_t pass);
+
+            FrameGraph& m_graph;
+            Index_t     m_pass;
+        };
+
+        class Resources
+        {
+        public:
+            [[nodiscard]] VkImage image(ResourceId resource) const;
+
+            [[nodiscard]] VkImageView view(ResourceId resource) const;
+
+            [[nodiscard]] const FrameGraphTexture& texture(ResourceId resource) const;
+
+        private:
+            friend class FrameGraph;
+
+            explicit Resources(const FrameGraph& graph);
+
+            const FrameGraph& m_graph;
+        };
+
+        using Setup = std::function<void(PassBuilder&)>;
+        using Execute = std::function<void(const Resources&, VkCommandBuffer)>;
+
+        struct Statistics
+        {
+            Size_t  passes{ 0 };
+            Size_t  culledPasses{ 0 };
+            Size_t  barriers{ 0 };
+            Size_t  transientTextures{ 0 };
+            Size_t  transientAllocations{ 0 };
+            u64     transientBytes{ 0 };
+
+            //What the transients would take without aliasing
+            u64     unaliasedBytes{ 0 };
+        };
+
+        explicit FrameGraph(std::shared_ptr<InstanceT> gpuWrapper);
+
+        ~FrameGraph();
+
+        FrameGraph(const FrameGraph&) = delete;
+        FrameGraph& operator=(const FrameGraph&) = delete;
+
+        /** Makes an image owned elsewhere usable by passes, e.g. the swap image
+         *    imported textures are outputs of the graph, finalLayout is the layout they are left in */
+        ResourceId importImage(std::string_view name, VkImage image, VkImageView view, const FrameGraphTexture& texture, VkImageLayout initialLayout, VkImageLayout finalLayout);
+
+        void addPass(std::string_view name, const Setup& setup, Execute execute);
+
+        /** Culls, computes the barriers and provides the transient textures, throws FrameGraphError on misuse */
+        void compile();
+
+        /** Records the compiled passes with their barriers */
+        void execute(VkCommandBuffer commandBuffer) const;
+
+        /** Clears passes and textures for the next frame, the transient images are kept for reuse */
+        void reset();
+
+        [[nodiscard]] inline auto& statistics() const { return m_statistics; }
+
+    private:
+        struct Use
+        {
+            ResourceId      resource{ InvalidResource };
+            ResourceAccess  access{ ResourceAccess::SampledFragment };
+        };
+
+        struct Pass
+        {
+            std::string                         name{};
+            Execute                             execute{};
+            std::vector<Use>                    reads{};
+            std::vector<Use>                    writes{};
+            bool                                kept{ false };
+            bool                                culled{ false };
+
+            std::vector<VkImageMemoryBarrier>   barriers{};
+            VkPipelineStageFlags                srcStages{ 0 };
+            VkPipelineStageFlags                dstStages{ 0 };
+        };
+
+        struct Resource
+        {
+            std::string         name{};
+            FrameGraphTexture   texture{};
+            bool                imported{ false };
+            VkImage             image{ VK_NULL_HANDLE };
+            VkImageView         view{ VK_NULL_HANDLE };
+            VkImageLayout       initialLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+            VkImageLayout       finalLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+            VkImageUsageFlags   usage{ 0 };
+
+            //Execution order of the first and last pass using it, transients only
+            Index_t             firstUse{ Bad<Index_t>() };
+            Index_t             lastUse{ 0 };
+
+            //Transient memory block the image is bound to
+            Index_t             block{ Bad<Index_t>() };
+        };
+
+        //One allocation shared by transients with disjoint lifetimes
+        struct MemoryBlock
+        {
+            VkDeviceMemory          memory{ VK_NULL_HANDLE };
+            VkMemoryRequirements    requirements{};
+            std::vector<FrameGraphPlan::Lifetime> lifetimes{};
+
+            //Holds one attachment used by a single pass, in lazily allocated memory where the device offers it
+            bool                    lazy{ false };
+
+            //Last use of the previous occupant, also across frames, waited on by the first use of the next one
+            VkPipelineStageFlags    lastStages{ 0 };
+            VkAccessFlags           lastAccess{ 0 };
+        };
+
+        //Signature of a frame without transients, such a frame needs no device work for them
+        static constexpr u64 EmptySignature{ 14695981039346656037ull };
+
+        //Transient images reused while the frames keep the same transients with the same lifetimes
+        struct TransientCache
+        {
+            u64                         signature{ EmptySignature };
+            std::vector<VkImage>        images{};
+            std::vector<VkImageView>    views{};
+            std::vector<Index_t>        blocks{};
+            std::vector<MemoryBlock>    memory{};
+            u64                         unaliasedBytes{ 0 };
+        };
+
+        void cull();
+
+        void allocateTransients();
+
+        void retireTransients();
+
+        void computeBarriers(const std::vector<Index_t>& order);
+
+        /** A pass uses a texture once, one access decides its layout for the whole pass */
+        void checkUnused(const Pass& pass, ResourceId resource) const;
+
+        [[nodiscard]] Resource& resource(ResourceId id);
+
+        [[nodiscard]] const Resource& resource(ResourceId id) const;
+
+        std::shared_ptr<InstanceT>  m_gpuWrapper;
+
+        std::vector<Pass>           m_passes{};
+        std::vector<Resource>       m_resources{};
+
+        //Execution order of the passes that survived culling
+        std::vector<Index_t>        m_order{};
+
+        //Leaves the imported textures in their final layout after the last pass
+        std::vector<VkImageMemoryBarrier> m_finalBarriers{};
+        VkPipelineStageFlags        m_finalSrcStages{ 0 };
+
+        TransientCache              m_transients{};
+
+        Statistics                  m_statistics{};
+
+        bool                        m_compiled{ false };
+    };
+
+    extern template class FrameGraph<true>;
+    extern template class FrameGraph<false>;
+}
+
+#endif //XK_VK_FRAME_GRAPH_H
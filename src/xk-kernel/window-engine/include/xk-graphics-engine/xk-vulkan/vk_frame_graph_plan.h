@@ -0,0 +1,79 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_FRAME_GRAPH_PLAN_H
+#define XK_VK_FRAME_GRAPH_PLAN_H
+
+#include <span>
+#include <vector>
+#include <utility>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/cast.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    class FrameGraphPlan
+    {
+        /** This class represents the decisions of the FrameGraph that do not need a device
+         *    which passes are culled and which transients share an allocation, it never touches Vulkan itself,
+         *    the FrameGraph fills it from its passes, tests fill it by hand
+         */
+
+    public:
+        using Lifetime = std::pair<Index_t, Index_t>;
+
+        struct Pass
+        {
+            //Indices of the resources, a pass uses every resource at most once
+            std::vector<Index_t>    reads{};
+            std::vector<Index_t>    writes{};
+            bool                    kept{ false };
+        };
+
+        struct Resource
+        {
+            //Leaves the graph, whatever writes it is an output
+            bool                    imported{ false };
+        };
+
+        struct Transient
+        {
+            VkMemoryRequirements    requirements{};
+
+            //Execution order of the first and last pass using it
+            Lifetime                lifetime{};
+
+            //Lives in lazily allocated memory, which is never shared
+            bool                    lazy{ false };
+        };
+
+        struct Block
+        {
+            VkMemoryRequirements    requirements{};
+            std::vector<Lifetime>   lifetimes{};
+            bool                    lazy{ false };
+        };
+
+        struct Aliasing
+        {
+            std::vector<Block>      blocks{};
+
+            //Block of each transient, in the order they were passed
+            std::vector<Index_t>    blockOf{};
+        };
+
+        /** True for every pass whose outputs are never read, walking back from imported resources and kept passes */
+        [[nodiscard]] static std::vector<bool> cull(std::span<const Pass> passes, std::span<const Resource> resources);
+
+        /** Places transients with disjoint lifetimes into shared blocks, largest first so every block is sized
+         *    by its first occupant, all of them are bound at offset 0 */
+        [[nodiscard]] static Aliasing alias(std::span<const Transient> transients);
+
+        [[nodiscard]] static bool overlaps(Lifetime a, Lifetime b);
+    };
+}
+
+#endif //XK_VK_FRAME_GRAPH_PLAN_H
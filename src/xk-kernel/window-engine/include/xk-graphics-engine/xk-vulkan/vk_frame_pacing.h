@@ -0,0 +1,189 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_FRAME_PACING_H
+#define XK_VK_FRAME_PACING_H
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <optional>
+#include <string_view>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/config/vk_frames_in_flight.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    enum class FramePacingMode : Enum_t
+    {
+        //Newest frame shown as soon as possible, least queueing between input and present
+        LatencyFirst,
+        //GPU is never starved, frames may queue up behind the display
+        ThroughputFirst,
+        //Synchronized to the display and capped, the GPU idles between frames
+        PowerSaver
+    };
+
+    [[nodiscard]] std::string_view toString(FramePacingMode mode);
+
+    [[nodiscard]] std::string_view toString(VkPresentModeKHR presentMode);
+
+    struct FramePacingPolicy
+    {
+        //Set to latency, throughput or power, XK_FRAME_LIMIT overrides the frame cap in frames per second
+        static constexpr std::string_view EnvironmentVariable{ "XK_FRAME_PACING" };
+        static constexpr std::string_view FrameLimitVariable{ "XK_FRAME_LIMIT" };
+
+        //Upper bound of framesInFlight, per-frame rings may be sized by it
+        static constexpr u32 MaxFramesInFlight{ 3 };
+
+        FramePacingMode                 mode{ FramePacingMode::ThroughputFirst };
+
+        //In order of preference, FIFO is always supported and ends every list
+        std::vector<VkPresentModeKHR>   presentModes{};
+
+        //Frames the CPU may record ahead of the GPU
+        u32                             framesInFlight{ static_cast<u32>(FramesInFlight) };
+
+        //Swapchain images requested above the surface minimum
+        u32                             extraImages{ 1 };
+
+        //CPU side frame cap, 0 leaves the rate to the present mode
+        f64                             maxFramesPerSecond{ 0.0 };
+
+        //Delays the start of a frame until just before it is needed, see PresentTimer
+        bool                            waitForPresent{ false };
+
+        [[nodiscard]] static FramePacingPolicy forMode(FramePacingMode mode);
+
+        /** Policy requested through the environment, ThroughputFirst when nothing is set */
+        [[nodiscard]] static FramePacingPolicy fromEnvironment();
+
+        bool operator==(const FramePacingPolicy&) const = default;
+    };
+
+    class FrameLimiter
+    {
+        /** This class represents the CPU side frame cap
+         *    wait() sleeps until the next frame slot, most of the wait is a sleep and only the last
+         *    millisecond is spent yielding so the deadline is met without burning a core,
+         *    a frame that runs late resets the schedule instead of rendering a burst to catch up
+         */
+
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        void setRate(f64 framesPerSecond);
+
+        void wait();
+
+        [[nodiscard]] inline bool isEnabled() const { return m_interval.count() > 0; }
+
+    private:
+        Clock::duration     m_interval{ 0 };
+
+        Clock::time_point   m_nextFrame{};
+    };
+
+    class LatencyTracker
+    {
+        /** This class represents the input to present latency measurement
+         *    the first input before a frame starts is timestamped and latched by beginFrame(),
+         *    markPresent() of the same frame closes the sample, the end point is the completion of
+         *    the present when VK_KHR_present_wait is used and the return of vkQueuePresentKHR otherwise
+         *    only used from the thread that polls the window and presents
+         */
+
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Statistics
+        {
+            u64 samples{ 0 };
+            f64 minMilliseconds{ 0.0 };
+            f64 averageMilliseconds{ 0.0 };
+            f64 maxMilliseconds{ 0.0 };
+        };
+
+        void markInput(Clock::time_point time = Clock::now());
+
+        /** Hands the pending input to the frame about to be recorded */
+        void beginFrame(u64 frameNumber);
+
+        void markPresent(u64 frameNumber, Clock::time_point time = Clock::now());
+
+        [[nodiscard]] Statistics statistics() const;
+
+        void reset();
+
+    private:
+        std::optional<Clock::time_point>                m_pendingInput{};
+
+        //Frames are presented in order, so the oldest latched input is always at the front
+        std::deque<std::pair<u64, Clock::time_point>>   m_inputFrames{};
+
+        u64                                             m_samples{ 0 };
+
+        Clock::duration                                 m_total{ 0 };
+        Clock::duration                                 m_min{ Clock::duration::max() };
+        Clock::duration                                 m_max{ 0 };
+    };
+
+    class PresentTimer
+    {
+        /** This class represents the schedule of a just in time frame start
+         *    every frame reports when it started, when its GPU work finished and when it was presented,
+         *    the refresh interval is the shortest recent present to present time and the frame cost is
+         *    the start to GPU completion time, rising at once and decaying slowly so a single fast frame
+         *    does not make the next one late, nextFrameStart() is the last present plus one refresh
+         *    minus the cost and a safety margin, so the frame is recorded from the newest input and
+         *    finishes right before the display takes it
+         *    without present wait the presented time is the GPU completion time, an estimate that
+         *    ignores the wait for vertical blank
+         */
+
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        //Slack kept between the predicted end of a frame and the next refresh
+        static constexpr auto SafetyMargin = std::chrono::microseconds{ 1500 };
+
+        struct Statistics
+        {
+            u64 samples{ 0 };
+            f64 refreshMilliseconds{ 0.0 };
+            f64 averagePresentIntervalMilliseconds{ 0.0 };
+            f64 frameCostMilliseconds{ 0.0 };
+        };
+
+        void markPresented(Clock::time_point frameStart, Clock::time_point gpuDone, Clock::time_point presented);
+
+        /** Clock::time_point{} until enough frames were measured to predict the next refresh */
+        [[nodiscard]] Clock::time_point nextFrameStart() const;
+
+        [[nodiscard]] Statistics statistics() const;
+
+        void reset();
+
+    private:
+        //Long enough to contain a frame that hit the refresh, short enough to follow a refresh rate change
+        static constexpr Size_t IntervalHistory{ 32 };
+
+        std::array<Clock::duration, IntervalHistory>    m_intervals{};
+
+        std::optional<Clock::time_point>                m_lastPresented{};
+
+        Clock::duration                                 m_frameCost{ 0 };
+        Clock::duration                                 m_intervalTotal{ 0 };
+
+        u64                                             m_samples{ 0 };
+    };
+}
+
+#endif //XK_VK_FRAME_PACING_H
@@ -0,0 +1,165 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_FRAME_STATISTICS_H
+#define XK_VK_FRAME_STATISTICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string_view>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    enum class FrameMetric : Enum_t
+    {
+        //Present to present, what the user sees as the frame time
+        Frame,
+        //The frame time without the waits below, recording and everything the application does in between
+        Cpu,
+        //Frame zone of the GpuProfiler, 0 without timestamp support
+        Gpu,
+        //Waiting for the fence of the frame slot and in vkAcquireNextImageKHR
+        AcquireWait,
+        //Waiting for the previous present and in vkQueuePresentKHR
+        PresentWait,
+        //Sleeping in the FrameLimiter and until the just in time frame start
+        Idle
+    };
+
+    static constexpr Size_t FrameMetricCount{ 6 };
+
+    [[nodiscard]] std::string_view toString(FrameMetric metric);
+
+    struct FrameTiming
+    {
+        using Clock = std::chrono::steady_clock;
+
+        u64                                 frameNumber{ 0 };
+
+        std::array<f32, FrameMetricCount>   milliseconds{};
+
+        [[nodiscard]] inline f32& operator[](FrameMetric metric) { return milliseconds[static_cast<Size_t>(metric)]; }
+
+        [[nodiscard]] inline f32 operator[](FrameMetric metric) const { return milliseconds[static_cast<Size_t>(metric)]; }
+
+        inline void add(FrameMetric metric, Clock::duration duration)
+        {
+            (*this)[metric] += std::chrono::duration<f32, std::milli>{ duration }.count();
+        }
+    };
+
+    class FrameStatistics
+    {
+        /** This class represents the frame timings of one swapchain, recorded by the presenting thread and
+         *    read from any thread, e.g. to ship hitches to telemetry
+         *    the ring buffer is lock-free, every slot carries a sequence number that is odd while the slot
+         *    is written, a reader copies the slot and keeps the copy only when the number is even and unchanged,
+         *    so the frame loop never waits for a reader and a reader drops the samples overwritten while it read
+         *    summaries sort a copy of their window on the calling thread, the frame loop only pays for record()
+         */
+
+    public:
+        //Power of two, holds the long window with room for readers lagging behind
+        static constexpr Size_t Capacity{ 2048 };
+
+        //About two seconds and half a minute at 60 Hz
+        static constexpr Size_t ShortWindow{ 120 };
+        static constexpr Size_t LongWindow{ 1800 };
+
+        //A frame taking longer than this times the median frame of its window counts as a hitch
+        static constexpr f32 HitchFactor{ 2.0f };
+
+        struct Percentiles
+        {
+            f32 p50{ 0.0f };
+            f32 p95{ 0.0f };
+            f32 p99{ 0.0f };
+            f32 max{ 0.0f };
+        };
+
+        struct Summary
+        {
+            Size_t                                  samples{ 0 };
+
+            Size_t                                  hitches{ 0 };
+
+            std::array<Percentiles, FrameMetricCount> metrics{};
+
+            [[nodiscard]] inline auto& operator[](FrameMetric metric) const { return metrics[static_cast<Size_t>(metric)]; }
+        };
+
+        /** Only called by the presenting thread */
+        void record(const FrameTiming& timing);
+
+        /** Up to count of the most recent timings, oldest first */
+        [[nodiscard]] std::vector<FrameTiming> latest(Size_t count) const;
+
+        /** Percentiles over the window most recent frames */
+        [[nodiscard]] Summary summary(Size_t window = ShortWindow) const;
+
+        /** Frames recorded since the swapchain was created */
+        [[nodiscard]] inline u64 recorded() const { return m_written.load(std::memory_order_acquire); }
+
+    private:
+        struct Slot
+        {
+            std::atomic<u64>                            sequence{ 0 };
+            std::atomic<u64>                            frameNumber{ 0 };
+            std::array<std::atomic<f32>, FrameMetricCount> milliseconds{};
+        };
+
+        std::array<Slot, Capacity>  m_slots{};
+
+        std::atomic<u64>            m_written{ 0 };
+    };
+
+    class FrameStatisticsOverlay
+    {
+        /** This class represents the frame time overlay drawn by the engine into the swap image
+         *    it is recorded with vkCmdClearAttachments inside the rendering of the swap image, so it needs
+         *    no pipeline, shader or font and works on the render pass and the dynamic rendering path
+         *    the left graph shows the frame time of the short window, one bar per frame, green, yellow above
+         *    p95 and red for hitches, the right one the histogram of the long window in 1 ms buckets
+         *    with markers at p50, p95 and p99, both are scaled to MaxMilliseconds
+         *    summaries are refreshed every RefreshInterval frames, the bars every frame
+         */
+
+    public:
+        //Set to show the overlay on the main window
+        static constexpr std::string_view EnvironmentVariable{ "XK_FRAME_OVERLAY" };
+
+        static constexpr f32 MaxMilliseconds{ 50.0f };
+
+        static constexpr u32 RefreshInterval{ 30 };
+
+        [[nodiscard]] static bool isRequested();
+
+        /** Pixels covered by the overlay, to be added to the damage of the frame */
+        [[nodiscard]] static VkRect2D area(VkExtent2D extent);
+
+        /** Records the overlay into color attachment 0 of the current rendering */
+        void record(VkCommandBuffer commandBuffer, VkExtent2D extent, const FrameStatistics& statistics);
+
+    private:
+        void clear(VkCommandBuffer commandBuffer, const std::vector<VkClearRect>& rects, VkClearColorValue color) const;
+
+        FrameStatistics::Summary    m_shortSummary{};
+        FrameStatistics::Summary    m_longSummary{};
+
+        std::vector<Size_t>         m_histogram{};
+
+        u32                         m_framesUntilRefresh{ 0 };
+
+        //Reused between frames, one list per color
+        std::vector<VkClearRect>    m_background{}, m_good{}, m_slow{}, m_hitch{}, m_markers{};
+    };
+}
+
+#endif //XK_VK_FRAME_STATISTICS_H
@@ -0,0 +1,122 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_GPU_PROFILER_H
+#define XK_VK_GPU_PROFILER_H
+
+#include <string>
+#include <vector>
+#include <string_view>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    class GpuProfiler
+    {
+        /** This class represents a GPU timeline profiler built on timestamp queries
+         *    every frame slot owns a range of the query pool, zones write a timestamp pair into
+         *    the command buffer and results are read back when the slot is reused, i.e. after
+         *    its fence was waited on, so reading never stalls the CPU
+         */
+
+    public:
+        static constexpr u32 MaxZonesPerFrame{ 256 };
+
+        using ZoneId = u32;
+
+        static constexpr ZoneId InvalidZone{ ~u32{ 0 } };
+
+        struct ZoneResult
+        {
+            std::string name{};
+            u32         depth{ 0 };
+            f64         startUs{ 0.0 };
+            f64         durationUs{ 0.0 };
+        };
+
+        /** RAII zone recorded into a command buffer */
+        class ScopedZone
+        {
+        public:
+            ScopedZone(GpuProfiler& profiler, VkCommandBuffer commandBuffer, std::string_view name);
+
+            ~ScopedZone();
+
+            ScopedZone(const ScopedZone&) = delete;
+            ScopedZone& operator=(const ScopedZone&) = delete;
+
+        private:
+            GpuProfiler&    m_profiler;
+            VkCommandBuffer m_commandBuffer;
+            ZoneId          m_zone;
+        };
+
+        GpuProfiler(VkPhysicalDevice gpu, VkDevice device, u32 queueFamilyIndex, Size_t framesInFlight);
+
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        [[nodiscard]] inline bool isSupported() const { return m_queryPool != VK_NULL_HANDLE; }
+
+        /** Collects the results of the previous use of frameSlot and resets its queries
+         *    must be recorded outside of a render pass, before any zone of the frame */
+        void beginFrame(VkCommandBuffer commandBuffer, Index_t frameSlot);
+
+        [[nodiscard]] ZoneId beginZone(VkCommandBuffer commandBuffer, std::string_view name);
+
+        void endZone(VkCommandBuffer commandBuffer, ZoneId zone);
+
+        /** Zones of the most recently resolved frame */
+        [[nodiscard]] inline auto& lastResults() const { return m_lastResults; }
+
+        /** GPU duration of the most recently resolved frame in milliseconds */
+        [[nodiscard]] inline auto lastFrameTimeMs() const { return m_lastFrameTimeMs; }
+
+    private:
+        struct Zone
+        {
+            std::string name{};
+            u32         depth{ 0 };
+            u32         beginQuery{ 0 };
+            u32         endQuery{ 0 };
+        };
+
+        struct FrameData
+        {
+            std::vector<Zone>   zones{};
+            u32                 usedQueries{ 0 };
+            u32                 openZones{ 0 };
+            f64                 cpuStartUs{ 0.0 };
+            bool                hasResults{ false };
+        };
+
+        void resolve(FrameData& frame);
+
+        [[nodiscard]] inline u32 queryBase(Index_t frameSlot) const { return frameSlot * MaxZonesPerFrame * 2; }
+
+        VkDevice                m_device{ VK_NULL_HANDLE };
+
+        VkQueryPool             m_queryPool{ VK_NULL_HANDLE };
+
+        //Nanoseconds per timestamp tick, m_gpuProperties.limits.timestampPeriod
+        f64                     m_timestampPeriod{ 1.0 };
+
+        u64                     m_timestampMask{ ~u64{ 0 } };
+
+        std::vector<FrameData>  m_frames{};
+
+        Index_t                 m_currentFrame{ 0 };
+
+        std::vector<ZoneResult> m_lastResults{};
+
+        f64                     m_lastFrameTimeMs{ 0.0 };
+    };
+}
+
+#endif //XK_VK_GPU_PROFILER_H
@@ -0,0 +1,85 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_GPU_SELECTOR_H
+#define XK_VK_GPU_SELECTOR_H
+
+#include <span>
+#include <array>
+#include <string>
+#include <vector>
+#include <optional>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    /** Everything the selector knows about a physical device
+     *    filled from Vulkan queries in GpuWrapper::pickGpu, or by hand in tests */
+    struct GpuCandidate
+    {
+        VkPhysicalDevice                        handle{ VK_NULL_HANDLE };
+        VkPhysicalDeviceProperties              properties{};
+        VkPhysicalDeviceMemoryProperties        memoryProperties{};
+        VkPhysicalDeviceFeatures                features{};
+        std::vector<VkQueueFamilyProperties>    queueFamilies{};
+        std::array<u8, VK_UUID_SIZE>            uuid{};
+
+        //Result of the hard requirements check (queues, extensions, swap chain, descriptor indexing)
+        bool                                    isSuitable{ false };
+    };
+
+    struct RankedGpu
+    {
+        Index_t             candidate{ 0 };
+        s64                 score{ 0 };
+        std::string         name{};
+        std::string_view    type{};
+        std::string         uuid{};
+        bool                isSuitable{ false };
+    };
+
+    /** User preference, matches a case-insensitive substring of the device name or the full UUID */
+    struct GpuPreference
+    {
+        //Environment variable overriding the configured preference
+        static constexpr std::string_view EnvironmentVariable{ "XK_GPU" };
+
+        std::string nameOrUuid{};
+
+        [[nodiscard]] inline bool isEmpty() const { return nameOrUuid.empty(); }
+
+        /** Configured preference unless XK_GPU is set in the environment */
+        [[nodiscard]] static GpuPreference resolve(const GpuPreference& configured);
+    };
+
+    class GpuSelector
+    {
+        /** This class scores physical devices and picks the best one
+         *    device type dominates the score, VRAM, limits, optional features and queue topology
+         *    break ties between devices of the same type, it never touches Vulkan itself
+         */
+
+    public:
+        [[nodiscard]] static s64 score(const GpuCandidate& candidate);
+
+        /** Candidates ordered from the best to the worst, unsuitable devices last */
+        [[nodiscard]] static std::vector<RankedGpu> rank(std::span<const GpuCandidate> candidates);
+
+        /** Index of the chosen candidate, the preference wins when it matches a suitable device */
+        [[nodiscard]] static std::optional<Index_t> select(std::span<const GpuCandidate> candidates, const GpuPreference& preference = {});
+
+        [[nodiscard]] static std::string formatUuid(const std::array<u8, VK_UUID_SIZE>& uuid);
+
+        [[nodiscard]] static u64 deviceLocalMemory(const VkPhysicalDeviceMemoryProperties& memoryProperties);
+
+        [[nodiscard]] static bool matches(const GpuCandidate& candidate, const GpuPreference& preference);
+
+        static void logReport(std::span<const RankedGpu> ranking);
+    };
+}
+
+#endif //XK_VK_GPU_SELECTOR_H
@@ -8,11 +8,20 @@
 #include <memory>
 #include <vector>
 #include <optional>
+#include <string_view>
 
 #include <vulkan/vulkan.hpp>
 
 #include <utility/literal.h>
 
+#include <xk-graphics-engine/xk-vulkan/vk_deletion_queue.h>
+#include <xk-graphics-engine/xk-vulkan/vk_descriptor_heap.h>
+#include <xk-graphics-engine/xk-vulkan/vk_dynamic_rendering.h>
+#include <xk-graphics-engine/xk-vulkan/vk_gpu_selector.h>
+#include <xk-graphics-engine/xk-vulkan/vk_memory_budget.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_cache.h>
+#include <xk-graphics-engine/xk-vulkan/vk_present_wait.h>
+
 namespace xk::graphics_engine::vulkan
 {
    template<bool ValidationLayersEnabled> class Core;
@@ -52,14 +61,16 @@ namespace xk::graphics_engine::vulkan
 
         static constexpr auto EmptyGenericValue = VK_NULL_HANDLE;
 
-        [[nodiscard]] auto findMemoryType(u32 typeFilter, VkMemoryPropertyFlagBits properties) const -> u32;
+        [[nodiscard]] auto findMemoryType(u32 typeFilter, VkMemoryPropertyFlags properties) const -> u32;
+
+        [[nodiscard]] auto hasMemoryType(u32 typeFilter, VkMemoryPropertyFlags properties) const -> bool;
 
         [[nodiscard]] auto findQueueFamilies(const VkPhysicalDevice& gpu, VkQueueFlags operationsToBeSupported) const -> QueueFamilyIndices;
 
         // helper functions
         [[nodiscard]] auto areDeviceExtensionsSupported(const VkPhysicalDevice& gpu, const std::vector<const char*>& deviceExtensions) const -> bool;
 
-        [[nodiscard]] auto querySwapChainSupport(const VkPhysicalDevice& gpu) const -> SwapChainSupportDetails;
+        [[nodiscard]] auto querySwapChainSupport(const VkPhysicalDevice& gpu, VkSurfaceKHR surface) const -> SwapChainSupportDetails;
 
         [[nodiscard]] auto areGlfwExtensionsSupported(const std::vector<const char*>& glfwExtensions) const -> bool;
 
@@ -71,20 +82,6 @@ namespace xk::graphics_engine::vulkan
 
         [[nodiscard]] std::vector<const char*> requiredGlfwExtensions() const;
 
-        auto findSupportedFormat(const std::vector<VkFormat>& formats, VkImageTiling tiling, VkFormatFeatureFlags features) -> VkFormat;
-
-        auto createVertexBuffer(u64 size, VkBufferUsageFlags usage, VkMemoryPropertyFlagBits properties) -> std::tuple<VkBuffer, VkDeviceMemory>;
-
-        auto beginSingleTimeCommands() -> VkCommandBuffer;
-
-        auto endSingleTimeCommands(VkCommandBuffer* commandBuffer) -> void;
-
-        auto copyBuffer(const VkBuffer& src, VkBuffer* dst, u64 size) -> void;
-
-        auto copyBufferToImage(const VkBuffer& src, VkImage* image, u32 width, u32 height, u32 layerCount) -> void;
-
-        auto createImageWithInfo(const VkImageCreateInfo& info, VkMemoryPropertyFlagBits properties) -> std::tuple<VkImage, VkDeviceMemory>;
-
         void cleanUp();
 
         //Setup stages
@@ -98,8 +95,14 @@ namespace xk::graphics_engine::vulkan
 
         void createLogicalDevice();
 
+        void createMemoryBudget();
+
         void createCommandPool();
 
+        void createDescriptorHeap();
+
+        void createPipelineCache();
+
     public:
         explicit GpuWrapper();
 
@@ -109,19 +112,99 @@ namespace xk::graphics_engine::vulkan
 
         void setupForWindow(std::weak_ptr<ParentWindow> parent);
 
+        /** Sets up without a window and surface, swapchain support is not required from the GPU
+         *    rendering goes into OffscreenTargets, used for CI runs on lavapipe and server side rendering */
+        void setupHeadless();
+
+        [[nodiscard]] inline bool isHeadless() const { return m_headless; }
+
+        /** Preferred GPU by name or UUID, must be set before setup, XK_GPU in the environment takes precedence */
+        inline void setGpuPreference(GpuPreference preference) { m_gpuPreference = std::move(preference); }
+
+        auto findSupportedFormat(const std::vector<VkFormat>& formats, VkImageTiling tiling, VkFormatFeatureFlags features) -> VkFormat;
+
+        auto createVertexBuffer(u64 size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) -> std::tuple<VkBuffer, VkDeviceMemory>;
+
+        auto beginSingleTimeCommands() -> VkCommandBuffer;
+
+        auto endSingleTimeCommands(VkCommandBuffer* commandBuffer) -> void;
+
+        auto copyBuffer(const VkBuffer& src, VkBuffer* dst, u64 size) -> void;
+
+        auto copyBufferToImage(const VkBuffer& src, VkImage* image, u32 width, u32 height, u32 layerCount) -> void;
+
+        auto createImageWithInfo(const VkImageCreateInfo& info, VkMemoryPropertyFlags properties, MemoryCategory category = MemoryCategory::Texture) -> std::tuple<VkImage, VkDeviceMemory>;
+
+        /** Creates an attachment whose contents never leave the render pass, e.g. a depth buffer that is cleared
+         *    and not stored, with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT and lazily allocated memory where the
+         *    device offers it, on tiled GPUs such an attachment then only lives in tile memory
+         *    info.usage may only hold attachment usages */
+        auto createTransientAttachment(VkImageCreateInfo info, MemoryCategory category) -> std::tuple<VkImage, VkDeviceMemory>;
+
+        /** Lazily allocated device local memory when a type in typeFilter offers it, plain device local otherwise */
+        [[nodiscard]] auto transientMemoryProperties(u32 typeFilter) const -> VkMemoryPropertyFlags;
+
+        /** Allocates device memory within budget, on pressure asks eviction callbacks for memory,
+         *    collects the deletion queue and retries
+         *    throws Exception::OutOfMemoryError only once eviction could not release anything */
+        auto allocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, MemoryCategory category) -> VkDeviceMemory;
+
+        /** Frees memory right away, the caller guarantees no frame in flight uses it */
+        void freeMemory(VkDeviceMemory memory);
+
+        /** Frees memory once the frames that may reference it are finished */
+        void releaseMemory(VkDeviceMemory memory);
+
+        [[nodiscard]] bool isDeviceExtensionEnabled(std::string_view extension) const;
+
+        /** True when VK_EXT_swapchain_colorspace is enabled, without it surfaces only offer sRGB color spaces */
+        [[nodiscard]] inline bool hasSwapChainColorSpaces() const { return m_swapChainColorSpaces; }
+
         [[nodiscard]] inline auto& getCommandPool() const { return m_commandPool; }
 
         [[nodiscard]] inline auto& getLogicalDevice() const { return m_logicalDevice; }
 
+        [[nodiscard]] inline auto& getVulkanInstance() const { return m_instance; }
+
         [[nodiscard]] inline auto& getSurface() const { return m_surface; }
 
         [[nodiscard]] inline auto& getGraphicsQueue() const { return m_graphicsQueue; }
 
         [[nodiscard]] inline auto& getPresentQueue() const{ return m_presentQueue; }
 
-        [[nodiscard]] inline auto getSwapChainSupport() const { return querySwapChainSupport(m_gpu); }
+        [[nodiscard]] inline auto getSwapChainSupport() const { return querySwapChainSupport(m_gpu, m_surface); }
+
+        /** Capabilities, formats and present modes of the selected GPU for a surface of any window */
+        [[nodiscard]] inline auto getSwapChainSupport(VkSurfaceKHR surface) const { return querySwapChainSupport(m_gpu, surface); }
+
+        /** True when the present queue can present to surface, the device was picked for the main window surface only */
+        [[nodiscard]] bool isPresentSupported(VkSurfaceKHR surface) const;
+
+        /** For surfaces of additional windows, the surface of the main window is owned and destroyed here */
+        void destroySurface(VkSurfaceKHR surface);
+
+        /** Replaces the lost surface of the main window, nothing may be built on the old one anymore */
+        VkSurfaceKHR recreateSurface();
+
+        [[nodiscard]] inline auto findPhysicalQueueFamilies() const { return findQueueFamilies(m_gpu, VK_QUEUE_GRAPHICS_BIT); }
+
+        [[nodiscard]] inline auto& getGpu() const { return m_gpu; }
+
+        [[nodiscard]] inline auto& getGpuProperties() const { return m_gpuProperties; }
 
-        [[nodiscard]] inline auto findPhysicalQueueFamilies() const { return findQueueFamilies(m_gpu); }
+        [[nodiscard]] inline auto& getDeletionQueue() { return m_deletionQueue; }
+
+        [[nodiscard]] inline auto& getDescriptorHeap() const { return *m_descriptorHeap; }
+
+        [[nodiscard]] inline auto& getMemoryBudget() const { return *m_memoryBudget; }
+
+        [[nodiscard]] inline auto& getPipelineCache() const { return *m_pipelineCache; }
+
+        /** nullptr when the device renders through VkRenderPass, see DynamicRendering */
+        [[nodiscard]] inline const DynamicRendering* getDynamicRendering() const { return m_dynamicRendering.get(); }
+
+        /** nullptr when presents are estimated from fences, see PresentWait */
+        [[nodiscard]] inline const PresentWait* getPresentWait() const { return m_presentWait.get(); }
 
     private:
         //VkInstance is a gateway to all the Vulkan functions
@@ -136,6 +219,9 @@ namespace xk::graphics_engine::vulkan
         //Holds all the information about gpu
         VkPhysicalDeviceProperties      m_gpuProperties{ };
 
+        //Configured device override used by pickGpu
+        GpuPreference                   m_gpuPreference{ };
+
         //Interface to gpu
         VkDevice                        m_logicalDevice{ EmptyGenericValue };
 
@@ -150,6 +236,33 @@ namespace xk::graphics_engine::vulkan
 
         //Shared pointer to GLFW type window that we are presenting on
         std::weak_ptr<ParentWindow>     m_window{};
+
+        //Handles retired by their owners, released once the frames referencing them are finished
+        DeletionQueue                   m_deletionQueue{};
+
+        //Device extensions enabled at device creation, required and the supported optional ones
+        std::vector<std::string_view>   m_enabledDeviceExtensions{};
+
+        //Per heap and per category accounting of device memory
+        std::unique_ptr<MemoryBudget>   m_memoryBudget{};
+
+        //Global bindless descriptor set and the pipeline layout shared by every pipeline
+        std::unique_ptr<DescriptorHeap> m_descriptorHeap{};
+
+        //Driver pipeline cache persisted between runs, saved on shutdown
+        std::unique_ptr<PipelineCache>  m_pipelineCache{};
+
+        //Set up without a surface, present queue and swapchain extension are not used
+        bool                            m_headless{ false };
+
+        //VK_EXT_swapchain_colorspace is enabled on the instance, HDR and extended color spaces can be presented
+        bool                            m_swapChainColorSpaces{ false };
+
+        //Entry points of VK_KHR_dynamic_rendering, only created when the device supports it
+        std::unique_ptr<DynamicRendering> m_dynamicRendering{};
+
+        //Entry point of VK_KHR_present_wait, only created when the device supports it and presents
+        std::unique_ptr<PresentWait>    m_presentWait{};
     };
 
     extern template class GpuWrapper<true>;
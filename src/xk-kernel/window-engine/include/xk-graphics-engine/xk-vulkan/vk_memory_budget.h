@@ -0,0 +1,155 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_MEMORY_BUDGET_H
+#define XK_VK_MEMORY_BUDGET_H
+
+#include <map>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    enum class MemoryCategory : Enum_t
+    {
+        Texture,
+        Buffer,
+        SwapChain,
+        Transient,
+        Other,
+
+        Count
+    };
+
+    inline constexpr std::string_view toString(MemoryCategory category)
+    {
+        switch (category)
+        {
+            case MemoryCategory::Texture:
+            {
+                return "textures";
+            }
+            case MemoryCategory::Buffer:
+            {
+                return "buffers";
+            }
+            case MemoryCategory::SwapChain:
+            {
+                return "swap chain";
+            }
+            case MemoryCategory::Transient:
+            {
+                return "transient attachments";
+            }
+            default:
+            {
+                return "other";
+            }
+        }
+    }
+
+    struct HeapBudget
+    {
+        //Bytes the process may use on this heap before the driver starts paging or failing
+        u64     budget{ 0 };
+
+        //Bytes in use as reported by VK_EXT_memory_budget, equals tracked without the extension
+        u64     usage{ 0 };
+
+        //Bytes allocated through GpuWrapper
+        u64     tracked{ 0 };
+
+        bool    isDeviceLocal{ false };
+    };
+
+    class MemoryBudget
+    {
+        /** This class tracks device memory per heap and per category
+         *    with VK_EXT_memory_budget the driver reports budget and usage of the whole process,
+         *    without it the budget is a fixed share of the heap size and usage is our own accounting
+         *    eviction callbacks let caches give memory back before an allocation is retried
+         */
+
+    public:
+        //Share of a heap we allow ourselves when the driver cannot tell us the real budget
+        static constexpr f64 FallbackBudgetRatio{ 0.8 };
+
+        /** Returns the number of bytes released, 0 when the callback has nothing to give back
+         *    the memory has to be freed before returning since the allocation is retried right away,
+         *    so only memory no frame in flight uses can be evicted */
+        using EvictionCallback = std::function<u64(u32 heapIndex, u64 bytesNeeded)>;
+
+        using CallbackId = u32;
+
+        MemoryBudget(VkPhysicalDevice gpu, bool isBudgetExtensionEnabled);
+
+        void onAllocate(VkDeviceMemory memory, u32 memoryTypeIndex, u64 size, MemoryCategory category);
+
+        void onFree(VkDeviceMemory memory);
+
+        [[nodiscard]] std::vector<HeapBudget> queryHeaps() const;
+
+        [[nodiscard]] u32 heapIndex(u32 memoryTypeIndex) const;
+
+        /** Heap memory was allocated from, Bad<u32>() for memory that is not tracked */
+        [[nodiscard]] u32 heapOf(VkDeviceMemory memory) const;
+
+        /** True when allocating size bytes from the type's heap would exceed its budget */
+        [[nodiscard]] bool wouldExceedBudget(u32 memoryTypeIndex, u64 size) const;
+
+        [[nodiscard]] u64 categoryUsage(MemoryCategory category) const;
+
+        [[nodiscard]] inline bool isBudgetExtensionEnabled() const { return m_isBudgetExtensionEnabled; }
+
+        CallbackId addEvictionCallback(EvictionCallback callback);
+
+        void removeEvictionCallback(CallbackId id);
+
+        /** Asks the registered callbacks to release memory of heapIndex until bytesNeeded is freed
+         *    the callbacks are called on a copy taken under the lock, one removed while an eviction
+         *    is running on another thread may still be called by that eviction */
+        u64 evict(u32 heapIndex, u64 bytesNeeded);
+
+        void logReport() const;
+
+    private:
+        struct Allocation
+        {
+            u32             heapIndex{ 0 };
+            u64             size{ 0 };
+            MemoryCategory  category{ MemoryCategory::Other };
+        };
+
+        VkPhysicalDevice                                    m_gpu{ VK_NULL_HANDLE };
+
+        VkPhysicalDeviceMemoryProperties                    m_memoryProperties{};
+
+        bool                                                m_isBudgetExtensionEnabled{ false };
+
+        mutable std::mutex                                  m_mutex;
+
+        std::unordered_map<VkDeviceMemory, Allocation>      m_allocations{};
+
+        std::array<u64, VK_MAX_MEMORY_HEAPS>                m_heapUsage{};
+
+        std::array<u64, static_cast<Size_t>(MemoryCategory::Count)> m_categoryUsage{};
+
+        std::mutex                                          m_callbackMutex;
+
+        std::map<CallbackId, EvictionCallback>              m_evictionCallbacks{};
+
+        CallbackId                                          m_nextCallbackId{ 0 };
+    };
+}
+
+#endif //XK_VK_MEMORY_BUDGET_H
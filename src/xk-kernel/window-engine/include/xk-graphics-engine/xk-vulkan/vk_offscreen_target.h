@@ -0,0 +1,127 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_OFFSCREEN_TARGET_H
+#define XK_VK_OFFSCREEN_TARGET_H
+
+#include <memory>
+#include <vector>
+#include <functional>
+#include <filesystem>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_gpu_wrapper.h>
+#include <xk-graphics-engine/xk-vulkan/vk_dynamic_rendering.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_config_info.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    /** Frame read back into CPU memory, tightly packed 8 bit RGBA rows */
+    struct ReadbackImage
+    {
+        u32             width{ 0 };
+        u32             height{ 0 };
+        std::vector<u8> pixels{};
+
+        /** Throws std::system_error when the file cannot be written */
+        void savePng(const std::filesystem::path& path) const;
+
+        /** Writes the pixels without any header, for byte exact comparisons */
+        void saveRaw(const std::filesystem::path& path) const;
+    };
+
+    template<bool ValidationEnabled>
+    class OffscreenTarget
+    {
+        /** This class represents a render target that is never presented
+         *    it owns a color and a depth image of a fixed size and a host visible buffer the color
+         *    image is copied into, so a frame can be rendered and read back without any window,
+         *    used for golden image tests, benchmarks on lavapipe in CI and server side thumbnails
+         *    it renders through dynamic rendering when available and through its own render pass otherwise,
+         *    the interface mirrors the SwapChain one so the same recording code drives both
+         */
+
+        using InstanceT = GpuWrapper<ValidationEnabled>;
+
+    public:
+        //Matches the byte order of ReadbackImage, so the readback needs no swizzle
+        static constexpr VkFormat ColorFormat{ VK_FORMAT_R8G8B8A8_UNORM };
+
+        OffscreenTarget(std::weak_ptr<InstanceT> gpuWrapper, VkExtent2D extent);
+
+        ~OffscreenTarget();
+
+        OffscreenTarget(const OffscreenTarget&) = delete;
+        OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+        void beginRendering(VkCommandBuffer commandBuffer, VkClearColorValue clearColor) const;
+
+        /** Ends rendering and copies the color image into the readback buffer
+         *    the buffer is kept from eviction until readback copied the frame out */
+        void endRendering(VkCommandBuffer commandBuffer);
+
+        /** Fills the render pass or the attachment formats, whichever the active rendering path needs */
+        void configurePipeline(PipelineConfigInfo& config) const;
+
+        /** Records one frame with the given callback, waits for it and reads it back
+         *    blocks on the queue, meant for tools and tests, not for an interactive frame loop
+         *    every call also collects the deletion queue, which a headless setup would otherwise never do */
+        ReadbackImage render(const std::function<void(VkCommandBuffer)>& record, VkClearColorValue clearColor = {});
+
+        /** Copies the readback buffer, the frame recorded with endRendering has to be finished */
+        [[nodiscard]] ReadbackImage readback();
+
+        [[nodiscard]] inline auto extent() const { return m_extent; }
+
+        [[nodiscard]] inline bool usesDynamicRendering() const { return m_dynamicRendering != nullptr; }
+
+    private:
+        void createImages();
+
+        void createRenderPass();
+
+        void createReadbackBuffer();
+
+        /** Eviction callback, frees the readback buffer unless a frame still waits in it, endRendering creates it again */
+        u64 evictReadbackBuffer(u32 heapIndex);
+
+        [[nodiscard]] inline u64 readbackSize() const { return u64{ m_extent.width } * m_extent.height * 4; }
+
+        std::weak_ptr<InstanceT>    m_gpuWrapper;
+
+        const DynamicRendering*     m_dynamicRendering{ nullptr };
+
+        VkExtent2D                  m_extent{};
+
+        VkFormat                    m_depthFormat{ VK_FORMAT_UNDEFINED };
+
+        VkImage                     m_colorImage{ VK_NULL_HANDLE };
+        VkDeviceMemory              m_colorMemory{ VK_NULL_HANDLE };
+        VkImageView                 m_colorView{ VK_NULL_HANDLE };
+
+        VkImage                     m_depthImage{ VK_NULL_HANDLE };
+        VkDeviceMemory              m_depthMemory{ VK_NULL_HANDLE };
+        VkImageView                 m_depthView{ VK_NULL_HANDLE };
+
+        //Only created on the render pass path
+        VkRenderPass                m_renderPass{ VK_NULL_HANDLE };
+        VkFramebuffer               m_framebuffer{ VK_NULL_HANDLE };
+
+        VkBuffer                    m_readbackBuffer{ VK_NULL_HANDLE };
+        VkDeviceMemory              m_readbackMemory{ VK_NULL_HANDLE };
+
+        //Set by endRendering until readback, the GPU may still write the buffer or its frame was not read yet
+        bool                        m_readbackPending{ false };
+
+        MemoryBudget::CallbackId    m_evictionCallback{};
+    };
+
+    extern template class OffscreenTarget<true>;
+    extern template class OffscreenTarget<false>;
+}
+
+#endif //XK_VK_OFFSCREEN_TARGET_H
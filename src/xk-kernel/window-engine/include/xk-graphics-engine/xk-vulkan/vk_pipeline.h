@@ -5,13 +5,15 @@
 #ifndef XK_VK_PIPELINE_H
 #define XK_VK_PIPELINE_H
 
-#include <vector>
-#include <string>
 #include <memory>
+#include <functional>
 
 #include <utility/literal.h>
 
 #include "vk_gpu_wrapper.h"
+#include "vk_pipeline_compiler.h"
+#include "vk_pipeline_state_cache.h"
+#include "vk_shader_registry.h"
 
 namespace xk::graphics_engine::vulkan
 {
@@ -20,31 +22,33 @@ namespace xk::graphics_engine::vulkan
     {
         using InstanceT = GpuWrapper<ValidationEnabled>;
 
-        static constexpr std::string_view VertexShaderPath{ "SOURCE_DIR R(Daatake)" };
+    public:
+        /** Fills the render pass or attachment formats of the target, e.g. SwapChain::configurePipeline */
+        using Configure = std::function<void(PipelineConfigInfo&)>;
 
-        static constexpr std::string_view FragmentShaderPath{ "SOURCE_DIR R(Daatake)" };
+        explicit Pipeline(std::weak_ptr<InstanceT> gpuWrapper);
 
-        std::vector<char> readFile(std::string_view filePath);
+        static std::shared_ptr<Pipeline> createPipeline(std::weak_ptr<InstanceT> gpuWrapper);
 
-        VkShaderModule createShaderModule(const std::vector<char>& code);
+        /** Loads the shaders and requests the pipeline for the target configure describes, does not wait for the compile
+         *    without configure only the shaders are loaded, e.g. headless until the first OffscreenTarget exists */
+        void init(ShaderRegistry& shaderRegistry, PipelineStateCache& pipelineStateCache, const Configure& configure);
 
-        void createGraphicsPipeline();
+        /** Requests the pipeline again for another target, or the same one after its render pass or formats changed */
+        void retarget(PipelineStateCache& pipelineStateCache, const Configure& configure);
 
-    public:
-        explicit Pipeline(std::weak_ptr<InstanceT> gpuWrapper);
+        [[nodiscard]] inline auto& key() const { return m_key; }
 
-        ~Pipeline();
-
-        static std::shared_ptr<Pipeline> createPipeline(std::weak_ptr<InstanceT> gpuWrapper);
-
-        void init();
+        [[nodiscard]] inline auto& handle() const { return m_handle; }
 
     private:
         std::weak_ptr<InstanceT> m_gpuWrapper;
 
-        VkPipeline m_pipeline;
-        VkShaderModule m_vertexShaderModule;
-        VkShaderModule m_fragmentShaderModule;
+        ShaderId m_vertexShader{ InvalidShader };
+        ShaderId m_fragmentShader{ InvalidShader };
+
+        PipelineKey m_key;
+        PipelineHandle m_handle;
     };
 
     extern template class Pipeline<true>;
@@ -0,0 +1,90 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_PIPELINE_CACHE_H
+#define XK_VK_PIPELINE_CACHE_H
+
+#include <span>
+#include <mutex>
+#include <vector>
+#include <filesystem>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    class PipelineCache
+    {
+        /** This class represents the persistent VkPipelineCache
+         *    the blob is loaded on startup and only handed to the driver when its header matches
+         *    the current device (vendor, device, pipelineCacheUUID) and our checksum is intact,
+         *    worker threads get their own caches, seeded with the main one and merged back into it before saving,
+         *    saving writes a temporary file and renames it so a crash never leaves a torn cache
+         */
+
+    public:
+        //Set to "cold" to ignore the blob on disk, used to compare cold and warm startup times
+        static constexpr std::string_view EnvironmentVariable{ "XK_PIPELINE_CACHE" };
+
+        PipelineCache(VkDevice device, const VkPhysicalDeviceProperties& gpuProperties, std::filesystem::path path = defaultPath());
+
+        ~PipelineCache();
+
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+
+        /** Per-platform user cache directory, e.g. $XDG_CACHE_HOME/xk/pipeline_cache.bin */
+        static std::filesystem::path defaultPath();
+
+        /** Checks the driver header of a raw VkPipelineCache blob against the device */
+        static bool isCompatible(std::span<const u8> blob, const VkPhysicalDeviceProperties& gpuProperties);
+
+        [[nodiscard]] inline auto& handle() const { return m_cache; }
+
+        /** True when a valid blob from a previous run was loaded */
+        [[nodiscard]] inline bool isWarm() const { return m_isWarm; }
+
+        /** Creates a cache owned by one worker thread holding the current contents of the main cache
+         *    merged back in mergeWorkerCaches */
+        [[nodiscard]] VkPipelineCache createWorkerCache();
+
+        void mergeWorkerCaches();
+
+        /** Merges worker caches and writes the result atomically, returns false on I/O failure */
+        bool save();
+
+    private:
+        //Our own header in front of the driver blob, detects truncated or foreign files
+        struct FileHeader
+        {
+            static constexpr u32 Magic{ 0x43504b58 }; // "XKPC"
+            static constexpr u32 Version{ 1 };
+
+            u32 magic{ Magic };
+            u32 version{ Version };
+            u64 dataSize{ 0 };
+            u64 checksum{ 0 };
+        };
+
+        [[nodiscard]] std::vector<u8> load() const;
+
+        VkDevice                        m_device{ VK_NULL_HANDLE };
+
+        VkPhysicalDeviceProperties      m_gpuProperties{};
+
+        std::filesystem::path           m_path{};
+
+        VkPipelineCache                 m_cache{ VK_NULL_HANDLE };
+
+        std::mutex                      m_workerMutex;
+
+        std::vector<VkPipelineCache>    m_workerCaches{};
+
+        bool                            m_isWarm{ false };
+    };
+}
+
+#endif //XK_VK_PIPELINE_CACHE_H
@@ -0,0 +1,185 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_PIPELINE_COMPILER_H
+#define XK_VK_PIPELINE_COMPILER_H
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <condition_variable>
+#include <unordered_map>
+
+#include <vulkan/vulkan.hpp>
+
+#include <async/task-scheduler.h>
+
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_deletion_queue.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_cache.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_config_info.h>
+#include <xk-graphics-engine/xk-vulkan/vk_specialization.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    struct PipelineDescription
+    {
+        PipelineConfigInfo  config{ PipelineConfigInfo::defaultPipelineConfigInfo() };
+
+        //Owned by the caller, must stay alive until the handle is no longer pending
+        VkShaderModule      vertexShader{ VK_NULL_HANDLE };
+        VkShaderModule      fragmentShader{ VK_NULL_HANDLE };
+
+        //Applied to both stages, ids a stage does not declare are ignored by the driver
+        std::vector<SpecializationValue> specialization{};
+
+        /** Hash of every field that ends up in VkGraphicsPipelineCreateInfo */
+        [[nodiscard]] u64 hash() const;
+
+        /** Compares the same fields as hash, the pointers inside the config are not compared */
+        bool operator==(const PipelineDescription& other) const;
+    };
+
+    struct PipelineDescriptionHash
+    {
+        inline u64 operator()(const PipelineDescription& description) const { return description.hash(); }
+    };
+
+    class PipelineHandle
+    {
+        /** Shared result of an asynchronous compile, copies refer to the same pipeline */
+
+    public:
+        enum class Status : Enum_t
+        {
+            Pending,
+            Ready,
+            Failed
+        };
+
+        PipelineHandle() = default;
+
+        [[nodiscard]] inline bool isValid() const { return m_state != nullptr; }
+
+        [[nodiscard]] inline Status status() const { return m_state ? m_state->status.load(std::memory_order_acquire) : Status::Failed; }
+
+        [[nodiscard]] inline bool isReady() const { return status() == Status::Ready; }
+
+        /** The pipeline once ready, VK_NULL_HANDLE while pending or after a failed compile */
+        [[nodiscard]] inline VkPipeline get() const { return isReady() ? m_state->pipeline.load(std::memory_order_acquire) : VK_NULL_HANDLE; }
+
+        /** Blocks until the compile finished, never call this on the frame path */
+        void wait() const;
+
+        /** Handles are equal when they share one compile, and so one pipeline */
+        [[nodiscard]] inline bool operator==(const PipelineHandle& other) const { return m_state == other.m_state; }
+
+    private:
+        friend class PipelineCompiler;
+
+        struct State
+        {
+            std::atomic<Status> status{ Status::Pending };
+
+            //Written before status becomes Ready, replaced only at a frame boundary by PipelineCompiler::replace
+            std::atomic<VkPipeline> pipeline{ VK_NULL_HANDLE };
+        };
+
+        explicit PipelineHandle(std::shared_ptr<State> state)
+            : m_state{ std::move(state) }
+        {}
+
+        std::shared_ptr<State> m_state{};
+    };
+
+    class PipelineCompiler
+    {
+        /** This class represents the pipeline compilation service
+         *    descriptions are compiled in parallel on TaskScheduler workers and handed back as handles,
+         *    identical descriptions are compiled once and share the handle, a failed one is compiled again when requested again,
+         *    every worker compiles into its own VkPipelineCache which is merged before saving
+         *    with FallbackMode::UseFallback resolve() never blocks, a pending pipeline is replaced by the fallback
+         */
+
+    public:
+        enum class FallbackMode : Enum_t
+        {
+            WaitForCompile,
+            UseFallback
+        };
+
+        PipelineCompiler(VkDevice device,
+                         PipelineCache& pipelineCache,
+                         DeletionQueue& deletionQueue,
+                         VkPipelineLayout defaultLayout,
+                         core::async::TaskScheduler& scheduler = core::async::DefaultTaskScheduler());
+
+        /** Waits for compiles still running, the pipelines are released through the deletion queue */
+        ~PipelineCompiler();
+
+        PipelineCompiler(const PipelineCompiler&) = delete;
+        PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+        /** Schedules a compile, returns the existing handle if the same description was already requested
+         *    and did not fail */
+        [[nodiscard]] PipelineHandle compile(PipelineDescription description);
+
+        /** Pipeline drawn instead of pending ones in FallbackMode::UseFallback, usually compiled synchronously at startup */
+        void setFallback(PipelineHandle fallback, FallbackMode mode = FallbackMode::UseFallback);
+
+        /** Pipeline to bind for handle this frame, see FallbackMode */
+        [[nodiscard]] VkPipeline resolve(const PipelineHandle& handle) const;
+
+        /** Moves the pipeline of a ready replacement into target, so every copy of target draws it from now on
+         *    the previous pipeline is retired through the deletion queue, call this only at a frame boundary
+         */
+        void replace(const PipelineHandle& target, const PipelineHandle& replacement);
+
+        /** Blocks until every scheduled compile finished */
+        void waitIdle() const;
+
+        [[nodiscard]] inline u32 pendingCount() const { return m_pendingCount.load(std::memory_order_acquire); }
+
+    private:
+        void compileOnWorker(const PipelineDescription& description, const std::shared_ptr<PipelineHandle::State>& state);
+
+        [[nodiscard]] VkPipeline build(const PipelineDescription& description, VkPipelineCache cache) const;
+
+        [[nodiscard]] VkPipelineCache acquireWorkerCache();
+
+        void releaseWorkerCache(VkPipelineCache cache);
+
+        VkDevice                                    m_device{ VK_NULL_HANDLE };
+
+        PipelineCache&                              m_pipelineCache;
+
+        DeletionQueue&                              m_deletionQueue;
+
+        VkPipelineLayout                            m_defaultLayout{ VK_NULL_HANDLE };
+
+        core::async::TaskScheduler&                 m_scheduler;
+
+        std::mutex                                  m_mutex;
+
+        std::unordered_map<PipelineDescription, PipelineHandle, PipelineDescriptionHash> m_pipelines{};
+
+        //Worker caches not used by any compile at the moment
+        std::vector<VkPipelineCache>                m_idleWorkerCaches{};
+
+        PipelineHandle                              m_fallback{};
+
+        FallbackMode                                m_fallbackMode{ FallbackMode::WaitForCompile };
+
+        //Only decremented under m_pendingMutex so the destructor cannot run between the decrement and the notify
+        mutable std::mutex                          m_pendingMutex;
+
+        mutable std::condition_variable             m_pendingCondition;
+
+        std::atomic<u32>                            m_pendingCount{ 0 };
+    };
+}
+
+#endif //XK_VK_PIPELINE_COMPILER_H
@@ -24,9 +24,13 @@ namespace xk::graphics_engine::vulkan
         VkPipelineColorBlendStateCreateInfo               colorBlendStateCreateInfo{};
         VkPipelineDepthStencilStateCreateInfo             depthStencilStateCreateInfo{};
         VkPipelineDynamicStateCreateInfo                  dynamicStateCreateInfo{};
+        //Left empty to use the shared layout of the bindless descriptor heap
         VkPipelineLayout                                  pipelineLayout{};
         VkRenderPass                                      renderPass{};
         u32                                               subPass{};
+        //Used instead of renderPass with dynamic rendering, where pipelines only know the attachment formats
+        VkFormat                                          colorAttachmentFormat{ VK_FORMAT_UNDEFINED };
+        VkFormat                                          depthAttachmentFormat{ VK_FORMAT_UNDEFINED };
 
         PipelineConfigInfo() = default;
 
@@ -0,0 +1,172 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_PIPELINE_KEY_H
+#define XK_VK_PIPELINE_KEY_H
+
+#include <bit>
+#include <array>
+#include <vector>
+#include <type_traits>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_config_info.h>
+#include <xk-graphics-engine/xk-vulkan/vk_specialization.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    using ShaderId = u32;
+
+    static constexpr ShaderId InvalidShader{ ~u32{ 0 } };
+
+    struct PipelineKey
+    {
+        /** This struct represents the complete draw state of a graphics pipeline
+         *    it is a flat block of integers without padding, so hashing and comparing are plain
+         *    memory operations, everything the key does not hold has to keep the defaults of
+         *    PipelineConfigInfo::defaultPipelineConfigInfo, fromConfig rejects configs that change it
+         */
+
+        static constexpr Size_t MaxVertexBindings{ 4 };
+        static constexpr Size_t MaxVertexAttributes{ 8 };
+        static constexpr Size_t MaxSpecializationConstants{ 8 };
+
+        struct VertexBinding
+        {
+            u16 stride{ 0 };
+            u8  binding{ 0 };
+            u8  inputRate{ VK_VERTEX_INPUT_RATE_VERTEX };
+
+            bool operator==(const VertexBinding&) const = default;
+        };
+
+        struct VertexAttribute
+        {
+            u32 format{ VK_FORMAT_UNDEFINED };
+            u16 offset{ 0 };
+            u8  location{ 0 };
+            u8  binding{ 0 };
+
+            bool operator==(const VertexAttribute&) const = default;
+        };
+
+        struct Rasterizer
+        {
+            u8 topology{ VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST };
+            u8 polygonMode{ VK_POLYGON_MODE_FILL };
+            u8 cullMode{ VK_CULL_MODE_NONE };
+            u8 frontFace{ VK_FRONT_FACE_CLOCKWISE };
+            u8 depthBiasEnable{ VK_FALSE };
+            u8 depthClampEnable{ VK_FALSE };
+            u8 primitiveRestartEnable{ VK_FALSE };
+            u8 samples{ VK_SAMPLE_COUNT_1_BIT };
+
+            bool operator==(const Rasterizer&) const = default;
+        };
+
+        struct Blend
+        {
+            u8 enable{ VK_FALSE };
+            u8 srcColorFactor{ VK_BLEND_FACTOR_ONE };
+            u8 dstColorFactor{ VK_BLEND_FACTOR_ZERO };
+            u8 colorOp{ VK_BLEND_OP_ADD };
+            u8 srcAlphaFactor{ VK_BLEND_FACTOR_ONE };
+            u8 dstAlphaFactor{ VK_BLEND_FACTOR_ZERO };
+            u8 alphaOp{ VK_BLEND_OP_ADD };
+            u8 writeMask{ VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT };
+
+            bool operator==(const Blend&) const = default;
+        };
+
+        struct FixedFunction
+        {
+            //Floats are stored as their bits, compared like the driver compares them
+            u32                 lineWidth{ std::bit_cast<u32>(1.0f) };
+            u32                 depthBiasConstantFactor{ 0 };
+            u32                 depthBiasClamp{ 0 };
+            u32                 depthBiasSlopeFactor{ 0 };
+            u32                 minSampleShading{ std::bit_cast<u32>(1.0f) };
+            std::array<u32, 4>  blendConstants{};
+
+            //Bit n is set when VkDynamicState n is dynamic, the states of the extensions are not representable
+            u32                 dynamicStates{ (1u << VK_DYNAMIC_STATE_VIEWPORT) | (1u << VK_DYNAMIC_STATE_SCISSOR) };
+
+            u8                  logicOpEnable{ VK_FALSE };
+            u8                  logicOp{ VK_LOGIC_OP_COPY };
+            u8                  sampleShadingEnable{ VK_FALSE };
+            u8                  viewportCount{ 1 };
+            u8                  scissorCount{ 1 };
+            std::array<u8, 3>   reserved{};
+
+            bool operator==(const FixedFunction&) const = default;
+        };
+
+        struct Depth
+        {
+            u8 testEnable{ VK_TRUE };
+            u8 writeEnable{ VK_TRUE };
+            u8 compareOp{ VK_COMPARE_OP_LESS };
+            u8 stencilEnable{ VK_FALSE };
+
+            bool operator==(const Depth&) const = default;
+        };
+
+        ShaderId                                        vertexShader{ InvalidShader };
+        ShaderId                                        fragmentShader{ InvalidShader };
+
+        //Handles are stored as integers so the key has the same layout on 32 and 64 bit builds
+        u64                                             renderPass{ 0 };
+        u64                                             pipelineLayout{ 0 };
+        u32                                             subPass{ 0 };
+
+        //Dynamic rendering keys have no render pass, the formats stay valid across swapchain recreation
+        u32                                             colorFormat{ VK_FORMAT_UNDEFINED };
+        u32                                             depthFormat{ VK_FORMAT_UNDEFINED };
+
+        Depth                                           depth{};
+        Rasterizer                                      rasterizer{};
+        Blend                                           blend{};
+        FixedFunction                                   fixedFunction{};
+
+        u8                                              vertexBindingCount{ 0 };
+        u8                                              vertexAttributeCount{ 0 };
+        u8                                              specializationCount{ 0 };
+        u8                                              reserved0{ 0 };
+
+        std::array<VertexBinding, MaxVertexBindings>    vertexBindings{};
+        std::array<VertexAttribute, MaxVertexAttributes> vertexAttributes{};
+
+        //Sorted by constantId so the same variant always has the same bytes
+        std::array<SpecializationValue, MaxSpecializationConstants> specializations{};
+
+        u32                                             reserved1{ 0 };
+
+        bool operator==(const PipelineKey&) const = default;
+
+        [[nodiscard]] u64 hash() const;
+
+        /** Builds the key of a config, throws Exception::PipelineError for state the key cannot represent */
+        static PipelineKey fromConfig(const PipelineConfigInfo& config, ShaderId vertexShader, ShaderId fragmentShader);
+
+        /** Expands the key back into a config, the inverse of fromConfig */
+        [[nodiscard]] PipelineConfigInfo toConfig() const;
+
+        /** Sets or overrides one specialization constant, throws Exception::PipelineError when the key is full */
+        void setSpecialization(SpecializationValue specialization);
+
+        [[nodiscard]] std::vector<SpecializationValue> specializationValues() const;
+    };
+
+    static_assert(std::has_unique_object_representations_v<PipelineKey>, "PipelineKey must not contain padding, it is hashed as raw memory");
+
+    struct PipelineKeyHash
+    {
+        inline u64 operator()(const PipelineKey& key) const { return key.hash(); }
+    };
+}
+
+#endif //XK_VK_PIPELINE_KEY_H
@@ -0,0 +1,81 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_PIPELINE_LAYOUT_CACHE_H
+#define XK_VK_PIPELINE_LAYOUT_CACHE_H
+
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_deletion_queue.h>
+#include <xk-graphics-engine/xk-vulkan/vk_descriptor_heap.h>
+#include <xk-graphics-engine/xk-vulkan/vk_spirv_reflection.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    class PipelineLayoutCache
+    {
+        /** This class represents the pipeline layouts derived from shader reflection
+         *    shaders that only use the bindless heap and fit its push constant range share the heap layout,
+         *    so binding the global set once covers every pipeline, any other interface gets a layout
+         *    created once per distinct set of bindings and reused by every shader declaring the same
+         */
+
+    public:
+        PipelineLayoutCache(VkDevice device, DeletionQueue& deletionQueue, const DescriptorHeap& descriptorHeap);
+
+        /** Layouts are released through the deletion queue */
+        ~PipelineLayoutCache();
+
+        PipelineLayoutCache(const PipelineLayoutCache&) = delete;
+        PipelineLayoutCache& operator=(const PipelineLayoutCache&) = delete;
+
+        /** Layout matching the merged reflection of all stages of a pipeline */
+        [[nodiscard]] VkPipelineLayout get(const ShaderReflection& reflection);
+
+        /** True when the interface is a subset of the bindless heap set and its push constants */
+        [[nodiscard]] bool isHeapCompatible(const ShaderReflection& reflection) const;
+
+        /** Number of layouts created besides the heap layout */
+        [[nodiscard]] Size_t layoutCount() const;
+
+    private:
+        struct LayoutKey
+        {
+            std::vector<DescriptorBinding>  bindings{};
+            u32                             pushConstantSize{ 0 };
+            VkShaderStageFlags              pushConstantStages{ 0 };
+
+            bool operator==(const LayoutKey&) const = default;
+        };
+
+        struct LayoutKeyHash
+        {
+            u64 operator()(const LayoutKey& key) const;
+
+            u64 operator()(const std::vector<DescriptorBinding>& bindings) const;
+        };
+
+        [[nodiscard]] VkDescriptorSetLayout getSetLayout(const std::vector<DescriptorBinding>& bindings);
+
+        VkDevice                                m_device{ VK_NULL_HANDLE };
+
+        DeletionQueue&                          m_deletionQueue;
+
+        const DescriptorHeap&                   m_descriptorHeap;
+
+        mutable std::mutex                      m_mutex;
+
+        std::unordered_map<LayoutKey, VkPipelineLayout, LayoutKeyHash>                          m_layouts{};
+
+        std::unordered_map<std::vector<DescriptorBinding>, VkDescriptorSetLayout, LayoutKeyHash> m_setLayouts{};
+    };
+}
+
+#endif //XK_VK_PIPELINE_LAYOUT_CACHE_H
@@ -0,0 +1,125 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_PIPELINE_STATE_CACHE_H
+#define XK_VK_PIPELINE_STATE_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_key.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_compiler.h>
+#include <xk-graphics-engine/xk-vulkan/vk_shader_registry.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_layout_cache.h>
+#include <xk-graphics-engine/xk-vulkan/vk_specialization.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    struct PipelineCacheStats
+    {
+        u64 hits{ 0 };
+        u64 misses{ 0 };
+
+        [[nodiscard]] inline f64 hitRate() const { return hits + misses == 0 ? 0.0 : static_cast<f64>(hits) / static_cast<f64>(hits + misses); }
+    };
+
+    struct PipelineRebuild
+    {
+        //Handle stored in the cache, the one every user holds
+        PipelineHandle current{};
+
+        //Compiled from the new shader code, moved into current once ready
+        PipelineHandle replacement{};
+    };
+
+    class PipelineStateCache
+    {
+        /** This class represents the pipeline state object cache
+         *    a concurrent map from PipelineKey to the pipeline compiled for it, split into shards
+         *    so lookups from different threads rarely touch the same lock, a hit is a shared lock
+         *    and one hash lookup, a miss schedules exactly one compile on the PipelineCompiler
+         *    entries compare the whole key, so keys with the same hash never share a pipeline
+         *    a failed compile stays cached, and the fallback is drawn, until retryFailed or a shader rebuild
+         */
+
+    public:
+        static constexpr Size_t ShardCount{ 16 };
+
+        PipelineStateCache(PipelineCompiler& compiler, const ShaderRegistry& shaderRegistry, PipelineLayoutCache& layoutCache);
+
+        PipelineStateCache(const PipelineStateCache&) = delete;
+        PipelineStateCache& operator=(const PipelineStateCache&) = delete;
+
+        /** Handle of the pipeline for key, scheduling its compile on the first request */
+        [[nodiscard]] PipelineHandle getHandle(const PipelineKey& key);
+
+        /** Pipeline to bind for key this frame, pending compiles resolve to the compiler fallback */
+        [[nodiscard]] VkPipeline get(const PipelineKey& key);
+
+        /** Variant of key with constant set to value, throws Exception::PipelineError when the shaders of key
+         *    do not declare a constant of that name and type
+         */
+        template<SpecializationScalar T>
+        [[nodiscard]] PipelineKey specialize(PipelineKey key, const SpecializationConstant<T>& constant, T value) const
+        {
+            return specialize(key, constant.name, SpecializationConstant<T>::Type, SpecializationConstant<T>::encode(value));
+        }
+
+        /** Schedules a compile with the current shader code for every cached pipeline using shader
+         *    failed pipelines using shader are compiled again in place and are not part of the result */
+        [[nodiscard]] std::vector<PipelineRebuild> rebuild(ShaderId shader);
+
+        /** Compiles every pipeline whose compile failed again, returns how many were scheduled */
+        Size_t retryFailed();
+
+        /** Keys of every cached pipeline, the CPU side description of the pipelines to compile again on a new device */
+        [[nodiscard]] std::vector<PipelineKey> keys() const;
+
+        [[nodiscard]] PipelineCacheStats stats() const;
+
+        void resetStats();
+
+        void logStats() const;
+
+    private:
+        struct Shard
+        {
+            mutable std::shared_mutex                                       mutex;
+            std::unordered_map<PipelineKey, PipelineHandle, PipelineKeyHash> pipelines{};
+        };
+
+        [[nodiscard]] inline Shard& shardOf(u64 hash) { return m_shards[hash % ShardCount]; }
+
+        [[nodiscard]] PipelineKey specialize(PipelineKey key, std::string_view name, SpecializationType type, u32 value) const;
+
+        /** Returns the keys that were compiled again */
+        std::unordered_set<PipelineKey, PipelineKeyHash> retryFailed(const std::function<bool(const PipelineKey&)>& filter);
+
+        /** Expands the key, layout and vertex input left empty in the key come from shader reflection */
+        [[nodiscard]] PipelineDescription describe(const PipelineKey& key);
+
+        PipelineCompiler&                   m_compiler;
+
+        const ShaderRegistry&               m_shaderRegistry;
+
+        PipelineLayoutCache&                m_layoutCache;
+
+        std::array<Shard, ShardCount>       m_shards{};
+
+        std::atomic<u64>                    m_hits{ 0 };
+
+        std::atomic<u64>                    m_misses{ 0 };
+    };
+}
+
+#endif //XK_VK_PIPELINE_STATE_CACHE_H
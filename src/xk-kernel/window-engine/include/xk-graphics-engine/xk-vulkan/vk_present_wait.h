@@ -0,0 +1,48 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_PRESENT_WAIT_H
+#define XK_VK_PRESENT_WAIT_H
+
+#include <string_view>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    class PresentWait
+    {
+        /** This class represents waiting for a present to reach the display
+         *    built on VK_KHR_present_id and VK_KHR_present_wait, every present is tagged with an
+         *    increasing id and wait() blocks until the image with that id is shown, which tells the
+         *    frame pacing when the display actually took a frame instead of when the queue accepted it
+         *    when the device lacks the extensions the swapchain estimates presents from its fences
+         */
+
+    public:
+        //Set to "off" to estimate presents from fences on devices supporting present wait
+        static constexpr std::string_view EnvironmentVariable{ "XK_PRESENT_WAIT" };
+
+        /** True when the device exposes both extensions and their features */
+        [[nodiscard]] static bool isSupported(VkPhysicalDevice gpu);
+
+        /** True when XK_PRESENT_WAIT asks for the fence estimate */
+        [[nodiscard]] static bool isDisabled();
+
+        /** Loads the entry point, the device has to be created with the extensions and features enabled */
+        explicit PresentWait(VkDevice device);
+
+        /** VK_SUCCESS once the present is shown, VK_TIMEOUT or an out of date result otherwise */
+        VkResult wait(VkSwapchainKHR swapChain, u64 presentId, u64 timeoutNanoseconds) const;
+
+    private:
+        VkDevice                m_device{ VK_NULL_HANDLE };
+
+        PFN_vkWaitForPresentKHR m_waitForPresent{ nullptr };
+    };
+}
+
+#endif //XK_VK_PRESENT_WAIT_H
@@ -0,0 +1,126 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_SHADER_HOT_RELOAD_H
+#define XK_VK_SHADER_HOT_RELOAD_H
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <filesystem>
+#include <string_view>
+#include <unordered_set>
+#include <condition_variable>
+
+#include <vulkan/vulkan.hpp>
+
+#include <async/task-scheduler.h>
+
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_deletion_queue.h>
+#include <xk-graphics-engine/xk-vulkan/vk_shader_registry.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_compiler.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_state_cache.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    class ShaderHotReload
+    {
+        /** This class represents the development mode shader reload
+         *    the GLSL source directory is watched with inotify, a changed file is compiled to SPIR-V
+         *    on a TaskScheduler worker and every cached pipeline using it is recompiled asynchronously,
+         *    update() swaps finished pipelines in at a frame boundary, the replaced pipelines and modules
+         *    go through the deletion queue so frames still in flight keep drawing with them
+         *    a shader that fails to compile is reported and the previous version keeps running
+         */
+
+    public:
+        static constexpr std::string_view EnvironmentVariable{ "XK_SHADER_HOT_RELOAD" };
+
+        /** True when EnvironmentVariable is set to anything but "0" */
+        [[nodiscard]] static bool isRequested();
+
+        ShaderHotReload(ShaderRegistry& shaderRegistry,
+                        PipelineStateCache& pipelineStateCache,
+                        PipelineCompiler& pipelineCompiler,
+                        DeletionQueue& deletionQueue,
+                        std::filesystem::path sourceDirectory,
+                        std::filesystem::path glslCompiler,
+                        core::async::TaskScheduler& scheduler = core::async::DefaultTaskScheduler());
+
+        /** Stops watching and waits for recompiles still running */
+        ~ShaderHotReload();
+
+        ShaderHotReload(const ShaderHotReload&) = delete;
+        ShaderHotReload& operator=(const ShaderHotReload&) = delete;
+
+        /** Applies finished reloads, call once per frame before recording, never blocks
+         *    true when a pipeline was swapped, so what is on screen is outdated */
+        bool update();
+
+        [[nodiscard]] inline bool isWatching() const { return m_watcher.joinable(); }
+
+    private:
+        struct CompiledShader
+        {
+            std::string         name{};
+            std::vector<u32>    code{};
+        };
+
+        void watch(std::stop_token stopToken);
+
+        void scheduleRecompile(const std::string& name);
+
+        void recompile(const std::string& name);
+
+        [[nodiscard]] static bool isShaderSource(std::string_view name);
+
+        ShaderRegistry&                 m_shaderRegistry;
+
+        PipelineStateCache&             m_pipelineStateCache;
+
+        PipelineCompiler&               m_pipelineCompiler;
+
+        DeletionQueue&                  m_deletionQueue;
+
+        std::filesystem::path           m_sourceDirectory;
+
+        std::filesystem::path           m_glslCompiler;
+
+        std::filesystem::path           m_outputDirectory;
+
+        core::async::TaskScheduler&     m_scheduler;
+
+        std::mutex                      m_mutex;
+
+        //Sources with a recompile scheduled, editors often write a file several times in a row
+        std::unordered_set<std::string> m_scheduled{};
+
+        std::vector<CompiledShader>     m_compiled{};
+
+        //Only touched by update() on the frame thread
+        std::vector<PipelineRebuild>    m_rebuilds{};
+
+        std::vector<VkShaderModule>     m_retiredModules{};
+
+        //Only decremented under m_pendingMutex so the destructor cannot run between the decrement and the notify
+        std::mutex                      m_pendingMutex;
+
+        std::condition_variable         m_pendingCondition;
+
+        std::atomic<u32>                m_pendingCount{ 0 };
+
+        std::atomic<u32>                m_compileCount{ 0 };
+
+        int                             m_inotify{ -1 };
+
+        //Declared last, so it is joined before the members it reads are destroyed
+        std::jthread                    m_watcher{};
+    };
+}
+
+#endif //XK_VK_SHADER_HOT_RELOAD_H
@@ -0,0 +1,109 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_SHADER_REGISTRY_H
+#define XK_VK_SHADER_REGISTRY_H
+
+#include <span>
+#include <string>
+#include <vector>
+#include <optional>
+#include <filesystem>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_key.h>
+#include <xk-graphics-engine/xk-vulkan/vk_deletion_queue.h>
+#include <xk-graphics-engine/xk-vulkan/vk_spirv_reflection.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    /** CPU side description of a registered shader, enough to register it again on another device */
+    struct ShaderSource
+    {
+        std::vector<std::string>    names{};
+        std::vector<u32>            code{};
+    };
+
+    class ShaderRegistry
+    {
+        /** This class represents the owner of every VkShaderModule
+         *    SPIR-V comes either from a memory mapped file or from a u32 array embedded at build time,
+         *    in both cases the driver reads the words in place, a copy is retained only so the module
+         *    can be created again on a new device after the old one was lost,
+         *    each distinct code is turned into a module once, identical code returns the same ShaderId
+         */
+
+    public:
+        static constexpr u32 SpirvMagic{ 0x07230203 };
+
+        ShaderRegistry(VkDevice device, DeletionQueue& deletionQueue);
+
+        /** Modules are released through the deletion queue */
+        ~ShaderRegistry();
+
+        ShaderRegistry(const ShaderRegistry&) = delete;
+        ShaderRegistry& operator=(const ShaderRegistry&) = delete;
+
+        /** Maps a .spv file and registers its code, throws Exception::PipelineError on invalid SPIR-V */
+        ShaderId load(const std::filesystem::path& path);
+
+        /** Registers SPIR-V words, e.g. an array embedded at build time, name is the source file it was compiled from */
+        ShaderId add(std::span<const u32> code, std::string_view name = {});
+
+        /** Id registered for a source file name, used to map changed files back to shaders */
+        [[nodiscard]] std::optional<ShaderId> find(std::string_view name) const;
+
+        /** Swaps the code behind id keeping the id, returns the previous module which the caller retires
+         *    once no pipeline compile reads it anymore
+         */
+        [[nodiscard]] VkShaderModule replace(ShaderId id, std::span<const u32> code);
+
+        [[nodiscard]] VkShaderModule module(ShaderId id) const;
+
+        /** Interface of the shader, reflected once when it was registered */
+        [[nodiscard]] ShaderReflection reflection(ShaderId id) const;
+
+        [[nodiscard]] Size_t moduleCount() const;
+
+        /** Code and names of every shader in ShaderId order, the current code for replaced shaders */
+        [[nodiscard]] std::vector<ShaderSource> sources() const;
+
+        /** Registers sources on an empty registry, each one gets its index as ShaderId again, so PipelineKeys
+         *    built on the registry of a lost device stay valid */
+        void restore(std::span<const ShaderSource> sources);
+
+        static u64 contentHash(std::span<const u32> code);
+
+    private:
+        [[nodiscard]] VkShaderModule createModule(std::span<const u32> code) const;
+
+        struct Entry
+        {
+            VkShaderModule      module{ VK_NULL_HANDLE };
+            u64                 hash{ 0 };
+            ShaderReflection    reflection{};
+            std::vector<u32>    code{};
+        };
+
+        VkDevice                            m_device{ VK_NULL_HANDLE };
+
+        DeletionQueue&                      m_deletionQueue;
+
+        mutable std::shared_mutex           m_mutex;
+
+        //Indexed by ShaderId
+        std::vector<Entry>                  m_entries{};
+
+        std::unordered_map<u64, ShaderId>   m_idsByHash{};
+
+        std::unordered_map<std::string, ShaderId> m_idsByName{};
+    };
+}
+
+#endif //XK_VK_SHADER_REGISTRY_H
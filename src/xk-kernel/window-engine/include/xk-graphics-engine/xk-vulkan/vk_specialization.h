@@ -0,0 +1,71 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_SPECIALIZATION_H
+#define XK_VK_SPECIALIZATION_H
+
+#include <bit>
+#include <concepts>
+#include <string_view>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    enum class SpecializationType : Enum_t
+    {
+        Bool,
+        Int,
+        UInt,
+        Float
+    };
+
+    /** Raw 32 bit value of one specialization constant, bools are stored as VkBool32 */
+    struct SpecializationValue
+    {
+        u32 constantId{ 0 };
+        u32 value{ 0 };
+
+        bool operator==(const SpecializationValue&) const = default;
+    };
+
+    template<typename T>
+    concept SpecializationScalar = std::same_as<T, bool> || std::same_as<T, s32> || std::same_as<T, u32> || std::same_as<T, f32>;
+
+    template<SpecializationScalar T>
+    struct SpecializationConstant
+    {
+        /** This struct represents a specialization constant declared on the C++ side
+         *    it is matched by name against the reflected SPIR-V, so the constant_id used in GLSL
+         *    is never repeated in C++ and a type mismatch is reported before the pipeline is compiled
+         *
+         *    inline constexpr SpecializationConstant<bool> UseMsaa{ "USE_MSAA" };
+         */
+
+        static constexpr SpecializationType Type
+        {
+            std::same_as<T, bool> ? SpecializationType::Bool :
+            std::same_as<T, s32>  ? SpecializationType::Int  :
+            std::same_as<T, u32>  ? SpecializationType::UInt : SpecializationType::Float
+        };
+
+        std::string_view name{};
+
+        [[nodiscard]] static constexpr u32 encode(T value)
+        {
+            if constexpr (std::same_as<T, bool>)
+            {
+                return value ? VK_TRUE : VK_FALSE;
+            }
+            else
+            {
+                return std::bit_cast<u32>(value);
+            }
+        }
+    };
+}
+
+#endif //XK_VK_SPECIALIZATION_H
@@ -0,0 +1,85 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_SPIRV_REFLECTION_H
+#define XK_VK_SPIRV_REFLECTION_H
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_specialization.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    struct ShaderInput
+    {
+        std::string name{};
+        u32         location{ 0 };
+        VkFormat    format{ VK_FORMAT_UNDEFINED };
+        u32         size{ 0 };
+    };
+
+    struct DescriptorBinding
+    {
+        u32                 set{ 0 };
+        u32                 binding{ 0 };
+        VkDescriptorType    type{ VK_DESCRIPTOR_TYPE_MAX_ENUM };
+        //0 for runtime sized arrays
+        u32                 count{ 1 };
+        VkShaderStageFlags  stages{ 0 };
+
+        bool operator==(const DescriptorBinding&) const = default;
+    };
+
+    struct SpecializationConstantInfo
+    {
+        std::string         name{};
+        u32                 constantId{ 0 };
+        SpecializationType  type{ SpecializationType::UInt };
+        u32                 defaultValue{ 0 };
+    };
+
+    struct VertexInputLayout
+    {
+        std::vector<VkVertexInputBindingDescription>    bindings{};
+        std::vector<VkVertexInputAttributeDescription>  attributes{};
+    };
+
+    struct ShaderReflection
+    {
+        /** This struct represents the interface of one or more shader stages, read from the SPIR-V binary
+         *    only the instructions describing the interface are decoded: entry points, decorations,
+         *    types, constants, specialization constants and variables, everything else is skipped by its word count
+         */
+
+        VkShaderStageFlags              stages{ 0 };
+
+        //Vertex shader inputs with a location, built-ins are skipped
+        std::vector<ShaderInput>        inputs{};
+
+        //Sorted by set then binding
+        std::vector<DescriptorBinding>  bindings{};
+
+        u32                             pushConstantSize{ 0 };
+
+        //Constants decorated with a SpecId, sorted by constantId
+        std::vector<SpecializationConstantInfo> specializationConstants{};
+
+        /** Throws Exception::PipelineError for malformed SPIR-V */
+        static ShaderReflection reflect(std::span<const u32> code);
+
+        /** Combines the interface of another stage, bindings used by both stages are merged */
+        void merge(const ShaderReflection& other);
+
+        /** One interleaved per-vertex binding with the inputs packed in location order */
+        [[nodiscard]] VertexInputLayout vertexInputLayout() const;
+    };
+}
+
+#endif //XK_VK_SPIRV_REFLECTION_H
@@ -0,0 +1,102 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#ifndef XK_VK_SURFACE_FORMAT_H
+#define XK_VK_SURFACE_FORMAT_H
+
+#include <vector>
+#include <string_view>
+
+#include <vulkan/vulkan.hpp>
+
+#include <utility/literal.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    enum class SurfaceFormatMode : Enum_t
+    {
+        //8 bit sRGB, the cheapest to render, blend and scan out, works on every display
+        Standard,
+        //10 bit per channel in sRGB, less banding in gradients at the bandwidth of 8 bit
+        Wide,
+        //10 bit BT.2020 with the PQ curve of HDR10, needs an HDR display and VK_EXT_swapchain_colorspace
+        Hdr10,
+        //16 bit float linear extended sRGB, HDR and wide gamut without a curve at twice the bandwidth
+        ScRgb
+    };
+
+    /** What the final composition pass does to the sRGB encoded colors widgets render with
+     *    widgets never convert, the pass writing the swap image last applies this once per pixel */
+    enum class OutputTransfer : u32
+    {
+        //UNORM swap image in sRGB, colors are stored as they are
+        None,
+        //_SRGB swap image, colors are decoded to linear and the hardware encodes them again on store
+        DecodeSrgb,
+        //Decode, BT.709 to BT.2020, scale paper white to nits and encode with ST 2084
+        Pq,
+        //Decode and scale paper white to scRGB, where 1.0 is 80 nits
+        Linear
+    };
+
+    [[nodiscard]] std::string_view toString(SurfaceFormatMode mode);
+
+    [[nodiscard]] std::string_view toString(OutputTransfer transfer);
+
+    [[nodiscard]] std::string_view toString(VkColorSpaceKHR colorSpace);
+
+    /** Push constant layout of the final composition pass */
+    struct OutputEncoding
+    {
+        OutputTransfer  transfer{ OutputTransfer::None };
+
+        //Brightness of sRGB white on HDR outputs, ignored by None and DecodeSrgb
+        f32             paperWhiteNits{ 203.0f };
+    };
+
+    /** Trade-offs of one swap image format, to choose a SurfaceFormatMode per deployment */
+    struct SurfaceFormatCost
+    {
+        u32             bytesPerPixel{ 4 };
+
+        OutputTransfer  transfer{ OutputTransfer::None };
+
+        //Only offered by the surface with VK_EXT_swapchain_colorspace enabled on the instance
+        bool            requiresColorSpaceExtension{ false };
+
+        [[nodiscard]] static SurfaceFormatCost of(VkSurfaceFormatKHR format);
+
+        /** Bytes of one full write of the swap image, the composition and the scan out each read it once more */
+        [[nodiscard]] inline u64 frameBytes(VkExtent2D extent) const
+        {
+            return static_cast<u64>(extent.width) * extent.height * bytesPerPixel;
+        }
+    };
+
+    struct SurfaceFormatPolicy
+    {
+        //Set to standard, wide, hdr10 or scrgb, XK_PAPER_WHITE sets paperWhiteNits
+        static constexpr std::string_view EnvironmentVariable{ "XK_SURFACE_FORMAT" };
+        static constexpr std::string_view PaperWhiteVariable{ "XK_PAPER_WHITE" };
+
+        SurfaceFormatMode               mode{ SurfaceFormatMode::Standard };
+
+        //In order of preference, choose() falls back to the Standard ones when the surface offers none
+        std::vector<VkSurfaceFormatKHR> formats{};
+
+        f32                             paperWhiteNits{ 203.0f };
+
+        [[nodiscard]] static SurfaceFormatPolicy forMode(SurfaceFormatMode mode);
+
+        /** Policy requested through the environment, Standard when nothing is set */
+        [[nodiscard]] static SurfaceFormatPolicy fromEnvironment();
+
+        /** First of formats the surface offers, then the Standard formats, then whatever the surface lists first */
+        [[nodiscard]] VkSurfaceFormatKHR choose(const std::vector<VkSurfaceFormatKHR>& availableFormats) const;
+
+        bool operator==(const SurfaceFormatPolicy& other) const;
+    };
+}
+
+#endif //XK_VK_SURFACE_FORMAT_H
@@ -1,4 +1,4 @@
- 
+
 //Created by kafka on 3/17/2022.
 
 #ifndef XK_VK_SWAP_CHAIN_H
@@ -10,36 +10,31 @@
 
 #include <string>
 #include <vector>
+#include <span>
 #include <memory>
+#include <optional>
 
 #include "vk_gpu_wrapper.h"
-
-namespace xk::graphics_engine::vulkan
-{
-    template<bool ValidationLayersEnabled> class Core;
-}
-
-namespace xk::win
-{
-    template<typename GraphicsApi, bool IsValidationEnabled> class MainWindow;
-}
+#include "vk_dynamic_rendering.h"
+#include "vk_frame_pacing.h"
+#include "vk_surface_format.h"
+#include "vk_frame_statistics.h"
+#include "vk_pipeline_config_info.h"
+#include "config/vk_frames_in_flight.h"
 
 namespace xk::graphics_engine::vulkan
 {
     template<bool ValidationEnabled>
     class SwapChain
     {
-        using InstanceT = GpuWrapper<ValidationEnabled>;
+        /** This class represents the presentation swapchain of one window, every window has its own surface
+         *    and swapchain on the one logical device of the GpuWrapper
+         */
 
-        using ParentWindow = win::MainWindow<Core<ValidationEnabled>, ValidationEnabled>;
-
-        static constexpr Size_t ImagesInFlight{ 2 };
+        using InstanceT = GpuWrapper<ValidationEnabled>;
 
         VkFormat findDepthFormat();
 
-        VkResult acquireNextImage(Index_t *imageIndex);
-        VkResult submitCommandBuffers(const VkCommandBuffer *buffers, Index_t *imageIndex);
-
         //Helper functions
         VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &availableFormats);
 
@@ -47,23 +42,154 @@ namespace xk::graphics_engine::vulkan
 
         VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities);
 
-        void createSwapChain();
+        void createSwapChain(VkSwapchainKHR oldSwapChain);
         void createImageViews();
         void createDepthResources();
         void createRenderPass();
         void createFramebuffers();
         void createSyncObjects();
 
+        /** Hands the views, depth image and framebuffers of the current size to the deletion queue */
+        void retireSizeDependentResources();
+
+        /** Rebuilds the swapchain for m_windowExtent, false while the window is minimized
+         *    the old swapchain is passed as oldSwapchain and only the size dependent resources are created again,
+         *    the retired ones go through the deletion queue so frames in flight finish without vkDeviceWaitIdle */
+        bool recreate();
+
+        /** Switches to m_pendingPacing, waits for the frames in flight when their number changes
+         *    the policy decides present mode, image count, frames in flight and the CPU frame cap */
+        void applyPacing();
+
+        void destroySyncObjects();
+
+        /** Waits for the previous frame to be presented and delays the next one, see PresentTimer
+         *    the present is observed through VK_KHR_present_wait when available and estimated from the frame fence otherwise */
+        void waitForPresent();
+
+        /** Waits for fences, throws when the device was lost */
+        void waitForFences(std::span<const VkFence> fences) const;
+
+        /** The fence of slot has signalled, reports the frame submitted with it to the deletion queue */
+        void completeSlot(Index_t slot);
+
+        /** Bookkeeping after the present of the submitted image, advances to the next frame slot */
+        void finishPresent(VkResult result);
+
+        [[nodiscard]] VkDevice device() const;
+
     public:
-        explicit SwapChain(std::weak_ptr<GpuWrapper<ValidationEnabled>> gpuWrapper);
+        /** surface stays owned by the caller and has to outlive the swapchain */
+        SwapChain(std::weak_ptr<InstanceT> gpuWrapper, VkSurfaceKHR surface, VkExtent2D windowExtent, FramePacingPolicy pacing = FramePacingPolicy::fromEnvironment(),
+                  SurfaceFormatPolicy surfaceFormat = SurfaceFormatPolicy::fromEnvironment());
 
         ~SwapChain();
 
-        void setupForWindow(std::weak_ptr<ParentWindow> parent);
+        SwapChain(const SwapChain&) = delete;
+        SwapChain& operator=(const SwapChain&) = delete;
+
+        /** Records the new framebuffer size, the swapchain is rebuilt by the next acquire */
+        void requestRecreate(VkExtent2D windowExtent);
+
+        /** True once the surface reported VK_ERROR_SURFACE_LOST_KHR, acquires fail until setSurface */
+        [[nodiscard]] inline bool isSurfaceLost() const { return m_surfaceLost; }
+
+        /** Waits for the device and destroys the swapchain, so the lost surface can be destroyed
+         *    a lost device is not recovered here, it is thrown as an Exception with isDeviceLost() from the wait or submit that saw it */
+        void releaseSurface();
+
+        /** Continues on a new surface of the same window, the swapchain is built by the next acquire */
+        void setSurface(VkSurfaceKHR surface);
+
+        /** Takes effect at the next acquire, rebuilds the swapchain for the new present mode and image count */
+        void setFramePacing(FramePacingPolicy pacing);
+
+        /** Takes effect at the next acquire, without depth no depth buffer is allocated or cleared, e.g. for pure 2D UI
+         *    pipelines are keyed on the depth format, so the recreate changes renderTargetVersion */
+        void setDepthEnabled(bool enabled);
+
+        [[nodiscard]] inline bool depthEnabled() const { return m_depthEnabled; }
+
+        /** Takes effect at the next acquire, when the format changes the recreate changes renderTargetVersion,
+         *    a change of the color space alone keeps the pipelines */
+        void setSurfaceFormat(SurfaceFormatPolicy surfaceFormat);
+
+        [[nodiscard]] inline auto& surfaceFormatPolicy() const { return m_surfaceFormatPolicy; }
+
+        /** How the pass writing the swap image last converts the sRGB colors of everything rendered before it
+         *    the format and color space come from the SurfaceFormatPolicy, everything before that pass stays in sRGB */
+        [[nodiscard]] inline OutputEncoding outputEncoding() const
+        {
+            return { SurfaceFormatCost::of({ m_swapChainImageFormat, m_colorSpace }).transfer, m_surfaceFormatPolicy.paperWhiteNits };
+        }
+
+        /** Timestamps user input for the input to present latency of the current pacing mode */
+        inline void markInput() { m_latencyTracker.markInput(); }
+
+        [[nodiscard]] inline auto latencyStatistics() const { return m_latencyTracker.statistics(); }
+
+        /** Present to present time and frame cost, only measured while the policy waits for presents */
+        [[nodiscard]] inline auto presentStatistics() const { return m_presentTimer.statistics(); }
+
+        /** Timings of every presented frame and where it waited, readable from any thread */
+        [[nodiscard]] inline auto& frameStatistics() const { return m_frameStatistics; }
+
+        /** GPU time of a frame for the timing of the frame being recorded, the GpuProfiler resolves frames
+         *    framesInFlight frames late, so it is the time of an earlier frame */
+        inline void reportGpuTime(f64 milliseconds) { m_frameTiming[FrameMetric::Gpu] = static_cast<f32>(milliseconds); }
+
+        /** True when presents are observed through VK_KHR_present_wait rather than estimated from fences */
+        [[nodiscard]] inline bool usesPresentWait() const { return m_presentWait != nullptr; }
+
+        [[nodiscard]] inline auto& framePacing() const { return m_pacing; }
+
+        [[nodiscard]] inline Size_t framesInFlight() const { return m_pacing.framesInFlight; }
+
+        [[nodiscard]] inline auto getPresentMode() const { return m_presentMode; }
+
+        /** Waits for the frame slot and acquires an image, recreating the swapchain first when requested
+         *    VK_NOT_READY while the window is minimized and VK_ERROR_OUT_OF_DATE_KHR when the image
+         *    could not be acquired, in both cases the frame is skipped and the next call tries again */
+        VkResult acquireNextImage(Index_t *imageIndex);
+
+        /** Submits and presents, damage lists the changed parts of the image in pixels, empty for all of it
+         *    the image itself has to be complete, damage is a hint passed through VK_KHR_incremental_present
+         *    so the presentation engine copies or composes less, ignored when the device lacks the extension */
+        VkResult submitCommandBuffers(const VkCommandBuffer *buffers, Index_t *imageIndex, std::span<const VkRect2D> damage = {});
+
+        /** Submits the commands rendering the acquired image, its present waits for present() */
+        void submit(const VkCommandBuffer *buffers, Index_t imageIndex, std::span<const VkRect2D> damage = {});
+
+        /** Presents the images submitted to all swapChains with a single vkQueuePresentKHR, which is why submit is split from it
+         *    the swapchains have to share one device, the result of the first failed present is returned */
+        static VkResult present(std::span<SwapChain* const> swapChains);
+
+        /** True between submit() and present() */
+        [[nodiscard]] inline bool hasPendingPresent() const { return m_pendingPresent.has_value(); }
+
+        /** Frame slot of the frame being recorded, per frame resources are ringed by it */
+        [[nodiscard]] inline Index_t currentFrame() const { return m_currentFrame; }
+
+        /** Begins rendering into the swap image, through dynamic rendering when the device supports it */
+        void beginRendering(VkCommandBuffer commandBuffer, Index_t imageIndex, VkClearColorValue clearColor) const;
+
+        void endRendering(VkCommandBuffer commandBuffer, Index_t imageIndex) const;
+
+        /** Fills the render pass or the attachment formats, whichever the active rendering path needs */
+        void configurePipeline(PipelineConfigInfo& config) const;
+
+        /** Changes whenever a recreate changes what configurePipeline fills in, pipelines configured
+         *    for an older version have to be requested again */
+        [[nodiscard]] inline u64 renderTargetVersion() const { return m_renderTargetVersion; }
+
+        [[nodiscard]] inline bool usesDynamicRendering() const
+        {
+            return m_dynamicRendering != nullptr;
+        }
 
         [[nodiscard]] inline auto& getFrameBuffer(Index_t index) const
         {
-            m_swapChainFramebuffers[index];
+            return m_swapChainFramebuffers[index];
         }
 
         [[nodiscard]] inline auto& getRenderPass() const
@@ -71,6 +197,11 @@ namespace xk::graphics_engine::vulkan
             return m_renderPass;
         }
 
+        [[nodiscard]] inline auto& getImage(Index_t index) const
+        {
+            return m_swapChainImages[index];
+        }
+
         [[nodiscard]] inline auto& getImageView(Index_t index) const
         {
             return m_swapChainImageViews[index];
@@ -86,6 +217,11 @@ namespace xk::graphics_engine::vulkan
             return m_swapChainImageFormat;
         }
 
+        [[nodiscard]] inline auto getSwapChainColorSpace() const
+        {
+            return m_colorSpace;
+        }
+
         [[nodiscard]] inline auto getSwapChainExtent() const
         {
             return m_swapChainExtent;
@@ -107,18 +243,55 @@ namespace xk::graphics_engine::vulkan
         }
 
     private:
+        //Image submitted and waiting for present()
+        struct PendingPresent
+        {
+            u32                         imageIndex{ 0 };
+            u64                         presentId{ 0 };
+            std::vector<VkRectLayerKHR> damage{};
+        };
+
         std::weak_ptr<InstanceT>    m_gpuWrapper;
-        VkSwapchainKHR              m_swapChain;
+        VkSurfaceKHR                m_surface{ VK_NULL_HANDLE };
+        VkSwapchainKHR              m_swapChain{ VK_NULL_HANDLE };
 
         VkFormat                    m_swapChainImageFormat{};
-        VkExtent2D                  m_swapChainExtent, m_windowExtent{};
+        VkColorSpaceKHR             m_colorSpace{ VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+        VkPresentModeKHR            m_presentMode{ VK_PRESENT_MODE_FIFO_KHR };
+        VkExtent2D                  m_swapChainExtent{}, m_windowExtent{};
 
         VkRenderPass                m_renderPass{};
 
+        //See renderTargetVersion
+        u64                         m_renderTargetVersion{ 0 };
+
+        //Owned by the GpuWrapper, nullptr on the render pass path, where m_renderPass and the framebuffers are used instead
+        const DynamicRendering*     m_dynamicRendering{ nullptr };
+
+        VkFormat                    m_depthFormat{ VK_FORMAT_UNDEFINED };
+
+        bool                        m_depthEnabled{ true };
+
+        //Set by setDepthEnabled, applied by the next recreate
+        std::optional<bool>         m_pendingDepthEnabled{};
+
+        //Owned by the GpuWrapper, nullptr when the device lacks VK_KHR_present_wait
+        const PresentWait*          m_presentWait{ nullptr };
+
+        //VK_KHR_incremental_present is enabled, damage is passed to the present
+        bool                        m_incrementalPresent{ false };
+
+        //Id of the last present on the current swapchain, 0 when nothing was presented on it yet
+        u64                         m_lastPresentId{ 0 };
+
+        std::optional<PendingPresent> m_pendingPresent{};
+
         std::vector<VkFramebuffer>  m_swapChainFramebuffers{};
-        std::vector<VkImage>        m_depthImages{};
-        std::vector<VkDeviceMemory> m_depthImageMemories{};
-        std::vector<VkImageView>    m_depthImageViews{};
+        //Shared by all frames, VK_NULL_HANDLE while depth is disabled, it is cleared and never stored so it lives
+        //in lazily allocated memory where offered and a frame only waits for the depth writes of the previous one
+        VkImage                     m_depthImage{ VK_NULL_HANDLE };
+        VkDeviceMemory              m_depthImageMemory{ VK_NULL_HANDLE };
+        VkImageView                 m_depthImageView{ VK_NULL_HANDLE };
         std::vector<VkImage>        m_swapChainImages{};
         std::vector<VkImageView>    m_swapChainImageViews{};
         std::vector<VkSemaphore>    m_imageAvailableSemaphores{};
@@ -127,7 +300,45 @@ namespace xk::graphics_engine::vulkan
         std::vector<VkFence>        m_imagesInFlight{};
 
         Index_t                     m_currentFrame{ 0 };
+
+        //DeletionQueue frame each slot was last submitted in, until its fence is seen signalled
+        std::vector<std::optional<DeletionQueue::FrameNumber>> m_slotFrames{};
+
+        //Monotonic number of frames presented by this swapchain, used for present ids and latency tracking
+        DeletionQueue::FrameNumber  m_frameNumber{ 0 };
+
+        //Set by resizes and out of date or suboptimal results, handled at the next acquire
+        bool                        m_recreateRequested{ false };
+
+        //Set by VK_ERROR_SURFACE_LOST_KHR, cleared by setSurface
+        bool                        m_surfaceLost{ false };
+
+        FramePacingPolicy           m_pacing{};
+
+        std::optional<FramePacingPolicy> m_pendingPacing{};
+
+        SurfaceFormatPolicy         m_surfaceFormatPolicy{};
+
+        FrameLimiter                m_frameLimiter{};
+
+        LatencyTracker              m_latencyTracker{};
+
+        PresentTimer                m_presentTimer{};
+
+        //Start of the frame being recorded, until the next acquire also of the last submitted one
+        PresentTimer::Clock::time_point m_frameStart{};
+
+        //Waits since the last present, closed by finishPresent
+        FrameTiming                 m_frameTiming{};
+
+        //Return of the last vkQueuePresentKHR, the end of the previous frame
+        std::optional<FrameTiming::Clock::time_point> m_lastPresentEnd{};
+
+        FrameStatistics             m_frameStatistics{};
     };
+
+    extern template class SwapChain<true>;
+    extern template class SwapChain<false>;
 }
- 
-#endif  XK_VK_SWAP_CHAIN_H
+
+#endif //XK_VK_SWAP_CHAIN_H
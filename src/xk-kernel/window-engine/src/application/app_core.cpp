@@ -1,6 +1,12 @@
 //
 // Created by kafka on 2/3/2022.
 //
+#include <chrono>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <string_view>
+
 #include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
 
 #include <application/app_core.h>
@@ -9,12 +15,228 @@
 
 namespace xk::application
 {
-    Core::Core([[maybe_unused]] const int argc, [[maybe_unused]] const char* argv[])
-        : m_graphicsEngine{ std::make_shared<GraphicsApi>() }
-        , m_mainWindow{ MainWindow::createMainWindow<700, 500>(m_graphicsEngine, "MainWindow") }
+    Core::Core(const int argc, const char* argv[])
+        : m_headlessOutput{ headlessOutput(argc, argv) }
+        , m_graphicsEngine{ std::make_shared<GraphicsApi>() }
+        , m_mainWindow{ m_headlessOutput ? nullptr : MainWindow::createMainWindow<700, 500>(m_graphicsEngine, "MainWindow") }
         , m_widgets{ }
     {
-        m_graphicsEngine->setupForWindow(m_mainWindow);
+        if (m_headlessOutput)
+        {
+            m_graphicsEngine->setupHeadless();
+        }
+        else
+        {
+            m_graphicsEngine->setupForWindow(m_mainWindow);
+
+            for (u32 i{ 0 }, count{ panelCount(argc, argv) }; i < count; ++i)
+            {
+                openPanel(fmt::format("Panel {}", i + 1), 300, 400);
+            }
+        }
+    }
+
+    Core::~Core()
+    {
+        //Surfaces have to go before the windows they were created for
+        for (const auto& panel : m_widgets)
+        {
+            m_graphicsEngine->detachWindow(panel.id);
+        }
+    }
+
+    u32
+    Core::panelCount(const int argc, const char* argv[])
+    {
+        for (int i{ 1 }; i + 1 < argc; ++i)
+        {
+            if (std::string_view{ argv[i] } == "--panels")
+            {
+                return static_cast<u32>(std::strtoul(argv[i + 1], nullptr, 10));
+            }
+        }
+
+        return 0;
+    }
+
+    void
+    Core::openPanel(std::string_view title, u32 width, u32 height)
+    {
+        auto window = std::make_shared<MainWindow>(m_graphicsEngine, width, height, title);
+
+        const auto id = m_graphicsEngine->attachWindow(window->nativeHandle());
+
+        m_widgets.push_back(Panel{ std::move(window), id });
+    }
+
+    void
+    Core::closePanels()
+    {
+        //The swapchain and surface go first, the window is destroyed with the last reference
+        std::erase_if(m_widgets, [this](const Panel& panel)
+        {
+            if (!panel.window->shouldClose())
+            {
+                return false;
+            }
+
+            m_graphicsEngine->detachWindow(panel.id);
+
+            return true;
+        });
+    }
+
+    std::optional<std::filesystem::path>
+    Core::headlessOutput(const int argc, const char* argv[])
+    {
+        for (int i{ 1 }; i < argc; ++i)
+        {
+            if (std::string_view{ argv[i] } == "--headless")
+            {
+                return i + 1 < argc ? std::filesystem::path{ argv[i + 1] } : std::filesystem::path{ "frame.png" };
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    void
+    Core::renderHeadless(const std::filesystem::path& output)
+    {
+        static constexpr VkExtent2D Extent{ 700, 500 };
+
+        auto target = m_graphicsEngine->createOffscreenTarget(Extent);
+
+        const auto image = target->render([](VkCommandBuffer) {}, VkClearColorValue{ { 0.0f, 0.0f, 0.0f, 1.0f } });
+
+        image.savePng(output);
+
+        log::info("Headless frame written to {}", output.string());
+    }
+
+    void
+    Core::runEventLoop()
+    {
+        //Upper bound of an idle sleep, background work like shader hot reload is picked up at least this often
+        static constexpr f64 IdleTimeoutSeconds{ 0.5 };
+
+        //glfwWaitEventsTimeout needs a positive timeout, a recovery attempt that is due is made right after it
+        static constexpr f64 MinimalTimeoutSeconds{ 0.001 };
+
+        //While a surface or the device is lost nothing can be drawn before the next recovery attempt
+        auto idleTimeout = [this]
+        {
+            const auto recovery = m_graphicsEngine->nextRecoveryAttempt();
+
+            if (!recovery)
+            {
+                return IdleTimeoutSeconds;
+            }
+
+            const std::chrono::duration<f64> remaining{ *recovery - GraphicsApi::RecoveryClock::now() };
+
+            return std::clamp(remaining.count(), MinimalTimeoutSeconds, IdleTimeoutSeconds);
+        };
+
+        m_mainWindow->show();
+
+        for (auto& panel : m_widgets)
+        {
+            panel.window->show();
+        }
+
+        while (!m_mainWindow->shouldClose())
+        {
+            //Events of all windows go through the one GLFW queue, a damaged panel must not let it sleep
+            const bool panelDamaged = std::ranges::any_of(m_widgets, [](const Panel& panel) { return panel.window->needsRedraw(); });
+
+            if (panelDamaged)
+            {
+                m_mainWindow->update();
+            }
+            else
+            {
+                m_mainWindow->waitEvents(idleTimeout());
+            }
+
+            closePanels();
+
+            if (m_graphicsEngine->update())
+            {
+                m_mainWindow->invalidate();
+
+                for (auto& panel : m_widgets)
+                {
+                    panel.window->invalidate();
+                }
+            }
+
+            renderFrame();
+        }
+    }
+
+    void
+    Core::renderFrame()
+    {
+        struct DamagedWindow
+        {
+            Window*                 window;
+            std::vector<VkRect2D>   rects;
+        };
+
+        std::vector<DamagedWindow> damagedWindows{};
+        std::vector<GraphicsApi::WindowFrame> frames{};
+
+        auto collect = [&](Window& window, GraphicsApi::WindowId id)
+        {
+            if (!window.needsRedraw())
+            {
+                return;
+            }
+
+            const auto damage = window.takeDamage();
+
+            auto& damaged = damagedWindows.emplace_back(DamagedWindow{ &window, {} });
+
+            damaged.rects.reserve(damage.rects().size());
+
+            for (const auto& rect : damage.rects())
+            {
+                damaged.rects.push_back({ .offset = { rect.x, rect.y }, .extent = { rect.width, rect.height } });
+            }
+
+            frames.push_back({ .window = id, .record = [](VkCommandBuffer) {}, .clearColor = { { 0.0f, 0.0f, 0.0f, 1.0f } } });
+        };
+
+        collect(*m_mainWindow, GraphicsApi::MainWindowId);
+
+        for (auto& panel : m_widgets)
+        {
+            collect(*panel.window, panel.id);
+        }
+
+        if (frames.empty())
+        {
+            return;
+        }
+
+        //Taken once every window was collected, the vector of rects no longer moves
+        for (Index_t i{ 0 }; i < frames.size(); ++i)
+        {
+            frames[i].damage = damagedWindows[i].rects;
+        }
+
+        const auto presented = m_graphicsEngine->drawWindows(frames);
+
+        //The swapchain was out of date, the next iteration draws into the recreated one
+        //a lost surface or device is left alone, update() invalidates every window once it recovered
+        for (Index_t i{ 0 }; i < frames.size(); ++i)
+        {
+            if (!presented[i] && !m_graphicsEngine->isRecovering(frames[i].window))
+            {
+                damagedWindows[i].window->invalidate();
+            }
+        }
     }
 
     std::weak_ptr<Core::MainWindow>
@@ -25,11 +247,13 @@ namespace xk::application
 
     void Core::run()
     {
-        /*m_mainWindow->show();
-
-        while(!m_mainWindow->shouldClose())
+        if (m_headlessOutput)
         {
-            m_mainWindow->update();
-        }*/
+            renderHeadless(*m_headlessOutput);
+
+            return;
+        }
+
+        runEventLoop();
     }
 }
\ No newline at end of file
@@ -0,0 +1,181 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <array>
+#include <cerrno>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include <utility/image_file.h>
+
+namespace xk::io
+{
+    namespace
+    {
+        constexpr auto CrcTable = []
+        {
+            std::array<u32, 256> table{};
+
+            for (u32 n{ 0 }; n < table.size(); ++n)
+            {
+                u32 c{ n };
+
+                for (u32 k{ 0 }; k < 8; ++k)
+                {
+                    c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+
+                table[n] = c;
+            }
+
+            return table;
+        }();
+
+        u32 crc32(std::span<const u8> bytes, u32 crc = 0xFFFFFFFFu)
+        {
+            for (const auto byte : bytes)
+            {
+                crc = CrcTable[(crc ^ byte) & 0xFFu] ^ (crc >> 8);
+            }
+
+            return crc;
+        }
+
+        u32 adler32(std::span<const u8> bytes)
+        {
+            static constexpr u32 Modulus{ 65521 };
+
+            u32 a{ 1 }, b{ 0 };
+
+            for (const auto byte : bytes)
+            {
+                a = (a + byte) % Modulus;
+                b = (b + a) % Modulus;
+            }
+
+            return (b << 16) | a;
+        }
+
+        void appendBigEndian(std::vector<u8>& out, u32 value)
+        {
+            out.push_back(static_cast<u8>(value >> 24));
+            out.push_back(static_cast<u8>(value >> 16));
+            out.push_back(static_cast<u8>(value >> 8));
+            out.push_back(static_cast<u8>(value));
+        }
+
+        void appendChunk(std::vector<u8>& out, std::string_view type, std::span<const u8> data)
+        {
+            appendBigEndian(out, static_cast<u32>(data.size()));
+
+            const auto typeOffset = out.size();
+
+            out.insert(out.end(), type.begin(), type.end());
+            out.insert(out.end(), data.begin(), data.end());
+
+            //The CRC covers the chunk type and data, not the length
+            const auto crc = crc32({ out.data() + typeOffset, out.size() - typeOffset }) ^ 0xFFFFFFFFu;
+
+            appendBigEndian(out, crc);
+        }
+
+        //zlib stream made of stored deflate blocks
+        std::vector<u8> storedDeflate(std::span<const u8> data)
+        {
+            static constexpr Size_t MaxBlockSize{ 65535 };
+
+            std::vector<u8> out{ 0x78, 0x01 };
+
+            out.reserve(data.size() + (data.size() / MaxBlockSize + 1) * 5 + 6);
+
+            Size_t offset{ 0 };
+
+            do
+            {
+                const auto blockSize = std::min<Size_t>(MaxBlockSize, data.size() - offset);
+                const bool isLast{ offset + blockSize == data.size() };
+
+                out.push_back(isLast ? 1 : 0);
+                out.push_back(static_cast<u8>(blockSize));
+                out.push_back(static_cast<u8>(blockSize >> 8));
+                out.push_back(static_cast<u8>(~blockSize));
+                out.push_back(static_cast<u8>(~blockSize >> 8));
+
+                out.insert(out.end(), data.begin() + static_cast<std::ptrdiff_t>(offset), data.begin() + static_cast<std::ptrdiff_t>(offset + blockSize));
+
+                offset += blockSize;
+            }
+            while (offset < data.size());
+
+            appendBigEndian(out, adler32(data));
+
+            return out;
+        }
+
+        void writeFile(const std::filesystem::path& path, std::span<const u8> bytes)
+        {
+            std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+            if (!file)
+            {
+                throw std::system_error{ errno, std::generic_category(), "failed to write " + path.string() };
+            }
+        }
+    }
+
+    void
+    writePng(const std::filesystem::path& path, u32 width, u32 height, std::span<const u8> rgba)
+    {
+        static constexpr Size_t BytesPerPixel{ 4 };
+        static constexpr std::array<u8, 8> Signature{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+        const Size_t rowSize{ Size_t{ width } * BytesPerPixel };
+
+        if (width == 0 || height == 0 || rgba.size() != rowSize * height)
+        {
+            throw std::invalid_argument("writePng: pixel data does not match the image size");
+        }
+
+        //Every scanline starts with its filter type, 0 stores the row unfiltered
+        std::vector<u8> scanlines{};
+
+        scanlines.reserve((rowSize + 1) * height);
+
+        for (u32 row{ 0 }; row < height; ++row)
+        {
+            const auto begin = rgba.begin() + static_cast<std::ptrdiff_t>(row * rowSize);
+
+            scanlines.push_back(0);
+            scanlines.insert(scanlines.end(), begin, begin + static_cast<std::ptrdiff_t>(rowSize));
+        }
+
+        std::vector<u8> header{};
+
+        appendBigEndian(header, width);
+        appendBigEndian(header, height);
+
+        //8 bit depth, RGBA color type, deflate, adaptive filtering, no interlace
+        header.insert(header.end(), { 8, 6, 0, 0, 0 });
+
+        std::vector<u8> png{ Signature.begin(), Signature.end() };
+
+        appendChunk(png, "IHDR", header);
+        appendChunk(png, "IDAT", storedDeflate(scanlines));
+        appendChunk(png, "IEND", {});
+
+        writeFile(path, png);
+    }
+
+    void
+    writeRaw(const std::filesystem::path& path, std::span<const u8> bytes)
+    {
+        writeFile(path, bytes);
+    }
+}
@@ -0,0 +1,166 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <cerrno>
+#include <utility>
+#include <system_error>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+#include <utility/mapped_file.h>
+
+namespace xk::io
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+        m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            m_file = nullptr;
+
+            throw std::system_error{ static_cast<int>(GetLastError()), std::system_category(), "failed to open " + path.string() };
+        }
+
+        LARGE_INTEGER size{};
+
+        GetFileSizeEx(m_file, &size);
+
+        m_size = static_cast<Size_t>(size.QuadPart);
+
+        if (m_size == 0)
+        {
+            return;
+        }
+
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        m_data = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+        if (m_data == nullptr)
+        {
+            const auto error = static_cast<int>(GetLastError());
+
+            unmap();
+
+            throw std::system_error{ error, std::system_category(), "failed to map " + path.string() };
+        }
+    }
+
+    void
+    MappedFile::unmap()
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+
+        if (m_file)
+        {
+            CloseHandle(m_file);
+        }
+
+        m_data = nullptr;
+        m_mapping = nullptr;
+        m_file = nullptr;
+        m_size = 0;
+    }
+#else
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+        const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (file < 0)
+        {
+            throw std::system_error{ errno, std::generic_category(), "failed to open " + path.string() };
+        }
+
+        struct stat status{};
+
+        if (::fstat(file, &status) != 0)
+        {
+            const auto error = errno;
+
+            ::close(file);
+
+            throw std::system_error{ error, std::generic_category(), "failed to stat " + path.string() };
+        }
+
+        m_size = static_cast<Size_t>(status.st_size);
+
+        if (m_size != 0)
+        {
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+            if (data == MAP_FAILED)
+            {
+                const auto error = errno;
+
+                ::close(file);
+
+                throw std::system_error{ error, std::generic_category(), "failed to map " + path.string() };
+            }
+
+            m_data = data;
+        }
+
+        //The mapping keeps the file referenced, the descriptor is not needed anymore
+        ::close(file);
+    }
+
+    void
+    MappedFile::unmap()
+    {
+        if (m_data)
+        {
+            ::munmap(const_cast<void*>(m_data), m_size);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+#endif
+
+    MappedFile::~MappedFile()
+    {
+        unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile&
+    MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+            m_file = std::exchange(other.m_file, nullptr);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+        }
+
+        return *this;
+    }
+}
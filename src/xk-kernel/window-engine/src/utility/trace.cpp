@@ -0,0 +1,144 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <thread>
+#include <fstream>
+#include <functional>
+
+#include <fmt/format.h>
+
+#include <utility/trace.h>
+
+namespace xk::trace
+{
+    namespace
+    {
+        std::string escape(std::string_view text)
+        {
+            std::string escaped{};
+
+            escaped.reserve(text.size());
+
+            for (const char character : text)
+            {
+                if (character == '"' || character == '\\')
+                {
+                    escaped.push_back('\\');
+                }
+
+                escaped.push_back(character);
+            }
+
+            return escaped;
+        }
+
+        u64 currentThreadId()
+        {
+            return static_cast<u64>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        }
+    }
+
+    Collector::Collector()
+        : m_origin{ Clock::now() }
+    {}
+
+    Collector&
+    Collector::instance()
+    {
+        static Collector collector;
+        return collector;
+    }
+
+    f64
+    Collector::nowUs() const
+    {
+        return std::chrono::duration<f64, std::micro>(Clock::now() - m_origin).count();
+    }
+
+    void
+    Collector::add(Event&& event)
+    {
+        if (!isEnabled())
+        {
+            return;
+        }
+
+        std::scoped_lock lock{ m_mutex };
+
+        m_events.emplace_back(std::move(event));
+    }
+
+    void
+    Collector::setEnabled(bool enabled)
+    {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool
+    Collector::writeChromeTrace(std::string_view path) const
+    {
+        std::ofstream file{ std::string{ path } };
+
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        std::scoped_lock lock{ m_mutex };
+
+        file << "{\"traceEvents\":[\n";
+
+        file << R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"CPU"}},)" << '\n';
+        file << R"({"name":"process_name","ph":"M","pid":2,"args":{"name":"GPU"}})";
+
+        for (const auto& event : m_events)
+        {
+            file << fmt::format(",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                                escape(event.name),
+                                escape(event.category),
+                                static_cast<u32>(event.timeline),
+                                event.threadId,
+                                event.startUs,
+                                event.durationUs);
+        }
+
+        file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        return file.good();
+    }
+
+    void
+    Collector::clear()
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        m_events.clear();
+    }
+
+    ScopedZone::ScopedZone(std::string_view name, std::string_view category)
+        : m_name{ name }
+        , m_category{ category }
+        , m_startUs{ Collector::instance().nowUs() }
+    {}
+
+    ScopedZone::~ScopedZone()
+    {
+        auto& collector = Collector::instance();
+
+        if (!collector.isEnabled())
+        {
+            return;
+        }
+
+        collector.add(Event
+        {
+            .name = std::string{ m_name },
+            .category = std::string{ m_category },
+            .timeline = Timeline::Cpu,
+            .threadId = currentThreadId(),
+            .startUs = m_startUs,
+            .durationUs = collector.nowUs() - m_startUs
+        });
+    }
+}
@@ -0,0 +1,115 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <algorithm>
+
+#include <window/win_damage_region.h>
+
+namespace xk::win
+{
+    namespace
+    {
+        //Touching rectangles are merged too, their union is exactly their bounding box
+        bool touches(const Rect& a, const Rect& b)
+        {
+            return a.x <= b.right() && b.x <= a.right() && a.y <= b.bottom() && b.y <= a.bottom();
+        }
+
+        Rect unite(const Rect& a, const Rect& b)
+        {
+            const s32 left = std::min(a.x, b.x);
+            const s32 top = std::min(a.y, b.y);
+
+            return
+            {
+                .x = left,
+                .y = top,
+                .width = static_cast<u32>(std::max(a.right(), b.right()) - left),
+                .height = static_cast<u32>(std::max(a.bottom(), b.bottom()) - top)
+            };
+        }
+    }
+
+    void
+    DamageRegion::setBounds(u32 width, u32 height)
+    {
+        m_width = width;
+        m_height = height;
+
+        //Clipping against the new size keeps every rectangle inside the window
+        auto rects = std::move(m_rects);
+
+        m_rects.clear();
+
+        for (const auto& rect : rects)
+        {
+            add(rect);
+        }
+    }
+
+    void
+    DamageRegion::add(Rect rect)
+    {
+        const s32 left = std::max(rect.x, 0);
+        const s32 top = std::max(rect.y, 0);
+        const s32 right = std::min(rect.right(), static_cast<s32>(m_width));
+        const s32 bottom = std::min(rect.bottom(), static_cast<s32>(m_height));
+
+        if (right <= left || bottom <= top)
+        {
+            return;
+        }
+
+        rect = { .x = left, .y = top, .width = static_cast<u32>(right - left), .height = static_cast<u32>(bottom - top) };
+
+        //The grown rectangle may touch ones it did not touch before, so absorbing repeats until nothing is left to merge
+        for (auto it = std::ranges::find_if(m_rects, [&](const auto& other) { return touches(other, rect); });
+             it != m_rects.end();
+             it = std::ranges::find_if(m_rects, [&](const auto& other) { return touches(other, rect); }))
+        {
+            rect = unite(*it, rect);
+
+            m_rects.erase(it);
+        }
+
+        m_rects.push_back(rect);
+
+        if (m_rects.size() > MaxRects)
+        {
+            const auto box = bounds();
+
+            m_rects.assign(1, box);
+        }
+    }
+
+    void
+    DamageRegion::addAll()
+    {
+        add({ .x = 0, .y = 0, .width = m_width, .height = m_height });
+    }
+
+    void
+    DamageRegion::clear()
+    {
+        m_rects.clear();
+    }
+
+    Rect
+    DamageRegion::bounds() const
+    {
+        if (m_rects.empty())
+        {
+            return {};
+        }
+
+        Rect box = m_rects.front();
+
+        for (const auto& rect : m_rects)
+        {
+            box = unite(box, rect);
+        }
+
+        return box;
+    }
+}
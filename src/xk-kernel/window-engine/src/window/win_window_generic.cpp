@@ -22,7 +22,12 @@ namespace xk::win
     GenericWindow<GraphicsApiHandler, IsValidationEnabled>::~GenericWindow() noexcept
     {
         glfwDestroyWindow(m_window);
-        glfwTerminate();
+
+        //GLFW is shared by every window, the last one shuts it down
+        if (--detail::OpenWindows == 0)
+        {
+            glfwTerminate();
+        }
     }
 
     template<typename GraphicsApiHandler, bool IsValidationEnabled>
@@ -53,6 +58,8 @@ namespace xk::win
 
         glfwInit();
 
+        ++detail::OpenWindows;
+
         if constexpr (IsGraphicsApiVulkanType())
         {
             if(!glfwVulkanSupported())
@@ -77,6 +84,11 @@ namespace xk::win
         glfwSetFramebufferSizeCallback(m_window, frameBufferResizeCallback);
         glfwSetKeyCallback(m_window, keyHandlerCallBack);
         glfwSetWindowCloseCallback(m_window, windowCloseCallback);
+        glfwSetWindowRefreshCallback(m_window, windowRefreshCallback);
+
+        //Nothing was drawn yet
+        m_damage.setBounds(m_width, m_height);
+        m_damage.addAll();
     }
 
     template<typename GraphicsApiHandler, bool IsValidationEnabled>
@@ -85,7 +97,23 @@ namespace xk::win
     {
         auto _this = static_cast<GenericWindow*>(glfwGetWindowUserPointer(window));
 
-        _this->resizedEvent(static_cast<u32>(width), static_cast<u32>(height));
+        _this->m_width = static_cast<u32>(width);
+        _this->m_height = static_cast<u32>(height);
+
+        //Swapchain images of the new size start without content
+        _this->m_damage.setBounds(_this->m_width, _this->m_height);
+        _this->m_damage.addAll();
+
+        //Only marks the swapchain, it is rebuilt by the next frame so resizing never stalls on the GPU
+        if constexpr (IsGraphicsApiVulkanType())
+        {
+            if (auto graphicsEngine = _this->m_graphicsEngine.lock())
+            {
+                graphicsEngine->resize(window, _this->m_width, _this->m_height);
+            }
+        }
+
+        _this->resizedEvent(_this->m_width, _this->m_height);
     }
 
     template<typename GraphicsApiHandler, bool IsValidationEnabled>
@@ -94,6 +122,14 @@ namespace xk::win
     {
         auto _this = static_cast<GenericWindow*>(glfwGetWindowUserPointer(window));
 
+        if constexpr (IsGraphicsApiVulkanType())
+        {
+            if (auto graphicsEngine = _this->m_graphicsEngine.lock())
+            {
+                graphicsEngine->markInput();
+            }
+        }
+
         _this->keyPressedEvent(static_cast<Key>(key), scancode, action, mods);
     }
 
@@ -106,6 +142,16 @@ namespace xk::win
         _this->closeEvent();
     }
 
+    template<typename GraphicsApiHandler, bool IsValidationEnabled>
+    void
+    GenericWindow<GraphicsApiHandler, IsValidationEnabled>::windowRefreshCallback(WindowEngine* window)
+    {
+        auto _this = static_cast<GenericWindow*>(glfwGetWindowUserPointer(window));
+
+        //The window system lost the contents, e.g. the window was uncovered
+        _this->invalidate();
+    }
+
     template<typename GraphicsApiHandler, bool IsValidationEnabled>
     void
     GenericWindow<GraphicsApiHandler, IsValidationEnabled>::resize(u32 width, u32 height)
@@ -167,6 +213,68 @@ namespace xk::win
         glfwPollEvents();
     }
 
+    template<typename GraphicsApiHandler, bool IsValidationEnabled>
+    void
+    GenericWindow<GraphicsApiHandler, IsValidationEnabled>::waitEvents(f64 timeoutSeconds)
+    {
+        //A static screen sleeps in the event queue instead of spinning through frames nobody would see change
+        if (needsRedraw())
+        {
+            glfwPollEvents();
+        }
+        else
+        {
+            glfwWaitEventsTimeout(timeoutSeconds);
+        }
+    }
+
+    template<typename GraphicsApiHandler, bool IsValidationEnabled>
+    void
+    GenericWindow<GraphicsApiHandler, IsValidationEnabled>::invalidate()
+    {
+        m_damage.addAll();
+    }
+
+    template<typename GraphicsApiHandler, bool IsValidationEnabled>
+    void
+    GenericWindow<GraphicsApiHandler, IsValidationEnabled>::invalidate(Rect rect)
+    {
+        m_damage.add(rect);
+    }
+
+    template<typename GraphicsApiHandler, bool IsValidationEnabled>
+    void
+    GenericWindow<GraphicsApiHandler, IsValidationEnabled>::requestRedraw()
+    {
+        m_redrawRequested.store(true, std::memory_order_release);
+
+        glfwPostEmptyEvent();
+    }
+
+    template<typename GraphicsApiHandler, bool IsValidationEnabled>
+    bool
+    GenericWindow<GraphicsApiHandler, IsValidationEnabled>::needsRedraw() const
+    {
+        //Damage is kept while minimized and drawn once the window is restored
+        return !isMinimized() && (!m_damage.isEmpty() || m_redrawRequested.load(std::memory_order_acquire));
+    }
+
+    template<typename GraphicsApiHandler, bool IsValidationEnabled>
+    DamageRegion
+    GenericWindow<GraphicsApiHandler, IsValidationEnabled>::takeDamage()
+    {
+        if (m_redrawRequested.exchange(false, std::memory_order_acq_rel))
+        {
+            m_damage.addAll();
+        }
+
+        auto damage = m_damage;
+
+        m_damage.clear();
+
+        return damage;
+    }
+
     template class GenericWindow<graphics_engine::gl::Core<true>, true>;
     template class GenericWindow<graphics_engine::gl::Core<false>, true>;
 
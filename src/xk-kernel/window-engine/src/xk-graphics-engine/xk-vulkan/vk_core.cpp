@@ -3,7 +3,13 @@
 //
 
 #include <xk-graphics-engine/xk-vulkan/vk_core.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
 #include <window/win_main_window.h>
+#include <xk-graphics-engine/xk-vulkan/config/vk_frames_in_flight.h>
+#include <utility/log.h>
+
+#include <algorithm>
+#include <exception>
 
 namespace xk::graphics_engine::vulkan
 {
@@ -15,6 +21,16 @@ namespace xk::graphics_engine::vulkan
     {
     }
 
+    template<bool ValidationLayersEnabled>
+    Core<ValidationLayersEnabled>::~Core()
+    {
+        //Surfaces go after the swapchains built on them, the main surface is destroyed by the GpuWrapper
+        while (m_windows.size() > 1)
+        {
+            detachWindow(m_windows.back().id);
+        }
+    }
+
     template<bool ValidationLayersEnabled>
     void
     Core<ValidationLayersEnabled>::setupForWindow(std::weak_ptr<ParentWindow> parent)
@@ -22,7 +38,906 @@ namespace xk::graphics_engine::vulkan
         m_parentWindow = parent;
 
         m_instance->setupForWindow(parent);
-        m_pipeline->init();
+
+        m_windows.push_back(createMainWindowTarget(FramePacingPolicy::fromEnvironment(), SurfaceFormatPolicy::fromEnvironment()));
+
+        m_frameGraph = std::make_unique<FrameGraphT>(m_instance);
+
+        setStatisticsOverlay(FrameStatisticsOverlay::isRequested());
+
+        createPipelineServices();
+    }
+
+    template<bool ValidationLayersEnabled>
+    typename Core<ValidationLayersEnabled>::WindowId
+    Core<ValidationLayersEnabled>::attachWindow(GLFWwindow* window)
+    {
+        const auto id = m_nextWindowId;
+
+        //Created together with the others once the device is rebuilt
+        if (m_lostDevice)
+        {
+            m_lostDevice->windows.emplace_back(id, window);
+
+            return m_nextWindowId++;
+        }
+
+        if (m_windows.empty())
+        {
+            throw Exception::SwapChainError("attachWindow needs the main window set up first");
+        }
+
+        m_windows.push_back(createWindowTarget(id, window));
+
+        log::info("Attached window {}, {} windows share the device", id, m_windows.size());
+
+        return m_nextWindowId++;
+    }
+
+    template<bool ValidationLayersEnabled>
+    VkSurfaceKHR
+    Core<ValidationLayersEnabled>::createWindowSurface(GLFWwindow* window) const
+    {
+        VkSurfaceKHR surface{ VK_NULL_HANDLE };
+
+        if (const auto result = glfwCreateWindowSurface(m_instance->getVulkanInstance(), window, nullptr, &surface); result != VK_SUCCESS)
+        {
+            throw Exception::InstanceError("failed to create the surface of an additional window", result);
+        }
+
+        //The device was picked for the main window, a window on another adapter or display server cannot share it
+        if (!m_instance->isPresentSupported(surface))
+        {
+            m_instance->destroySurface(surface);
+
+            throw Exception::SwapChainError("the present queue cannot present to the additional window");
+        }
+
+        return surface;
+    }
+
+    template<bool ValidationLayersEnabled>
+    typename Core<ValidationLayersEnabled>::WindowTarget
+    Core<ValidationLayersEnabled>::createMainWindowTarget(FramePacingPolicy pacing, SurfaceFormatPolicy surfaceFormat)
+    {
+        const auto window = m_parentWindow.lock();
+
+        return WindowTarget
+        {
+            .id = MainWindowId,
+            .window = window->nativeHandle(),
+            .surface = m_instance->getSurface(),
+            .swapChain = std::make_unique<SwapChainT>(m_instance, m_instance->getSurface(), VkExtent2D{ window->width(), window->height() },
+                                                      std::move(pacing), std::move(surfaceFormat)),
+            .commandBuffers = createFrameCommandBuffers()
+        };
+    }
+
+    template<bool ValidationLayersEnabled>
+    typename Core<ValidationLayersEnabled>::WindowTarget
+    Core<ValidationLayersEnabled>::createWindowTarget(WindowId id, GLFWwindow* window)
+    {
+        const auto surface = createWindowSurface(window);
+
+        int width{ 0 }, height{ 0 };
+
+        glfwGetFramebufferSize(window, &width, &height);
+
+        const auto& main = *m_windows.front().swapChain;
+
+        //The main window paces every frame, so the other windows neither cap nor wait for presents themselves
+        auto pacing = main.framePacing();
+
+        pacing.maxFramesPerSecond = 0.0;
+        pacing.waitForPresent = false;
+
+        std::unique_ptr<SwapChainT> swapChain{};
+
+        try
+        {
+            swapChain = std::make_unique<SwapChainT>(m_instance, surface, VkExtent2D{ static_cast<u32>(width), static_cast<u32>(height) }, std::move(pacing),
+                                                     main.surfaceFormatPolicy());
+        }
+        catch (const Exception&)
+        {
+            m_instance->destroySurface(surface);
+
+            throw;
+        }
+
+        swapChain->setDepthEnabled(main.depthEnabled());
+
+        return WindowTarget
+        {
+            .id = id,
+            .window = window,
+            .surface = surface,
+            .swapChain = std::move(swapChain),
+            .commandBuffers = createFrameCommandBuffers()
+        };
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::detachWindow(WindowId id)
+    {
+        if (id == MainWindowId)
+        {
+            throw Exception::SwapChainError("the main window cannot be detached");
+        }
+
+        if (m_lostDevice)
+        {
+            std::erase_if(m_lostDevice->windows, [&](const auto& window) { return window.first == id; });
+        }
+
+        const auto target = std::ranges::find(m_windows, id, &WindowTarget::id);
+
+        if (target == m_windows.end())
+        {
+            return;
+        }
+
+        //The swapchain destructor waits for the device, so the command buffers are no longer pending either
+        target->swapChain.reset();
+
+        vkFreeCommandBuffers(m_instance->getLogicalDevice(),
+                             m_instance->getCommandPool(),
+                             static_cast<u32>(target->commandBuffers.size()),
+                             target->commandBuffers.data());
+
+        m_instance->destroySurface(target->surface);
+
+        m_windows.erase(target);
+    }
+
+    template<bool ValidationLayersEnabled>
+    std::vector<VkCommandBuffer>
+    Core<ValidationLayersEnabled>::createFrameCommandBuffers() const
+    {
+        //Sized for the largest ring, the pacing mode may change the number of frames in flight
+        std::vector<VkCommandBuffer> commandBuffers(FramePacingPolicy::MaxFramesInFlight);
+
+        const VkCommandBufferAllocateInfo allocateInfo
+        {
+            .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool        = m_instance->getCommandPool(),
+            .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = static_cast<u32>(commandBuffers.size())
+        };
+
+        if (vkAllocateCommandBuffers(m_instance->getLogicalDevice(), &allocateInfo, commandBuffers.data()) != VK_SUCCESS)
+        {
+            throw Exception::InstanceError("failed to allocate frame command buffers!");
+        }
+
+        return commandBuffers;
+    }
+
+    template<bool ValidationLayersEnabled>
+    typename Core<ValidationLayersEnabled>::WindowTarget*
+    Core<ValidationLayersEnabled>::findWindow(WindowId id)
+    {
+        const auto target = std::ranges::find(m_windows, id, &WindowTarget::id);
+
+        return target == m_windows.end() ? nullptr : &*target;
+    }
+
+    template<bool ValidationLayersEnabled>
+    bool
+    Core<ValidationLayersEnabled>::submitFrame(WindowTarget& target, const std::function<void(VkCommandBuffer, Index_t imageIndex)>& record, std::span<const VkRect2D> damage)
+    {
+        try
+        {
+            return recordFrame(target, record, damage);
+        }
+        catch (const Exception& exception)
+        {
+            //The frame is dropped, update() rebuilds what was lost
+            if (exception.isDeviceLost())
+            {
+                markDeviceLost(exception.what());
+
+                return false;
+            }
+
+            if (exception.isSurfaceLost())
+            {
+                log::warning("Window {}: {}", target.id, exception.what());
+
+                return false;
+            }
+
+            throw;
+        }
+    }
+
+    template<bool ValidationLayersEnabled>
+    bool
+    Core<ValidationLayersEnabled>::recordFrame(WindowTarget& target, const std::function<void(VkCommandBuffer, Index_t imageIndex)>& record, std::span<const VkRect2D> damage)
+    {
+        auto& swapChain = *target.swapChain;
+
+        Index_t imageIndex{ 0 };
+
+        if (const auto result = swapChain.acquireNextImage(&imageIndex); result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+        {
+            if (result == VK_ERROR_DEVICE_LOST)
+            {
+                throw Exception::GPUError("device lost while acquiring an image", result);
+            }
+
+            return false;
+        }
+
+        //The acquire may have recreated the swapchain with another render pass or other formats
+        if (target.id == MainWindowId && swapChain.renderTargetVersion() != m_pipelineTargetVersion)
+        {
+            retargetPipeline(swapChain);
+        }
+
+        //The acquire waited for the fence of this slot, so its command buffer is no longer executing
+        const auto frameSlot = swapChain.currentFrame();
+        const auto commandBuffer = target.commandBuffers[frameSlot];
+
+        vkResetCommandBuffer(commandBuffer, 0);
+
+        const VkCommandBufferBeginInfo beginInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+        };
+
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            throw Exception::InstanceError("failed to begin recording a frame!");
+        }
+
+        //The profiler rings over the frame slots of the main window
+        if (target.id == MainWindowId)
+        {
+            m_gpuProfiler->beginFrame(commandBuffer, frameSlot);
+
+            swapChain.reportGpuTime(m_gpuProfiler->lastFrameTimeMs());
+
+            GpuProfiler::ScopedZone frameZone{ *m_gpuProfiler, commandBuffer, "Frame" };
+
+            record(commandBuffer, imageIndex);
+        }
+        else
+        {
+            record(commandBuffer, imageIndex);
+        }
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            throw Exception::InstanceError("failed to record a frame!");
+        }
+
+        swapChain.submit(&commandBuffer, imageIndex, damage);
+
+        return true;
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::retargetPipeline(const SwapChainT& swapChain)
+    {
+        m_pipelineTargetVersion = swapChain.renderTargetVersion();
+
+        m_pipeline->retarget(*m_pipelineStateCache, [&swapChain](PipelineConfigInfo& config) { swapChain.configurePipeline(config); });
+
+        //The previous fallback was built for the old attachments and cannot be drawn into the new ones
+        m_pipelineCompiler->setFallback(m_pipeline->handle());
+
+        log::info("Render target of the main window changed, base pipeline requested again");
+    }
+
+    template<bool ValidationLayersEnabled>
+    bool
+    Core<ValidationLayersEnabled>::drawFrame(const std::function<void(VkCommandBuffer)>& record, VkClearColorValue clearColor, std::span<const VkRect2D> damage)
+    {
+        const WindowFrame frame{ .window = MainWindowId, .record = record, .clearColor = clearColor, .damage = damage };
+
+        return drawWindows({ &frame, 1 }).front();
+    }
+
+    template<bool ValidationLayersEnabled>
+    std::vector<bool>
+    Core<ValidationLayersEnabled>::drawWindows(std::span<const WindowFrame> frames)
+    {
+        std::vector<bool> presented(frames.size(), false);
+
+        //Nothing is drawn until update() rebuilt the device
+        if (m_lostDevice)
+        {
+            return presented;
+        }
+
+        //One frame for all windows, handles retired while recording it are kept until every window finished it
+        m_instance->getDeletionQueue().beginFrame();
+
+        std::vector<SwapChainT*> submitted{};
+
+        for (Index_t i{ 0 }; i < frames.size(); ++i)
+        {
+            const auto& frame = frames[i];
+
+            auto* target = findWindow(frame.window);
+
+            if (target == nullptr || m_lostDevice)
+            {
+                continue;
+            }
+
+            auto& swapChain = *target->swapChain;
+
+            const bool drawsOverlay{ m_statisticsOverlay != nullptr && target->id == MainWindowId };
+
+            //The overlay changes every frame, so it is part of any damage
+            std::vector<VkRect2D> damage(frame.damage.begin(), frame.damage.end());
+
+            if (drawsOverlay && !damage.empty())
+            {
+                damage.push_back(FrameStatisticsOverlay::area(swapChain.getSwapChainExtent()));
+            }
+
+            presented[i] = submitFrame(*target, [&](VkCommandBuffer commandBuffer, Index_t imageIndex)
+            {
+                const auto extent = swapChain.getSwapChainExtent();
+
+                const VkViewport viewport
+                {
+                    .x = 0.0f,
+                    .y = 0.0f,
+                    .width = to_f32(extent.width),
+                    .height = to_f32(extent.height),
+                    .minDepth = 0.0f,
+                    .maxDepth = 1.0f
+                };
+
+                const VkRect2D scissor{ { 0, 0 }, extent };
+
+                swapChain.beginRendering(commandBuffer, imageIndex, frame.clearColor);
+
+                vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+                vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+                frame.record(commandBuffer);
+
+                if (drawsOverlay)
+                {
+                    m_statisticsOverlay->record(commandBuffer, extent, swapChain.frameStatistics());
+                }
+
+                swapChain.endRendering(commandBuffer, imageIndex);
+            }, damage);
+
+            if (presented[i])
+            {
+                submitted.push_back(&swapChain);
+            }
+        }
+
+        //The device was lost by one of the windows, the frames of the others are gone with it
+        if (m_lostDevice)
+        {
+            return std::vector<bool>(frames.size(), false);
+        }
+
+        //One present for all windows, so they flip together and the present queue is entered once
+        if (SwapChainT::present(submitted) == VK_ERROR_DEVICE_LOST)
+        {
+            markDeviceLost("device lost while presenting");
+
+            return std::vector<bool>(frames.size(), false);
+        }
+
+        return presented;
+    }
+
+    template<bool ValidationLayersEnabled>
+    bool
+    Core<ValidationLayersEnabled>::drawFrameGraph(const FrameGraphBuilder& build, std::span<const VkRect2D> damage)
+    {
+        if (m_lostDevice)
+        {
+            return false;
+        }
+
+        auto& target = m_windows.front();
+        auto& swapChain = *target.swapChain;
+
+        m_instance->getDeletionQueue().beginFrame();
+
+        const bool submitted = submitFrame(target, [&](VkCommandBuffer commandBuffer, Index_t imageIndex)
+        {
+            m_frameGraph->reset();
+
+            //The acquire semaphore is waited on by the submit, the contents of the image are not kept
+            const auto backBuffer = m_frameGraph->importImage("BackBuffer",
+                                                              swapChain.getImage(imageIndex),
+                                                              swapChain.getImageView(imageIndex),
+                                                              FrameGraphTexture{ swapChain.getSwapChainExtent(), swapChain.getSwapChainImageFormat() },
+                                                              VK_IMAGE_LAYOUT_UNDEFINED,
+                                                              VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+            build(*m_frameGraph, backBuffer);
+
+            m_frameGraph->compile();
+            m_frameGraph->execute(commandBuffer);
+        }, damage);
+
+        if (!submitted)
+        {
+            return false;
+        }
+
+        SwapChainT* const swapChains[]{ &swapChain };
+
+        if (SwapChainT::present(swapChains) == VK_ERROR_DEVICE_LOST)
+        {
+            markDeviceLost("device lost while presenting");
+
+            return false;
+        }
+
+        return true;
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::resize(GLFWwindow* window, u32 width, u32 height)
+    {
+        const auto target = std::ranges::find(m_windows, window, &WindowTarget::window);
+
+        if (target != m_windows.end())
+        {
+            target->swapChain->requestRecreate(VkExtent2D{ width, height });
+        }
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::setFramePacing(FramePacingMode mode)
+    {
+        //Applied to the rebuilt device, the swapchains of the lost one are not presented anymore
+        if (m_lostDevice)
+        {
+            m_lostDevice->pacing = FramePacingPolicy::forMode(mode);
+
+            return;
+        }
+
+        //Only the main window paces, see attachWindow
+        if (!m_windows.empty())
+        {
+            m_windows.front().swapChain->setFramePacing(FramePacingPolicy::forMode(mode));
+        }
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::setDepthEnabled(bool enabled)
+    {
+        if (m_lostDevice)
+        {
+            m_lostDevice->depthEnabled = enabled;
+
+            return;
+        }
+
+        for (auto& target : m_windows)
+        {
+            target.swapChain->setDepthEnabled(enabled);
+        }
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::setSurfaceFormat(SurfaceFormatMode mode)
+    {
+        if (m_lostDevice)
+        {
+            const auto paperWhiteNits = m_lostDevice->surfaceFormat.paperWhiteNits;
+
+            m_lostDevice->surfaceFormat = SurfaceFormatPolicy::forMode(mode);
+            m_lostDevice->surfaceFormat.paperWhiteNits = paperWhiteNits;
+
+            return;
+        }
+
+        for (auto& target : m_windows)
+        {
+            auto surfaceFormat = SurfaceFormatPolicy::forMode(mode);
+
+            //The brightness was chosen for the display, not for the mode
+            surfaceFormat.paperWhiteNits = target.swapChain->surfaceFormatPolicy().paperWhiteNits;
+
+            target.swapChain->setSurfaceFormat(std::move(surfaceFormat));
+        }
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::setStatisticsOverlay(bool enabled)
+    {
+        if (m_lostDevice)
+        {
+            m_lostDevice->statisticsOverlay = enabled;
+        }
+
+        if (enabled == (m_statisticsOverlay != nullptr))
+        {
+            return;
+        }
+
+        m_statisticsOverlay = enabled ? std::make_unique<FrameStatisticsOverlay>() : nullptr;
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::markInput()
+    {
+        if (!m_windows.empty())
+        {
+            m_windows.front().swapChain->markInput();
+        }
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::setupHeadless()
+    {
+        m_instance->setupHeadless();
+
+        createPipelineServices();
+    }
+
+    template<bool ValidationLayersEnabled>
+    std::unique_ptr<OffscreenTarget<ValidationLayersEnabled>>
+    Core<ValidationLayersEnabled>::createOffscreenTarget(VkExtent2D extent)
+    {
+        auto target = std::make_unique<OffscreenTarget<ValidationLayersEnabled>>(m_instance, extent);
+
+        //Headless setups request the base pipeline for the first target, later ones render with compatible attachments
+        if (!m_pipeline->handle().isValid())
+        {
+            m_pipeline->retarget(*m_pipelineStateCache, [&target](PipelineConfigInfo& config) { target->configurePipeline(config); });
+
+            m_pipelineCompiler->setFallback(m_pipeline->handle());
+        }
+
+        return target;
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::createPipelineServices(std::span<const ShaderSource> retainedShaders)
+    {
+        m_gpuProfiler = std::make_unique<GpuProfiler>(m_instance->getGpu(),
+                                                      m_instance->getLogicalDevice(),
+                                                      m_instance->findPhysicalQueueFamilies().graphicsFamily.value(),
+                                                      //Sized for the largest ring, the pacing mode may change the number of frames in flight
+                                                      FramePacingPolicy::MaxFramesInFlight);
+
+        m_shaderRegistry = std::make_unique<ShaderRegistry>(m_instance->getLogicalDevice(), m_instance->getDeletionQueue());
+
+        m_pipelineLayoutCache = std::make_unique<PipelineLayoutCache>(m_instance->getLogicalDevice(),
+                                                                      m_instance->getDeletionQueue(),
+                                                                      m_instance->getDescriptorHeap());
+
+        m_pipelineCompiler = std::make_unique<PipelineCompiler>(m_instance->getLogicalDevice(),
+                                                                m_instance->getPipelineCache(),
+                                                                m_instance->getDeletionQueue(),
+                                                                m_instance->getDescriptorHeap().getPipelineLayout());
+
+        m_pipelineStateCache = std::make_unique<PipelineStateCache>(*m_pipelineCompiler, *m_shaderRegistry, *m_pipelineLayoutCache);
+
+        //Before init, the ShaderIds held by retained pipeline keys have to name the same modules again
+        if (!retainedShaders.empty())
+        {
+            m_shaderRegistry->restore(retainedShaders);
+        }
+
+        //Headless setups have no target yet, the base pipeline is then requested by createOffscreenTarget
+        typename PipelineT::Configure configure{};
+
+        if (!m_windows.empty())
+        {
+            const auto& swapChain = *m_windows.front().swapChain;
+
+            configure = [&swapChain](PipelineConfigInfo& config) { swapChain.configurePipeline(config); };
+
+            m_pipelineTargetVersion = swapChain.renderTargetVersion();
+        }
+
+        m_pipeline->init(*m_shaderRegistry, *m_pipelineStateCache, configure);
+
+        //The base pipeline is drawn while permutations requested later are still compiling
+        if (m_pipeline->handle().isValid())
+        {
+            m_pipelineCompiler->setFallback(m_pipeline->handle());
+        }
+
+        if (ShaderHotReload::isRequested())
+        {
+            m_shaderHotReload = std::make_unique<ShaderHotReload>(*m_shaderRegistry,
+                                                                  *m_pipelineStateCache,
+                                                                  *m_pipelineCompiler,
+                                                                  m_instance->getDeletionQueue(),
+                                                                  XK_SHADER_SOURCE_DIR,
+                                                                  XK_GLSL_COMPILER);
+        }
+    }
+
+    template<bool ValidationLayersEnabled>
+    bool
+    Core<ValidationLayersEnabled>::update()
+    {
+        //Both wait for the frame boundary, no frame of the lost device or surface is being recorded
+        if (m_lostDevice)
+        {
+            return recoverDevice();
+        }
+
+        bool changed{ false };
+
+        for (auto& target : m_windows)
+        {
+            if (target.swapChain->isSurfaceLost())
+            {
+                changed = recoverSurface(target) || changed;
+            }
+        }
+
+        if (m_shaderHotReload)
+        {
+            changed = m_shaderHotReload->update() || changed;
+        }
+
+        return changed;
+    }
+
+    template<bool ValidationLayersEnabled>
+    bool
+    Core<ValidationLayersEnabled>::isRecovering(WindowId id) const
+    {
+        if (m_lostDevice)
+        {
+            return true;
+        }
+
+        const auto target = std::ranges::find(m_windows, id, &WindowTarget::id);
+
+        return target != m_windows.end() && target->swapChain->isSurfaceLost();
+    }
+
+    template<bool ValidationLayersEnabled>
+    std::optional<typename Core<ValidationLayersEnabled>::RecoveryClock::time_point>
+    Core<ValidationLayersEnabled>::nextRecoveryAttempt() const
+    {
+        if (m_lostDevice)
+        {
+            return m_nextRecoveryAttempt;
+        }
+
+        std::optional<RecoveryClock::time_point> next{};
+
+        for (const auto& target : m_windows)
+        {
+            if (target.swapChain->isSurfaceLost() && (!next || target.nextSurfaceAttempt < *next))
+            {
+                next = target.nextSurfaceAttempt;
+            }
+        }
+
+        return next;
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::markDeviceLost(std::string_view reason)
+    {
+        if (m_lostDevice)
+        {
+            return;
+        }
+
+        log::error("{}, the device is rebuilt at the next update", reason);
+
+        //Captured now, the objects holding the descriptions are destroyed with the device
+        LostDevice lost{ .statisticsOverlay = m_statisticsOverlay != nullptr };
+
+        if (!m_windows.empty())
+        {
+            const auto& main = *m_windows.front().swapChain;
+
+            lost.pacing = main.framePacing();
+            lost.surfaceFormat = main.surfaceFormatPolicy();
+            lost.depthEnabled = main.depthEnabled();
+        }
+
+        for (const auto& target : m_windows)
+        {
+            if (target.id != MainWindowId)
+            {
+                lost.windows.emplace_back(target.id, target.window);
+            }
+        }
+
+        if (m_shaderRegistry)
+        {
+            lost.shaders = m_shaderRegistry->sources();
+        }
+
+        if (m_pipelineStateCache)
+        {
+            lost.pipelines = m_pipelineStateCache->keys();
+        }
+
+        m_lostDevice = std::move(lost);
+    }
+
+    template<bool ValidationLayersEnabled>
+    bool
+    Core<ValidationLayersEnabled>::recoverDevice()
+    {
+        const auto now = RecoveryClock::now();
+
+        if (now < m_nextRecoveryAttempt)
+        {
+            return false;
+        }
+
+        try
+        {
+            releaseDevice();
+            rebuildDevice(*m_lostDevice);
+        }
+        catch (const std::exception& exception)
+        {
+            //The driver may still be resetting, the next attempt starts over from the same description
+            log::error("Device recovery failed, retrying in {} ms: {}", RecoveryRetryInterval.count(), exception.what());
+
+            m_nextRecoveryAttempt = now + RecoveryRetryInterval;
+
+            return false;
+        }
+
+        m_lostDevice.reset();
+
+        return true;
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::releaseDevice()
+    {
+        //Reverse order of creation, everything goes before the GpuWrapper it was created on
+        m_shaderHotReload.reset();
+        m_pipelineStateCache.reset();
+        m_pipelineCompiler.reset();
+        m_pipelineLayoutCache.reset();
+        m_shaderRegistry.reset();
+        m_gpuProfiler.reset();
+        m_statisticsOverlay.reset();
+        m_frameGraph.reset();
+        m_pipeline.reset();
+
+        //Swapchains before their surfaces, the command buffers go with the command pool
+        while (!m_windows.empty())
+        {
+            auto& target = m_windows.back();
+
+            target.swapChain.reset();
+
+            if (target.id != MainWindowId)
+            {
+                m_instance->destroySurface(target.surface);
+            }
+
+            m_windows.pop_back();
+        }
+
+        m_instance.reset();
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    Core<ValidationLayersEnabled>::rebuildDevice(const LostDevice& lost)
+    {
+        //A new instance enumerates the GPUs again, after a driver reset or hot-plug it may pick another one
+        m_instance = InstanceT::createGpuWrapper();
+        m_pipeline = PipelineT::createPipeline(m_instance);
+
+        m_instance->setupForWindow(m_parentWindow);
+
+        m_windows.push_back(createMainWindowTarget(lost.pacing, lost.surfaceFormat));
+
+        m_windows.front().swapChain->setDepthEnabled(lost.depthEnabled);
+
+        for (const auto& [id, window] : lost.windows)
+        {
+            m_windows.push_back(createWindowTarget(id, window));
+        }
+
+        m_frameGraph = std::make_unique<FrameGraphT>(m_instance);
+
+        setStatisticsOverlay(lost.statisticsOverlay);
+
+        createPipelineServices(lost.shaders);
+
+        //Compiled by the PipelineCompiler in the background, frames draw with the fallback until they are ready
+        Size_t restored{ 0 };
+
+        for (const auto& key : lost.pipelines)
+        {
+            //Render passes and layouts of the lost device are gone, those pipelines are requested again by their users
+            if (key.renderPass != 0 || key.pipelineLayout != 0)
+            {
+                continue;
+            }
+
+            (void)m_pipelineStateCache->getHandle(key);
+
+            ++restored;
+        }
+
+        log::info("Device rebuilt, {} windows, {} shaders, {} of {} pipelines compiling in the background",
+                  m_windows.size(), lost.shaders.size(), restored, lost.pipelines.size());
+    }
+
+    template<bool ValidationLayersEnabled>
+    bool
+    Core<ValidationLayersEnabled>::recoverSurface(WindowTarget& target)
+    {
+        const auto now = RecoveryClock::now();
+
+        if (now < target.nextSurfaceAttempt)
+        {
+            return false;
+        }
+
+        try
+        {
+            target.swapChain->releaseSurface();
+
+            if (target.id == MainWindowId)
+            {
+                target.surface = m_instance->recreateSurface();
+
+                //The device was picked for the old surface, e.g. the window moved to a monitor of another GPU
+                if (!m_instance->isPresentSupported(target.surface))
+                {
+                    markDeviceLost("the present queue cannot present to the new surface of the main window");
+
+                    return false;
+                }
+            }
+            else
+            {
+                m_instance->destroySurface(target.surface);
+
+                target.surface = VK_NULL_HANDLE;
+                target.surface = createWindowSurface(target.window);
+            }
+
+            target.swapChain->setSurface(target.surface);
+        }
+        catch (const std::exception& exception)
+        {
+            //E.g. the monitor is still unplugged, the window keeps skipping frames until a later attempt succeeds
+            log::warning("Surface of window {} not recreated, retrying in {} ms: {}", target.id, RecoveryRetryInterval.count(), exception.what());
+
+            target.nextSurfaceAttempt = now + RecoveryRetryInterval;
+
+            return false;
+        }
+
+        log::info("Surface of window {} recreated", target.id);
+
+        return true;
     }
 
     template<bool ValidationLayersEnabled>
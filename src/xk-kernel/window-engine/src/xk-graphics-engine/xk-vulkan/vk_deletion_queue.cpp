@@ -0,0 +1,125 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <algorithm>
+
+#include <xk-graphics-engine/xk-vulkan/vk_deletion_queue.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    DeletionQueue::FrameNumber
+    DeletionQueue::beginFrame()
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        return ++m_currentFrame;
+    }
+
+    void
+    DeletionQueue::markSubmitted(FrameNumber frame)
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        ++m_inFlight[frame];
+    }
+
+    void
+    DeletionQueue::markCompleted(FrameNumber frame)
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        const auto inFlight = m_inFlight.find(frame);
+
+        if (inFlight != m_inFlight.end() && --inFlight->second == 0)
+        {
+            m_inFlight.erase(inFlight);
+        }
+    }
+
+    void
+    DeletionQueue::push(Deleter&& deleter)
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        if (m_buckets.empty() || m_buckets.back().frame != m_currentFrame)
+        {
+            m_buckets.push_back(Bucket{ .frame = m_currentFrame });
+        }
+
+        m_buckets.back().deleters.emplace_back(std::move(deleter));
+    }
+
+    void
+    DeletionQueue::collect(VkDevice device)
+    {
+        std::vector<Deleter> expired{};
+
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            //The current frame is still being recorded, an older one waits for the oldest submission in flight,
+            //a window that did not record in a frame does not hold it back
+            const auto end = m_inFlight.empty() ? m_currentFrame : std::min(m_currentFrame, m_inFlight.begin()->first);
+
+            while (!m_buckets.empty() && m_buckets.front().frame < end)
+            {
+                auto& deleters = m_buckets.front().deleters;
+
+                expired.insert(expired.end(), std::make_move_iterator(deleters.begin()), std::make_move_iterator(deleters.end()));
+
+                m_buckets.pop_front();
+            }
+        }
+
+        //Deleters run outside of the lock so they are free to retire further handles
+        for (auto& deleter : expired)
+        {
+            deleter(device);
+        }
+    }
+
+    void
+    DeletionQueue::flush(VkDevice device)
+    {
+        //Deleters may retire further handles (e.g. a pipeline releasing its layout), so we drain until empty
+        for (;;)
+        {
+            std::deque<Bucket> buckets{};
+
+            {
+                std::scoped_lock lock{ m_mutex };
+
+                buckets.swap(m_buckets);
+            }
+
+            if (buckets.empty())
+            {
+                break;
+            }
+
+            for (auto& bucket : buckets)
+            {
+                for (auto& deleter : bucket.deleters)
+                {
+                    deleter(device);
+                }
+            }
+        }
+    }
+
+    Size_t
+    DeletionQueue::pendingCount() const
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        Size_t count{ 0 };
+
+        for (const auto& bucket : m_buckets)
+        {
+            count += static_cast<Size_t>(bucket.deleters.size());
+        }
+
+        return count;
+    }
+}
@@ -0,0 +1,417 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <array>
+#include <algorithm>
+
+#include <utility/log.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_descriptor_heap.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    DescriptorIndexAllocator::DescriptorIndexAllocator(u32 capacity)
+        : m_capacity{ capacity }
+    {}
+
+    u32
+    DescriptorIndexAllocator::allocate()
+    {
+        if (!m_freeList.empty())
+        {
+            const auto index = m_freeList.back();
+
+            m_freeList.pop_back();
+
+            return index;
+        }
+
+        if (m_next == m_capacity)
+        {
+            return InvalidIndex;
+        }
+
+        return m_next++;
+    }
+
+    void
+    DescriptorIndexAllocator::release(u32 index)
+    {
+        m_freeList.push_back(index);
+    }
+
+    DescriptorHeap::DescriptorHeap(VkPhysicalDevice gpu, VkDevice device, DeletionQueue& deletionQueue, DescriptorHeapCapacity capacity)
+        : m_device{ device }
+        , m_deletionQueue{ deletionQueue }
+        , m_capacity{ capacity }
+    {
+        VkPhysicalDeviceDescriptorIndexingProperties indexingProperties
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES
+        };
+
+        VkPhysicalDeviceProperties2 properties
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &indexingProperties
+        };
+
+        vkGetPhysicalDeviceProperties2(gpu, &properties);
+
+        //Requested sizes are clamped by what the device allows in a single update-after-bind set
+        m_capacity.sampledImages = std::min(m_capacity.sampledImages, indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages);
+        m_capacity.storageBuffers = std::min(m_capacity.storageBuffers, indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers);
+        m_capacity.samplers = std::min(m_capacity.samplers, indexingProperties.maxDescriptorSetUpdateAfterBindSamplers);
+
+        m_sampledImages = DescriptorIndexAllocator{ m_capacity.sampledImages };
+        m_storageBuffers = DescriptorIndexAllocator{ m_capacity.storageBuffers };
+        m_samplers = DescriptorIndexAllocator{ m_capacity.samplers };
+
+        log::info("Descriptor heap: {} sampled images, {} storage buffers, {} samplers", m_capacity.sampledImages, m_capacity.storageBuffers, m_capacity.samplers);
+
+        createSetLayout();
+        createPool();
+        allocateSet();
+        createPipelineLayout();
+    }
+
+    DescriptorHeap::~DescriptorHeap()
+    {
+        //Called on shutdown after the device went idle, the set is freed together with its pool
+        vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+        vkDestroyDescriptorPool(m_device, m_pool, nullptr);
+        vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+    }
+
+    bool
+    DescriptorHeap::isSupported(VkPhysicalDevice gpu)
+    {
+        VkPhysicalDeviceProperties properties{};
+
+        vkGetPhysicalDeviceProperties(gpu, &properties);
+
+        //The features are enabled through VkPhysicalDeviceVulkan12Features, which a 1.1 device does not accept
+        if (properties.apiVersion < VK_API_VERSION_1_2)
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceVulkan12Features vulkan12Features
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES
+        };
+
+        VkPhysicalDeviceFeatures2 features
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &vulkan12Features
+        };
+
+        vkGetPhysicalDeviceFeatures2(gpu, &features);
+
+        //Every feature GpuWrapper::createLogicalDevice enables for the heap
+        return vulkan12Features.descriptorIndexing
+            && vulkan12Features.runtimeDescriptorArray
+            && vulkan12Features.descriptorBindingPartiallyBound
+            && vulkan12Features.descriptorBindingSampledImageUpdateAfterBind
+            && vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind
+            && vulkan12Features.descriptorBindingUpdateUnusedWhilePending
+            && vulkan12Features.shaderSampledImageArrayNonUniformIndexing
+            && vulkan12Features.shaderStorageBufferArrayNonUniformIndexing;
+    }
+
+    void
+    DescriptorHeap::createSetLayout()
+    {
+        static constexpr auto AllStages = VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT;
+
+        const std::array bindings
+        {
+            VkDescriptorSetLayoutBinding
+            {
+                .binding = SampledImageBinding,
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                .descriptorCount = m_capacity.sampledImages,
+                .stageFlags = AllStages
+            },
+            VkDescriptorSetLayoutBinding
+            {
+                .binding = StorageBufferBinding,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .descriptorCount = m_capacity.storageBuffers,
+                .stageFlags = AllStages
+            },
+            VkDescriptorSetLayoutBinding
+            {
+                .binding = SamplerBinding,
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+                .descriptorCount = m_capacity.samplers,
+                .stageFlags = AllStages
+            }
+        };
+
+        static constexpr VkDescriptorBindingFlags BindingFlags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+                                                                 | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+                                                                 | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+        const std::array<VkDescriptorBindingFlags, bindings.size()> bindingFlags{ BindingFlags, BindingFlags, BindingFlags };
+
+        const VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+            .bindingCount = static_cast<u32>(bindingFlags.size()),
+            .pBindingFlags = bindingFlags.data()
+        };
+
+        const VkDescriptorSetLayoutCreateInfo layoutInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext = &bindingFlagsInfo,
+            .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+            .bindingCount = static_cast<u32>(bindings.size()),
+            .pBindings = bindings.data()
+        };
+
+        if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS)
+        {
+            throw Exception::DescriptorError("failed to create bindless descriptor set layout");
+        }
+    }
+
+    void
+    DescriptorHeap::createPool()
+    {
+        const std::array poolSizes
+        {
+            VkDescriptorPoolSize{ .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, .descriptorCount = m_capacity.sampledImages },
+            VkDescriptorPoolSize{ .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = m_capacity.storageBuffers },
+            VkDescriptorPoolSize{ .type = VK_DESCRIPTOR_TYPE_SAMPLER, .descriptorCount = m_capacity.samplers }
+        };
+
+        const VkDescriptorPoolCreateInfo poolInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+            .maxSets = 1,
+            .poolSizeCount = static_cast<u32>(poolSizes.size()),
+            .pPoolSizes = poolSizes.data()
+        };
+
+        if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_pool) != VK_SUCCESS)
+        {
+            throw Exception::DescriptorError("failed to create bindless descriptor pool");
+        }
+    }
+
+    void
+    DescriptorHeap::allocateSet()
+    {
+        const VkDescriptorSetAllocateInfo allocInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool = m_pool,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &m_setLayout
+        };
+
+        if (vkAllocateDescriptorSets(m_device, &allocInfo, &m_set) != VK_SUCCESS)
+        {
+            throw Exception::DescriptorError("failed to allocate bindless descriptor set");
+        }
+    }
+
+    void
+    DescriptorHeap::createPipelineLayout()
+    {
+        const VkPushConstantRange pushConstantRange
+        {
+            .stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset = 0,
+            .size = PushConstantSize
+        };
+
+        const VkPipelineLayoutCreateInfo layoutInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 1,
+            .pSetLayouts = &m_setLayout,
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pushConstantRange
+        };
+
+        if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
+        {
+            throw Exception::DescriptorError("failed to create shared pipeline layout");
+        }
+    }
+
+    DescriptorHeap::Index
+    DescriptorHeap::registerSampledImage(VkImageView imageView, VkImageLayout layout)
+    {
+        Index index{ InvalidIndex };
+
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            index = m_sampledImages.allocate();
+        }
+
+        if (index == InvalidIndex)
+        {
+            throw Exception::DescriptorError("sampled image heap is full");
+        }
+
+        updateSampledImage(index, imageView, layout);
+
+        return index;
+    }
+
+    DescriptorHeap::Index
+    DescriptorHeap::registerStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+    {
+        Index index{ InvalidIndex };
+
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            index = m_storageBuffers.allocate();
+        }
+
+        if (index == InvalidIndex)
+        {
+            throw Exception::DescriptorError("storage buffer heap is full");
+        }
+
+        updateStorageBuffer(index, buffer, offset, range);
+
+        return index;
+    }
+
+    DescriptorHeap::Index
+    DescriptorHeap::registerSampler(VkSampler sampler)
+    {
+        Index index{ InvalidIndex };
+
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            index = m_samplers.allocate();
+        }
+
+        if (index == InvalidIndex)
+        {
+            throw Exception::DescriptorError("sampler heap is full");
+        }
+
+        const VkDescriptorImageInfo imageInfo
+        {
+            .sampler = sampler
+        };
+
+        const VkWriteDescriptorSet write
+        {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = m_set,
+            .dstBinding = SamplerBinding,
+            .dstArrayElement = index,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+            .pImageInfo = &imageInfo
+        };
+
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+
+        return index;
+    }
+
+    void
+    DescriptorHeap::updateSampledImage(Index index, VkImageView imageView, VkImageLayout layout)
+    {
+        const VkDescriptorImageInfo imageInfo
+        {
+            .imageView = imageView,
+            .imageLayout = layout
+        };
+
+        const VkWriteDescriptorSet write
+        {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = m_set,
+            .dstBinding = SampledImageBinding,
+            .dstArrayElement = index,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            .pImageInfo = &imageInfo
+        };
+
+        //Update-after-bind lets us write while the set is bound by frames in flight
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    }
+
+    void
+    DescriptorHeap::updateStorageBuffer(Index index, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+    {
+        const VkDescriptorBufferInfo bufferInfo
+        {
+            .buffer = buffer,
+            .offset = offset,
+            .range = range
+        };
+
+        const VkWriteDescriptorSet write
+        {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = m_set,
+            .dstBinding = StorageBufferBinding,
+            .dstArrayElement = index,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &bufferInfo
+        };
+
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    }
+
+    void
+    DescriptorHeap::deferRelease(DescriptorIndexAllocator& allocator, u32 index)
+    {
+        if (index == InvalidIndex)
+        {
+            return;
+        }
+
+        //The slot returns to the free list only once no frame in flight can index it anymore
+        m_deletionQueue.push([this, &allocator, index](VkDevice)
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            allocator.release(index);
+        });
+    }
+
+    void
+    DescriptorHeap::releaseSampledImage(Index index)
+    {
+        deferRelease(m_sampledImages, index);
+    }
+
+    void
+    DescriptorHeap::releaseStorageBuffer(Index index)
+    {
+        deferRelease(m_storageBuffers, index);
+    }
+
+    void
+    DescriptorHeap::releaseSampler(Index index)
+    {
+        deferRelease(m_samplers, index);
+    }
+
+    void
+    DescriptorHeap::bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint) const
+    {
+        vkCmdBindDescriptorSets(commandBuffer, bindPoint, m_pipelineLayout, 0, 1, &m_set, 0, nullptr);
+    }
+}
@@ -0,0 +1,189 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <array>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+#include <xk-graphics-engine/xk-vulkan/vk_dynamic_rendering.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    bool
+    DynamicRendering::isSupported(VkPhysicalDevice gpu)
+    {
+        u32 extensionCount{ 0 };
+
+        vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount, nullptr);
+
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+
+        vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount, extensions.data());
+
+        const bool hasExtension = std::ranges::any_of(extensions, [](const auto& extension)
+        {
+            return std::string_view{ extension.extensionName } == VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME;
+        });
+
+        if (!hasExtension)
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR
+        };
+
+        VkPhysicalDeviceFeatures2 features
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &dynamicRenderingFeatures
+        };
+
+        vkGetPhysicalDeviceFeatures2(gpu, &features);
+
+        return dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+    }
+
+    bool
+    DynamicRendering::isDisabled()
+    {
+        const char* environment = std::getenv(EnvironmentVariable.data());
+
+        return environment != nullptr && std::string_view{ environment } == "renderpass";
+    }
+
+    DynamicRendering::DynamicRendering(VkDevice device)
+        : m_cmdBeginRendering{ reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(vkGetDeviceProcAddr(device, "vkCmdBeginRenderingKHR")) }
+        , m_cmdEndRendering{ reinterpret_cast<PFN_vkCmdEndRenderingKHR>(vkGetDeviceProcAddr(device, "vkCmdEndRenderingKHR")) }
+    {
+        if (m_cmdBeginRendering == nullptr || m_cmdEndRendering == nullptr)
+        {
+            throw Exception::InstanceError("dynamic rendering is enabled but its entry points are missing");
+        }
+    }
+
+    void
+    DynamicRendering::begin(VkCommandBuffer commandBuffer, const RenderTarget& target) const
+    {
+        const bool hasDepth{ target.depthView != VK_NULL_HANDLE };
+
+        //The contents are cleared, so the previous layout does not matter
+        const std::array<VkImageMemoryBarrier, 2> barriers
+        {
+            VkImageMemoryBarrier
+            {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = 0,
+                .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = target.colorImage,
+                .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+            },
+            VkImageMemoryBarrier
+            {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = target.depthImage,
+                .subresourceRange = { target.depthAspect, 0, 1, 0, 1 }
+            }
+        };
+
+        //Same stages as the external dependency of the render pass path
+        vkCmdPipelineBarrier(commandBuffer,
+                             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                             0,
+                             0, nullptr,
+                             0, nullptr,
+                             hasDepth ? 2u : 1u, barriers.data());
+
+        beginRendering(commandBuffer, target);
+    }
+
+    void
+    DynamicRendering::beginRendering(VkCommandBuffer commandBuffer, const RenderTarget& target) const
+    {
+        const bool hasDepth{ target.depthView != VK_NULL_HANDLE };
+
+        const VkRenderingAttachmentInfoKHR colorAttachment
+        {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+            .imageView = target.colorView,
+            .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .clearValue = { .color = target.clearColor }
+        };
+
+        const VkRenderingAttachmentInfoKHR depthAttachment
+        {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+            .imageView = target.depthView,
+            .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .clearValue = { .depthStencil = { 1.0f, 0 } }
+        };
+
+        const VkRenderingInfoKHR renderingInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+            .renderArea = { { 0, 0 }, target.extent },
+            .layerCount = 1,
+            .colorAttachmentCount = 1,
+            .pColorAttachments = &colorAttachment,
+            .pDepthAttachment = hasDepth ? &depthAttachment : nullptr
+        };
+
+        m_cmdBeginRendering(commandBuffer, &renderingInfo);
+    }
+
+    void
+    DynamicRendering::endRendering(VkCommandBuffer commandBuffer) const
+    {
+        m_cmdEndRendering(commandBuffer);
+    }
+
+    void
+    DynamicRendering::end(VkCommandBuffer commandBuffer, const RenderTarget& target) const
+    {
+        endRendering(commandBuffer);
+
+        //Offscreen targets copy the image out right after, presentation needs no access
+        const bool isCopySource{ target.finalLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL };
+
+        const VkImageMemoryBarrier barrier
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask = isCopySource ? VkAccessFlags{ VK_ACCESS_TRANSFER_READ_BIT } : VkAccessFlags{ 0 },
+            .oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .newLayout = target.finalLayout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = target.colorImage,
+            .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+        };
+
+        vkCmdPipelineBarrier(commandBuffer,
+                             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                             isCopySource ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             0,
+                             0, nullptr,
+                             0, nullptr,
+                             1, &barrier);
+    }
+}
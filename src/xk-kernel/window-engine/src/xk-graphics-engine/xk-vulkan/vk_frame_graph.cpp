@@ -0,0 +1,822 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <iterator>
+#include <algorithm>
+
+#include <utility/log.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_frame_graph.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    namespace
+    {
+        struct AccessInfo
+        {
+            VkPipelineStageFlags    stages{ 0 };
+            VkAccessFlags           access{ 0 };
+            VkImageLayout           layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+            VkImageUsageFlags       usage{ 0 };
+        };
+
+        constexpr VkAccessFlags WriteAccessMask{ VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                                VK_ACCESS_SHADER_WRITE_BIT |
+                                                VK_ACCESS_TRANSFER_WRITE_BIT };
+
+        constexpr VkImageUsageFlags AttachmentUsageMask{ VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                                         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                                         VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT };
+
+        AccessInfo accessInfo(ResourceAccess access)
+        {
+            switch (access)
+            {
+                case ResourceAccess::ColorAttachment:
+                {
+                    return { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                             VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                             VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT };
+                }
+                case ResourceAccess::DepthAttachment:
+                {
+                    return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                             VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+                }
+                case ResourceAccess::DepthRead:
+                {
+                    return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                             VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+                }
+                case ResourceAccess::SampledFragment:
+                {
+                    return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             VK_ACCESS_SHADER_READ_BIT,
+                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                             VK_IMAGE_USAGE_SAMPLED_BIT };
+                }
+                case ResourceAccess::SampledCompute:
+                {
+                    return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_ACCESS_SHADER_READ_BIT,
+                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                             VK_IMAGE_USAGE_SAMPLED_BIT };
+                }
+                case ResourceAccess::StorageRead:
+                {
+                    return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_ACCESS_SHADER_READ_BIT,
+                             VK_IMAGE_LAYOUT_GENERAL,
+                             VK_IMAGE_USAGE_STORAGE_BIT };
+                }
+                case ResourceAccess::StorageWrite:
+                {
+                    return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                             VK_IMAGE_LAYOUT_GENERAL,
+                             VK_IMAGE_USAGE_STORAGE_BIT };
+                }
+                case ResourceAccess::TransferSource:
+                {
+                    return { VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_ACCESS_TRANSFER_READ_BIT,
+                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                             VK_IMAGE_USAGE_TRANSFER_SRC_BIT };
+                }
+                case ResourceAccess::TransferDestination:
+                default:
+                {
+                    return { VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_ACCESS_TRANSFER_WRITE_BIT,
+                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             VK_IMAGE_USAGE_TRANSFER_DST_BIT };
+                }
+            }
+        }
+
+        VkImageAspectFlags aspectOf(VkFormat format)
+        {
+            switch (format)
+            {
+                case VK_FORMAT_D16_UNORM:
+                case VK_FORMAT_X8_D24_UNORM_PACK32:
+                case VK_FORMAT_D32_SFLOAT:
+                {
+                    return VK_IMAGE_ASPECT_DEPTH_BIT;
+                }
+                case VK_FORMAT_D16_UNORM_S8_UINT:
+                case VK_FORMAT_D24_UNORM_S8_UINT:
+                case VK_FORMAT_D32_SFLOAT_S8_UINT:
+                {
+                    return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+                }
+                case VK_FORMAT_S8_UINT:
+                {
+                    return VK_IMAGE_ASPECT_STENCIL_BIT;
+                }
+                default:
+                {
+                    return VK_IMAGE_ASPECT_COLOR_BIT;
+                }
+            }
+        }
+
+        u64 mix(u64 hash, u64 value)
+        {
+            //FNV-1a over whole values, the signature only has to tell two frames apart
+            return (hash ^ value) * 1099511628211ull;
+        }
+    }
+
+    bool
+    isWriteAccess(ResourceAccess access)
+    {
+        return (accessInfo(access).access & WriteAccessMask) != 0;
+    }
+
+    template<bool ValidationEnabled>
+    FrameGraph<ValidationEnabled>::PassBuilder::PassBuilder(FrameGraph& graph, Index_t pass)
+        : m_graph{ graph }
+        , m_pass{ pass }
+    {
+    }
+
+    template<bool ValidationEnabled>
+    typename FrameGraph<ValidationEnabled>::ResourceId
+    FrameGraph<ValidationEnabled>::PassBuilder::create(std::string_view name, const FrameGraphTexture& texture)
+    {
+        if (texture.extent.width == 0 || texture.extent.height == 0 || texture.format == VK_FORMAT_UNDEFINED)
+        {
+            throw Exception::FrameGraphError(std::string{ name } + " has no size or format");
+        }
+
+        m_graph.m_resources.push_back(Resource
+        {
+            .name = std::string{ name },
+            .texture = texture
+        });
+
+        return static_cast<ResourceId>(m_graph.m_resources.size() - 1);
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::checkUnused(const Pass& pass, ResourceId id) const
+    {
+        auto isSame = [&](const Use& use) { return use.resource == id; };
+
+        if (std::ranges::any_of(pass.reads, isSame) || std::ranges::any_of(pass.writes, isSame))
+        {
+            throw Exception::FrameGraphError(pass.name + " uses " + resource(id).name + " more than once");
+        }
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::PassBuilder::read(ResourceId resource, ResourceAccess access)
+    {
+        auto& pass = m_graph.m_passes[m_pass];
+
+        if (isWriteAccess(access))
+        {
+            throw Exception::FrameGraphError(pass.name + " reads " + m_graph.resource(resource).name + " with a write access");
+        }
+
+        m_graph.checkUnused(pass, resource);
+
+        pass.reads.push_back({ resource, access });
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::PassBuilder::write(ResourceId resource, ResourceAccess access)
+    {
+        auto& pass = m_graph.m_passes[m_pass];
+
+        if (!isWriteAccess(access))
+        {
+            throw Exception::FrameGraphError(pass.name + " writes " + m_graph.resource(resource).name + " with a read access");
+        }
+
+        m_graph.checkUnused(pass, resource);
+
+        pass.writes.push_back({ resource, access });
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::PassBuilder::keep()
+    {
+        m_graph.m_passes[m_pass].kept = true;
+    }
+
+    template<bool ValidationEnabled>
+    FrameGraph<ValidationEnabled>::Resources::Resources(const FrameGraph& graph)
+        : m_graph{ graph }
+    {
+    }
+
+    template<bool ValidationEnabled>
+    VkImage
+    FrameGraph<ValidationEnabled>::Resources::image(ResourceId resource) const
+    {
+        return m_graph.resource(resource).image;
+    }
+
+    template<bool ValidationEnabled>
+    VkImageView
+    FrameGraph<ValidationEnabled>::Resources::view(ResourceId resource) const
+    {
+        return m_graph.resource(resource).view;
+    }
+
+    template<bool ValidationEnabled>
+    const FrameGraphTexture&
+    FrameGraph<ValidationEnabled>::Resources::texture(ResourceId resource) const
+    {
+        return m_graph.resource(resource).texture;
+    }
+
+    template<bool ValidationEnabled>
+    FrameGraph<ValidationEnabled>::FrameGraph(std::shared_ptr<InstanceT> gpuWrapper)
+        : m_gpuWrapper{ std::move(gpuWrapper) }
+    {
+    }
+
+    template<bool ValidationEnabled>
+    FrameGraph<ValidationEnabled>::~FrameGraph()
+    {
+        retireTransients();
+    }
+
+    template<bool ValidationEnabled>
+    typename FrameGraph<ValidationEnabled>::ResourceId
+    FrameGraph<ValidationEnabled>::importImage(std::string_view name, VkImage image, VkImageView view, const FrameGraphTexture& texture, VkImageLayout initialLayout, VkImageLayout finalLayout)
+    {
+        m_resources.push_back(Resource
+        {
+            .name = std::string{ name },
+            .texture = texture,
+            .imported = true,
+            .image = image,
+            .view = view,
+            .initialLayout = initialLayout,
+            .finalLayout = finalLayout
+        });
+
+        m_compiled = false;
+
+        return static_cast<ResourceId>(m_resources.size() - 1);
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::addPass(std::string_view name, const Setup& setup, Execute execute)
+    {
+        m_passes.push_back(Pass
+        {
+            .name = std::string{ name },
+            .execute = std::move(execute)
+        });
+
+        PassBuilder builder{ *this, static_cast<Index_t>(m_passes.size() - 1) };
+
+        setup(builder);
+
+        m_compiled = false;
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::compile()
+    {
+        m_statistics = {};
+
+        cull();
+
+        m_order.clear();
+
+        for (Index_t i{ 0 }; i < m_passes.size(); ++i)
+        {
+            if (!m_passes[i].culled)
+            {
+                m_order.push_back(i);
+            }
+        }
+
+        //Lifetimes and usage only count surviving passes, a culled reader neither extends nor shapes a texture
+        for (Index_t position{ 0 }; position < m_order.size(); ++position)
+        {
+            const auto& pass = m_passes[m_order[position]];
+
+            for (const auto& uses : { std::cref(pass.reads), std::cref(pass.writes) })
+            {
+                for (const auto& use : uses.get())
+                {
+                    auto& used = resource(use.resource);
+
+                    used.usage |= accessInfo(use.access).usage;
+                    used.firstUse = std::min(used.firstUse, position);
+                    used.lastUse = std::max(used.lastUse, position);
+                }
+            }
+        }
+
+        //An attachment living in a single pass is never loaded or stored, tiled GPUs keep it in tile memory
+        for (auto& used : m_resources)
+        {
+            if (!used.imported && used.firstUse == used.lastUse && (used.usage & ~AttachmentUsageMask) == 0)
+            {
+                used.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+            }
+        }
+
+        allocateTransients();
+
+        computeBarriers(m_order);
+
+        m_statistics.passes = static_cast<Size_t>(m_passes.size());
+        m_statistics.culledPasses = static_cast<Size_t>(m_passes.size() - m_order.size());
+
+        m_compiled = true;
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::cull()
+    {
+        std::vector<FrameGraphPlan::Pass> passes(m_passes.size());
+        std::vector<FrameGraphPlan::Resource> resources(m_resources.size());
+
+        for (Index_t i{ 0 }; i < m_passes.size(); ++i)
+        {
+            const auto& pass = m_passes[i];
+
+            std::ranges::transform(pass.reads, std::back_inserter(passes[i].reads), &Use::resource);
+            std::ranges::transform(pass.writes, std::back_inserter(passes[i].writes), &Use::resource);
+
+            passes[i].kept = pass.kept;
+        }
+
+        for (ResourceId id{ 0 }; id < m_resources.size(); ++id)
+        {
+            resources[id].imported = m_resources[id].imported;
+        }
+
+        const auto culled = FrameGraphPlan::cull(passes, resources);
+
+        for (Index_t i{ 0 }; i < m_passes.size(); ++i)
+        {
+            m_passes[i].culled = culled[i];
+        }
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::allocateTransients()
+    {
+        std::vector<ResourceId> transients{};
+
+        u64 signature{ EmptySignature };
+
+        for (ResourceId id{ 0 }; id < m_resources.size(); ++id)
+        {
+            const auto& transient = m_resources[id];
+
+            if (transient.imported || transient.firstUse == Bad<Index_t>())
+            {
+                continue;
+            }
+
+            transients.push_back(id);
+
+            signature = mix(signature, transient.texture.format);
+            signature = mix(signature, (u64{ transient.texture.extent.width } << 32) | transient.texture.extent.height);
+            signature = mix(signature, transient.usage);
+            signature = mix(signature, (u64{ transient.firstUse } << 32) | transient.lastUse);
+        }
+
+        const auto assign = [&]()
+        {
+            for (Index_t i{ 0 }; i < transients.size(); ++i)
+            {
+                auto& transient = resource(transients[i]);
+
+                transient.image = m_transients.images[i];
+                transient.view = m_transients.views[i];
+                transient.block = m_transients.blocks[i];
+            }
+
+            m_statistics.transientTextures = static_cast<Size_t>(transients.size());
+            m_statistics.transientAllocations = static_cast<Size_t>(m_transients.memory.size());
+            m_statistics.unaliasedBytes = m_transients.unaliasedBytes;
+
+            for (const auto& block : m_transients.memory)
+            {
+                m_statistics.transientBytes += block.requirements.size;
+            }
+        };
+
+        //The common case, the same passes as in the previous frame
+        if (signature == m_transients.signature && m_transients.images.size() == transients.size())
+        {
+            assign();
+
+            return;
+        }
+
+        retireTransients();
+
+        const auto device = m_gpuWrapper->getLogicalDevice();
+
+        std::vector<VkMemoryRequirements> requirements(transients.size());
+
+        for (Index_t i{ 0 }; i < transients.size(); ++i)
+        {
+            const auto& transient = resource(transients[i]);
+
+            const VkImageCreateInfo imageInfo
+            {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                .imageType = VK_IMAGE_TYPE_2D,
+                .format = transient.texture.format,
+                .extent = { transient.texture.extent.width, transient.texture.extent.height, 1 },
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .tiling = VK_IMAGE_TILING_OPTIMAL,
+                .usage = transient.usage,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+            };
+
+            VkImage image{ VK_NULL_HANDLE };
+
+            if (vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS)
+            {
+                throw Exception::FrameGraphError("failed to create transient " + transient.name);
+            }
+
+            m_transients.images.push_back(image);
+
+            vkGetImageMemoryRequirements(device, image, &requirements[i]);
+
+            m_transients.unaliasedBytes += requirements[i].size;
+        }
+
+        std::vector<FrameGraphPlan::Transient> placements(transients.size());
+
+        for (Index_t i{ 0 }; i < transients.size(); ++i)
+        {
+            const auto& transient = resource(transients[i]);
+
+            placements[i] =
+            {
+                .requirements = requirements[i],
+                .lifetime = { transient.firstUse, transient.lastUse },
+                .lazy = (transient.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0
+            };
+        }
+
+        auto aliasing = FrameGraphPlan::alias(placements);
+
+        for (auto& block : aliasing.blocks)
+        {
+            m_transients.memory.push_back(MemoryBlock{ .requirements = block.requirements, .lifetimes = std::move(block.lifetimes), .lazy = block.lazy });
+        }
+
+        m_transients.blocks = std::move(aliasing.blockOf);
+
+        for (auto& block : m_transients.memory)
+        {
+            const auto properties = block.lazy ? m_gpuWrapper->transientMemoryProperties(block.requirements.memoryTypeBits) : VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+
+            block.memory = m_gpuWrapper->allocateMemory(block.requirements, properties, MemoryCategory::Transient);
+        }
+
+        for (Index_t i{ 0 }; i < transients.size(); ++i)
+        {
+            const auto& transient = resource(transients[i]);
+
+            vkBindImageMemory(device, m_transients.images[i], m_transients.memory[m_transients.blocks[i]].memory, 0);
+
+            const VkImageViewCreateInfo viewInfo
+            {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                .image = m_transients.images[i],
+                .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                .format = transient.texture.format,
+                .subresourceRange = { aspectOf(transient.texture.format), 0, 1, 0, 1 }
+            };
+
+            VkImageView view{ VK_NULL_HANDLE };
+
+            if (vkCreateImageView(device, &viewInfo, nullptr, &view) != VK_SUCCESS)
+            {
+                throw Exception::FrameGraphError("failed to create the view of transient " + transient.name);
+            }
+
+            m_transients.views.push_back(view);
+        }
+
+        m_transients.signature = signature;
+
+        assign();
+
+        log::debug("Frame graph: {} transient textures in {} allocations, {:.1f} MiB instead of {:.1f} MiB",
+                   m_statistics.transientTextures,
+                   m_statistics.transientAllocations,
+                   static_cast<f64>(m_statistics.transientBytes) / (1024.0 * 1024.0),
+                   static_cast<f64>(m_statistics.unaliasedBytes) / (1024.0 * 1024.0));
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::retireTransients()
+    {
+        if (m_transients.images.empty() && m_transients.memory.empty())
+        {
+            m_transients = {};
+
+            return;
+        }
+
+        auto& deletionQueue = m_gpuWrapper->getDeletionQueue();
+
+        //Frames in flight may still render into them
+        for (auto view : m_transients.views)
+        {
+            deletionQueue.destroyLater(view);
+        }
+
+        for (auto image : m_transients.images)
+        {
+            deletionQueue.destroyLater(image);
+        }
+
+        for (const auto& block : m_transients.memory)
+        {
+            m_gpuWrapper->releaseMemory(block.memory);
+        }
+
+        m_transients = {};
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::computeBarriers(const std::vector<Index_t>& order)
+    {
+        struct State
+        {
+            VkImageLayout           layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+
+            //Last write and the stages it has been made visible to since
+            VkPipelineStageFlags    writeStages{ 0 };
+            VkAccessFlags           writeAccess{ 0 };
+            VkPipelineStageFlags    visibleStages{ 0 };
+
+            //Reads since the last write, a later write has to wait for them
+            VkPipelineStageFlags    readStages{ 0 };
+
+            bool                    written{ false };
+
+            //Aliased memory, picks up the state of the block at its first use in this frame
+            bool                    aliased{ false };
+        };
+
+        std::vector<State> states(m_resources.size());
+
+        for (ResourceId id{ 0 }; id < m_resources.size(); ++id)
+        {
+            const auto& used = m_resources[id];
+
+            if (used.imported)
+            {
+                //Nothing is known about the work before the graph, the first use waits for all of it
+                states[id] = State{ .layout = used.initialLayout, .writeStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, .writeAccess = VK_ACCESS_MEMORY_WRITE_BIT, .written = true };
+            }
+            else if (used.block != Bad<Index_t>())
+            {
+                states[id] = State{ .layout = VK_IMAGE_LAYOUT_UNDEFINED, .aliased = true };
+            }
+        }
+
+        auto barrierFor = [](const Resource& used, const State& state, const AccessInfo& info)
+        {
+            return VkImageMemoryBarrier
+            {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = state.writeAccess,
+                .dstAccessMask = info.access,
+                .oldLayout = state.layout,
+                .newLayout = info.layout,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = used.image,
+                .subresourceRange = { aspectOf(used.texture.format), 0, 1, 0, 1 }
+            };
+        };
+
+        for (const auto passIndex : order)
+        {
+            auto& pass = m_passes[passIndex];
+
+            pass.barriers.clear();
+            pass.srcStages = 0;
+            pass.dstStages = 0;
+
+            for (const auto& uses : { std::cref(pass.reads), std::cref(pass.writes) })
+            {
+                for (const auto& use : uses.get())
+                {
+                    const auto& used = resource(use.resource);
+                    auto& state = states[use.resource];
+
+                    if (state.aliased)
+                    {
+                        //Read now rather than up front, the block holds the last use of the previous occupant in this frame
+                        //or of the previous frame when this is the first one
+                        const auto& block = m_transients.memory[used.block];
+
+                        state.writeStages = block.lastStages;
+                        state.writeAccess = block.lastAccess;
+                        state.aliased = false;
+                    }
+
+                    const auto info = accessInfo(use.access);
+                    const bool isWrite{ isWriteAccess(use.access) };
+
+                    if (!isWrite && !used.imported && !state.written)
+                    {
+                        throw Exception::FrameGraphError(pass.name + " reads " + used.name + " before any pass wrote it");
+                    }
+
+                    const bool changesLayout{ state.layout != info.layout };
+
+                    //Reads of a visible write in the same layout need nothing, everything else does
+                    const bool hazard = isWrite ? (state.writeStages | state.readStages) != 0
+                                                : state.writeStages != 0 && (info.stages & ~state.visibleStages) != 0;
+
+                    if (changesLayout || hazard)
+                    {
+                        //A transition rewrites the image, so it also has to wait for the reads before it
+                        pass.srcStages |= state.writeStages | ((isWrite || changesLayout) ? state.readStages : 0);
+                        pass.dstStages |= info.stages;
+
+                        pass.barriers.push_back(barrierFor(used, state, info));
+
+                        if (changesLayout)
+                        {
+                            state.readStages = 0;
+                            state.visibleStages = info.stages;
+                        }
+                        else
+                        {
+                            state.visibleStages |= info.stages;
+                        }
+                    }
+
+                    if (isWrite)
+                    {
+                        state.writeStages = info.stages;
+                        state.writeAccess = info.access & WriteAccessMask;
+                        state.visibleStages = 0;
+                        state.readStages = 0;
+                        state.written = true;
+                    }
+                    else
+                    {
+                        state.readStages |= info.stages;
+                    }
+
+                    state.layout = info.layout;
+
+                    if (!used.imported)
+                    {
+                        auto& block = m_transients.memory[used.block];
+
+                        block.lastStages = state.writeStages | state.readStages;
+                        block.lastAccess = state.writeAccess;
+                    }
+                }
+            }
+
+            if (!pass.barriers.empty())
+            {
+                ++m_statistics.barriers;
+            }
+        }
+
+        m_finalBarriers.clear();
+        m_finalSrcStages = 0;
+
+        for (ResourceId id{ 0 }; id < m_resources.size(); ++id)
+        {
+            const auto& used = m_resources[id];
+            const auto& state = states[id];
+
+            if (!used.imported || used.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED || used.finalLayout == state.layout)
+            {
+                continue;
+            }
+
+            m_finalSrcStages |= state.writeStages | state.readStages;
+
+            m_finalBarriers.push_back(barrierFor(used, state, AccessInfo{ .layout = used.finalLayout }));
+        }
+
+        if (!m_finalBarriers.empty())
+        {
+            ++m_statistics.barriers;
+        }
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::execute(VkCommandBuffer commandBuffer) const
+    {
+        if (!m_compiled)
+        {
+            throw Exception::FrameGraphError("executed without compiling the passes added since");
+        }
+
+        const Resources resources{ *this };
+
+        for (const auto passIndex : m_order)
+        {
+            const auto& pass = m_passes[passIndex];
+
+            if (!pass.barriers.empty())
+            {
+                vkCmdPipelineBarrier(commandBuffer,
+                                     pass.srcStages != 0 ? pass.srcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                     pass.dstStages,
+                                     0,
+                                     0, nullptr,
+                                     0, nullptr,
+                                     static_cast<u32>(pass.barriers.size()), pass.barriers.data());
+            }
+
+            pass.execute(resources, commandBuffer);
+        }
+
+        if (!m_finalBarriers.empty())
+        {
+            //Presentation and later submissions synchronize through semaphores and fences, nothing waits here
+            vkCmdPipelineBarrier(commandBuffer,
+                                 m_finalSrcStages != 0 ? m_finalSrcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                 VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                 0,
+                                 0, nullptr,
+                                 0, nullptr,
+                                 static_cast<u32>(m_finalBarriers.size()), m_finalBarriers.data());
+        }
+    }
+
+    template<bool ValidationEnabled>
+    void
+    FrameGraph<ValidationEnabled>::reset()
+    {
+        m_passes.clear();
+        m_resources.clear();
+        m_order.clear();
+        m_finalBarriers.clear();
+        m_finalSrcStages = 0;
+        m_compiled = false;
+    }
+
+    template<bool ValidationEnabled>
+    typename FrameGraph<ValidationEnabled>::Resource&
+    FrameGraph<ValidationEnabled>::resource(ResourceId id)
+    {
+        if (id >= m_resources.size())
+        {
+            throw Exception::FrameGraphError("unknown resource " + std::to_string(id));
+        }
+
+        return m_resources[id];
+    }
+
+    template<bool ValidationEnabled>
+    const typename FrameGraph<ValidationEnabled>::Resource&
+    FrameGraph<ValidationEnabled>::resource(ResourceId id) const
+    {
+        if (id >= m_resources.size())
+        {
+            throw Exception::FrameGraphError("unknown resource " + std::to_string(id));
+        }
+
+        return m_resources[id];
+    }
+
+    template class FrameGraph<true>;
+    template class FrameGraph<false>;
+}
@@ -0,0 +1,144 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <numeric>
+#include <iterator>
+#include <algorithm>
+
+#include <xk-graphics-engine/xk-vulkan/vk_frame_graph_plan.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    std::vector<bool>
+    FrameGraphPlan::cull(std::span<const Pass> passes, std::span<const Resource> resources)
+    {
+        std::vector<u32> readers(resources.size(), 0);
+        std::vector<u32> outputs(passes.size(), 0);
+        std::vector<std::vector<Index_t>> producers(resources.size());
+
+        std::vector<bool> culled(passes.size(), false);
+
+        for (Index_t id{ 0 }; id < resources.size(); ++id)
+        {
+            readers[id] = resources[id].imported ? 1 : 0;
+        }
+
+        for (Index_t i{ 0 }; i < passes.size(); ++i)
+        {
+            for (const auto id : passes[i].reads)
+            {
+                ++readers[id];
+            }
+
+            for (const auto id : passes[i].writes)
+            {
+                producers[id].push_back(i);
+            }
+
+            outputs[i] = static_cast<u32>(passes[i].writes.size()) + (passes[i].kept ? 1 : 0);
+        }
+
+        std::vector<Index_t> unreferenced{};
+
+        auto release = [&](const Pass& pass)
+        {
+            for (const auto id : pass.reads)
+            {
+                if (--readers[id] == 0)
+                {
+                    unreferenced.push_back(id);
+                }
+            }
+        };
+
+        //Seeded before any release, afterwards a resource is only pushed by the release that drops it to zero,
+        //so every resource is visited once
+        for (Index_t id{ 0 }; id < resources.size(); ++id)
+        {
+            if (readers[id] == 0)
+            {
+                unreferenced.push_back(id);
+            }
+        }
+
+        for (Index_t i{ 0 }; i < passes.size(); ++i)
+        {
+            if (outputs[i] == 0)
+            {
+                culled[i] = true;
+
+                release(passes[i]);
+            }
+        }
+
+        //Walks back from resources nobody reads, a producer whose every output is unread is culled and releases its inputs
+        while (!unreferenced.empty())
+        {
+            const auto id = unreferenced.back();
+
+            unreferenced.pop_back();
+
+            for (const auto producer : producers[id])
+            {
+                if (!culled[producer] && --outputs[producer] == 0)
+                {
+                    culled[producer] = true;
+
+                    release(passes[producer]);
+                }
+            }
+        }
+
+        return culled;
+    }
+
+    FrameGraphPlan::Aliasing
+    FrameGraphPlan::alias(std::span<const Transient> transients)
+    {
+        Aliasing aliasing{ .blockOf = std::vector<Index_t>(transients.size(), Bad<Index_t>()) };
+
+        std::vector<Index_t> bySize(transients.size());
+
+        std::iota(bySize.begin(), bySize.end(), Index_t{ 0 });
+
+        std::ranges::stable_sort(bySize, [&](Index_t a, Index_t b) { return transients[a].requirements.size > transients[b].requirements.size; });
+
+        for (const auto i : bySize)
+        {
+            const auto& transient = transients[i];
+
+            auto fits = [&](const Block& block)
+            {
+                return !block.lazy &&
+                        (block.requirements.memoryTypeBits & transient.requirements.memoryTypeBits) != 0 &&
+                        transient.requirements.size <= block.requirements.size &&
+                        std::ranges::none_of(block.lifetimes, [&](const auto& other) { return overlaps(other, transient.lifetime); });
+            };
+
+            //Lazily allocated memory is committed on demand and often never, sharing it would save nothing
+            auto block = transient.lazy ? aliasing.blocks.end() : std::ranges::find_if(aliasing.blocks, fits);
+
+            if (block == aliasing.blocks.end())
+            {
+                aliasing.blocks.push_back(Block{ .requirements = transient.requirements, .lazy = transient.lazy });
+
+                block = std::prev(aliasing.blocks.end());
+            }
+
+            //Every image is bound at offset 0, the alignment of any occupant is met
+            block->requirements.memoryTypeBits &= transient.requirements.memoryTypeBits;
+            block->lifetimes.push_back(transient.lifetime);
+
+            aliasing.blockOf[i] = static_cast<Index_t>(std::distance(aliasing.blocks.begin(), block));
+        }
+
+        return aliasing;
+    }
+
+    bool
+    FrameGraphPlan::overlaps(Lifetime a, Lifetime b)
+    {
+        return a.first <= b.second && b.first <= a.second;
+    }
+}
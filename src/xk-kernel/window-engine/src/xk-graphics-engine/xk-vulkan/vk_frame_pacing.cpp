@@ -0,0 +1,300 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <thread>
+#include <cstdlib>
+#include <algorithm>
+#include <charconv>
+
+#include <utility/log.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_frame_pacing.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    std::string_view
+    toString(FramePacingMode mode)
+    {
+        switch (mode)
+        {
+            case FramePacingMode::LatencyFirst:    return "latency";
+            case FramePacingMode::ThroughputFirst: return "throughput";
+            case FramePacingMode::PowerSaver:      return "power";
+        }
+
+        return "unknown";
+    }
+
+    std::string_view
+    toString(VkPresentModeKHR presentMode)
+    {
+        switch (presentMode)
+        {
+            case VK_PRESENT_MODE_IMMEDIATE_KHR:    return "Immediate";
+            case VK_PRESENT_MODE_MAILBOX_KHR:      return "Mailbox";
+            case VK_PRESENT_MODE_FIFO_KHR:         return "Fifo";
+            case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FifoRelaxed";
+            default:                               return "Unknown";
+        }
+    }
+
+    FramePacingPolicy
+    FramePacingPolicy::forMode(FramePacingMode mode)
+    {
+        switch (mode)
+        {
+            case FramePacingMode::LatencyFirst:
+            {
+                //A single frame in flight keeps the CPU from running ahead of what is on screen
+                return
+                {
+                    .mode = mode,
+                    .presentModes = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR },
+                    .framesInFlight = 1,
+                    .extraImages = 1,
+                    .maxFramesPerSecond = 0.0,
+                    .waitForPresent = true
+                };
+            }
+            case FramePacingMode::PowerSaver:
+            {
+                return
+                {
+                    .mode = mode,
+                    .presentModes = { VK_PRESENT_MODE_FIFO_KHR },
+                    .framesInFlight = static_cast<u32>(FramesInFlight),
+                    .extraImages = 0,
+                    .maxFramesPerSecond = 30.0
+                };
+            }
+            case FramePacingMode::ThroughputFirst:
+            default:
+            {
+                return
+                {
+                    .mode = FramePacingMode::ThroughputFirst,
+                    .presentModes = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR },
+                    .framesInFlight = MaxFramesInFlight,
+                    .extraImages = 2,
+                    .maxFramesPerSecond = 0.0
+                };
+            }
+        }
+    }
+
+    FramePacingPolicy
+    FramePacingPolicy::fromEnvironment()
+    {
+        auto mode = FramePacingMode::ThroughputFirst;
+
+        if (const char* environment = std::getenv(EnvironmentVariable.data()); environment != nullptr)
+        {
+            const std::string_view value{ environment };
+
+            if (value == "latency")
+            {
+                mode = FramePacingMode::LatencyFirst;
+            }
+            else if (value == "power")
+            {
+                mode = FramePacingMode::PowerSaver;
+            }
+            else if (value != "throughput")
+            {
+                log::warning("{}: unknown mode {}, using throughput", EnvironmentVariable, value);
+            }
+        }
+
+        auto policy = forMode(mode);
+
+        if (const char* environment = std::getenv(FrameLimitVariable.data()); environment != nullptr)
+        {
+            const std::string_view value{ environment };
+
+            f64 framesPerSecond{ 0.0 };
+
+            if (std::from_chars(value.data(), value.data() + value.size(), framesPerSecond).ec == std::errc{} && framesPerSecond >= 0.0)
+            {
+                policy.maxFramesPerSecond = framesPerSecond;
+            }
+            else
+            {
+                log::warning("{}: {} is not a frame rate", FrameLimitVariable, value);
+            }
+        }
+
+        return policy;
+    }
+
+    void
+    FrameLimiter::setRate(f64 framesPerSecond)
+    {
+        m_interval = framesPerSecond > 0.0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<f64>{ 1.0 / framesPerSecond })
+                                           : Clock::duration{ 0 };
+
+        m_nextFrame = Clock::now();
+    }
+
+    void
+    FrameLimiter::wait()
+    {
+        if (!isEnabled())
+        {
+            return;
+        }
+
+        //Sleep granularity is around a millisecond, the rest is yielded away
+        static constexpr auto SpinThreshold = std::chrono::milliseconds{ 1 };
+
+        auto now = Clock::now();
+
+        if (m_nextFrame - now > SpinThreshold)
+        {
+            std::this_thread::sleep_until(m_nextFrame - SpinThreshold);
+        }
+
+        while ((now = Clock::now()) < m_nextFrame)
+        {
+            std::this_thread::yield();
+        }
+
+        //Late frames start a new schedule, a burst of catch up frames would defeat the cap
+        m_nextFrame = now - m_nextFrame > m_interval ? now + m_interval : m_nextFrame + m_interval;
+    }
+
+    void
+    LatencyTracker::markInput(Clock::time_point time)
+    {
+        //Inputs arriving before the next present are served by the same frame, the first one waited longest
+        if (!m_pendingInput)
+        {
+            m_pendingInput = time;
+        }
+    }
+
+    void
+    LatencyTracker::beginFrame(u64 frameNumber)
+    {
+        if (m_pendingInput)
+        {
+            m_inputFrames.emplace_back(frameNumber, *m_pendingInput);
+
+            m_pendingInput.reset();
+        }
+    }
+
+    void
+    LatencyTracker::markPresent(u64 frameNumber, Clock::time_point time)
+    {
+        //Frames that were skipped or never confirmed as presented are dropped with their input
+        while (!m_inputFrames.empty() && m_inputFrames.front().first < frameNumber)
+        {
+            m_inputFrames.pop_front();
+        }
+
+        if (m_inputFrames.empty() || m_inputFrames.front().first != frameNumber)
+        {
+            return;
+        }
+
+        const auto latency = time - m_inputFrames.front().second;
+
+        m_inputFrames.pop_front();
+
+        ++m_samples;
+
+        m_total += latency;
+        m_min = std::min(m_min, latency);
+        m_max = std::max(m_max, latency);
+    }
+
+    LatencyTracker::Statistics
+    LatencyTracker::statistics() const
+    {
+        if (m_samples == 0)
+        {
+            return {};
+        }
+
+        using Milliseconds = std::chrono::duration<f64, std::milli>;
+
+        return
+        {
+            .samples = m_samples,
+            .minMilliseconds = Milliseconds{ m_min }.count(),
+            .averageMilliseconds = Milliseconds{ m_total }.count() / static_cast<f64>(m_samples),
+            .maxMilliseconds = Milliseconds{ m_max }.count()
+        };
+    }
+
+    void
+    LatencyTracker::reset()
+    {
+        *this = LatencyTracker{};
+    }
+
+    void
+    PresentTimer::markPresented(Clock::time_point frameStart, Clock::time_point gpuDone, Clock::time_point presented)
+    {
+        const auto cost = gpuDone - frameStart;
+
+        //A frame that took longer than predicted would miss the refresh again, so the estimate follows it up at once
+        m_frameCost = cost > m_frameCost ? cost : m_frameCost - (m_frameCost - cost) / 16;
+
+        if (m_lastPresented)
+        {
+            const auto interval = presented - *m_lastPresented;
+
+            auto& slot = m_intervals[m_samples % IntervalHistory];
+
+            m_intervalTotal += interval - slot;
+
+            slot = interval;
+
+            ++m_samples;
+        }
+
+        m_lastPresented = presented;
+    }
+
+    PresentTimer::Clock::time_point
+    PresentTimer::nextFrameStart() const
+    {
+        if (!m_lastPresented || m_samples < IntervalHistory)
+        {
+            return {};
+        }
+
+        const auto refresh = *std::ranges::min_element(m_intervals);
+
+        return *m_lastPresented + refresh - m_frameCost - SafetyMargin;
+    }
+
+    PresentTimer::Statistics
+    PresentTimer::statistics() const
+    {
+        if (m_samples == 0)
+        {
+            return {};
+        }
+
+        using Milliseconds = std::chrono::duration<f64, std::milli>;
+
+        const Size_t count = std::min<Size_t>(m_samples, IntervalHistory);
+
+        return
+        {
+            .samples = m_samples,
+            .refreshMilliseconds = Milliseconds{ *std::min_element(m_intervals.begin(), m_intervals.begin() + count) }.count(),
+            .averagePresentIntervalMilliseconds = Milliseconds{ m_intervalTotal }.count() / static_cast<f64>(count),
+            .frameCostMilliseconds = Milliseconds{ m_frameCost }.count()
+        };
+    }
+
+    void
+    PresentTimer::reset()
+    {
+        *this = PresentTimer{};
+    }
+}
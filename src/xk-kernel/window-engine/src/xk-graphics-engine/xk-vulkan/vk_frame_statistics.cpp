@@ -0,0 +1,302 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#include <xk-graphics-engine/xk-vulkan/vk_frame_statistics.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    namespace
+    {
+        //Overlay layout in pixels
+        constexpr u32 Margin{ 8 };
+        constexpr u32 Padding{ 4 };
+        constexpr u32 GraphHeight{ 96 };
+        constexpr u32 BarWidth{ 2 };
+        constexpr u32 BarStride{ 3 };
+        constexpr u32 BucketWidth{ 4 };
+        constexpr u32 Buckets{ static_cast<u32>(FrameStatisticsOverlay::MaxMilliseconds) };
+
+        constexpr u32 TimelineWidth{ static_cast<u32>(FrameStatistics::ShortWindow) * BarStride };
+        constexpr u32 HistogramWidth{ Buckets * BucketWidth };
+
+        constexpr VkClearColorValue BackgroundColor{ { 0.05f, 0.05f, 0.05f, 1.0f } };
+        constexpr VkClearColorValue GoodColor{ { 0.20f, 0.80f, 0.30f, 1.0f } };
+        constexpr VkClearColorValue SlowColor{ { 0.95f, 0.80f, 0.20f, 1.0f } };
+        constexpr VkClearColorValue HitchColor{ { 0.95f, 0.20f, 0.20f, 1.0f } };
+        constexpr VkClearColorValue MarkerColor{ { 0.90f, 0.90f, 0.90f, 1.0f } };
+
+        //Nearest rank of a sorted window
+        f32
+        percentile(const std::vector<f32>& sorted, f32 fraction)
+        {
+            const auto rank = static_cast<Size_t>(std::ceil(fraction * static_cast<f32>(sorted.size())));
+
+            return sorted[std::clamp<Size_t>(rank, 1, static_cast<Size_t>(sorted.size())) - 1];
+        }
+
+        //Height in pixels of a time on the graphs, clamped to the graph
+        u32
+        barHeight(f32 milliseconds)
+        {
+            const auto height = milliseconds / FrameStatisticsOverlay::MaxMilliseconds * static_cast<f32>(GraphHeight);
+
+            return std::clamp(static_cast<u32>(height), 1u, GraphHeight);
+        }
+
+        VkClearRect
+        clearRect(u32 x, u32 y, u32 width, u32 height)
+        {
+            return { .rect = { .offset = { static_cast<s32>(x), static_cast<s32>(y) }, .extent = { width, height } }, .baseArrayLayer = 0, .layerCount = 1 };
+        }
+    }
+
+    std::string_view
+    toString(FrameMetric metric)
+    {
+        switch (metric)
+        {
+            case FrameMetric::Frame:       return "Frame";
+            case FrameMetric::Cpu:         return "Cpu";
+            case FrameMetric::Gpu:         return "Gpu";
+            case FrameMetric::AcquireWait: return "AcquireWait";
+            case FrameMetric::PresentWait: return "PresentWait";
+            case FrameMetric::Idle:        return "Idle";
+        }
+
+        return "Unknown";
+    }
+
+    void
+    FrameStatistics::record(const FrameTiming& timing)
+    {
+        const auto index = m_written.load(std::memory_order_relaxed);
+
+        auto& slot = m_slots[index % Capacity];
+
+        //Odd while written, readers of the previous sample in this slot see the change and drop their copy
+        slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.frameNumber.store(timing.frameNumber, std::memory_order_relaxed);
+
+        for (Size_t metric{ 0 }; metric < FrameMetricCount; ++metric)
+        {
+            slot.milliseconds[metric].store(timing.milliseconds[metric], std::memory_order_relaxed);
+        }
+
+        slot.sequence.store(index * 2 + 2, std::memory_order_release);
+
+        m_written.store(index + 1, std::memory_order_release);
+    }
+
+    std::vector<FrameTiming>
+    FrameStatistics::latest(Size_t count) const
+    {
+        const auto written = m_written.load(std::memory_order_acquire);
+
+        const auto available = std::min<u64>({ written, count, Capacity });
+
+        std::vector<FrameTiming> timings{};
+        timings.reserve(static_cast<Size_t>(available));
+
+        for (auto index = written - available; index < written; ++index)
+        {
+            const auto& slot = m_slots[index % Capacity];
+
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+            //Already overwritten by a newer frame or still being written
+            if (sequence != index * 2 + 2)
+            {
+                continue;
+            }
+
+            FrameTiming timing{ .frameNumber = slot.frameNumber.load(std::memory_order_relaxed) };
+
+            for (Size_t metric{ 0 }; metric < FrameMetricCount; ++metric)
+            {
+                timing.milliseconds[metric] = slot.milliseconds[metric].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                timings.push_back(timing);
+            }
+        }
+
+        return timings;
+    }
+
+    FrameStatistics::Summary
+    FrameStatistics::summary(Size_t window) const
+    {
+        const auto timings = latest(window);
+
+        Summary summary{ .samples = static_cast<Size_t>(timings.size()) };
+
+        if (timings.empty())
+        {
+            return summary;
+        }
+
+        std::vector<f32> values(timings.size());
+
+        for (Size_t metric{ 0 }; metric < FrameMetricCount; ++metric)
+        {
+            std::ranges::transform(timings, values.begin(), [&](const FrameTiming& timing) { return timing.milliseconds[metric]; });
+
+            std::ranges::sort(values);
+
+            summary.metrics[metric] =
+            {
+                .p50 = percentile(values, 0.50f),
+                .p95 = percentile(values, 0.95f),
+                .p99 = percentile(values, 0.99f),
+                .max = values.back()
+            };
+        }
+
+        const auto hitchThreshold = summary[FrameMetric::Frame].p50 * HitchFactor;
+
+        summary.hitches = static_cast<Size_t>(std::ranges::count_if(timings, [&](const FrameTiming& timing) { return timing[FrameMetric::Frame] > hitchThreshold; }));
+
+        return summary;
+    }
+
+    bool
+    FrameStatisticsOverlay::isRequested()
+    {
+        return std::getenv(EnvironmentVariable.data()) != nullptr;
+    }
+
+    VkRect2D
+    FrameStatisticsOverlay::area(VkExtent2D extent)
+    {
+        const u32 width{ std::min(TimelineWidth + HistogramWidth + Padding * 3, extent.width > Margin ? extent.width - Margin : 0) };
+        const u32 height{ std::min(GraphHeight + Padding * 2, extent.height > Margin ? extent.height - Margin : 0) };
+
+        return { .offset = { static_cast<s32>(Margin), static_cast<s32>(Margin) }, .extent = { width, height } };
+    }
+
+    void
+    FrameStatisticsOverlay::record(VkCommandBuffer commandBuffer, VkExtent2D extent, const FrameStatistics& statistics)
+    {
+        const auto overlay = area(extent);
+
+        //The clears have to stay inside the render area, a window too small for the whole overlay shows none
+        if (overlay.extent.width < TimelineWidth + HistogramWidth + Padding * 3 || overlay.extent.height < GraphHeight + Padding * 2)
+        {
+            return;
+        }
+
+        if (m_framesUntilRefresh == 0)
+        {
+            m_shortSummary = statistics.summary(FrameStatistics::ShortWindow);
+            m_longSummary = statistics.summary(FrameStatistics::LongWindow);
+
+            m_histogram.assign(Buckets, 0);
+
+            for (const auto& timing : statistics.latest(FrameStatistics::LongWindow))
+            {
+                ++m_histogram[std::min(static_cast<u32>(timing[FrameMetric::Frame]), Buckets - 1)];
+            }
+
+            m_framesUntilRefresh = RefreshInterval;
+        }
+
+        --m_framesUntilRefresh;
+
+        m_background.assign(1, clearRect(Margin, Margin, overlay.extent.width, overlay.extent.height));
+        m_good.clear();
+        m_slow.clear();
+        m_hitch.clear();
+        m_markers.clear();
+
+        const u32 top{ Margin + Padding };
+        const u32 bottom{ top + GraphHeight };
+
+        //Frame times of the short window, newest on the right
+        const auto hitchThreshold = m_shortSummary[FrameMetric::Frame].p50 * FrameStatistics::HitchFactor;
+        const auto slowThreshold = m_shortSummary[FrameMetric::Frame].p95;
+
+        const auto timings = statistics.latest(FrameStatistics::ShortWindow);
+
+        u32 x{ Margin + Padding + TimelineWidth - static_cast<u32>(timings.size()) * BarStride };
+
+        for (const auto& timing : timings)
+        {
+            const auto frame = timing[FrameMetric::Frame];
+            const auto height = barHeight(frame);
+
+            auto& bars = frame > hitchThreshold ? m_hitch : frame > slowThreshold ? m_slow : m_good;
+
+            bars.push_back(clearRect(x, bottom - height, BarWidth, height));
+
+            x += BarStride;
+        }
+
+        //Histogram of the long window, the fullest bucket fills the height
+        const u32 histogramLeft{ Margin + Padding * 2 + TimelineWidth };
+
+        const auto fullest = std::ranges::max(m_histogram);
+
+        for (u32 bucket{ 0 }; bucket < Buckets && fullest > 0; ++bucket)
+        {
+            if (m_histogram[bucket] == 0)
+            {
+                continue;
+            }
+
+            const auto height = std::max<u32>(1, static_cast<u32>(m_histogram[bucket] * GraphHeight / fullest));
+
+            m_good.push_back(clearRect(histogramLeft + bucket * BucketWidth, bottom - height, BucketWidth - 1, height));
+        }
+
+        const auto& longFrame = m_longSummary[FrameMetric::Frame];
+
+        for (const auto marker : { longFrame.p50, longFrame.p95, longFrame.p99 })
+        {
+            const auto bucket = std::min(static_cast<u32>(marker), Buckets - 1);
+
+            m_markers.push_back(clearRect(histogramLeft + bucket * BucketWidth, top, 1, GraphHeight));
+        }
+
+        //Percentiles of the short window as lines across the frame times
+        for (const auto marker : { m_shortSummary[FrameMetric::Frame].p50, m_shortSummary[FrameMetric::Frame].p99 })
+        {
+            m_markers.push_back(clearRect(Margin + Padding, bottom - barHeight(marker), TimelineWidth, 1));
+        }
+
+        clear(commandBuffer, m_background, BackgroundColor);
+        clear(commandBuffer, m_good, GoodColor);
+        clear(commandBuffer, m_slow, SlowColor);
+        clear(commandBuffer, m_hitch, HitchColor);
+        clear(commandBuffer, m_markers, MarkerColor);
+    }
+
+    void
+    FrameStatisticsOverlay::clear(VkCommandBuffer commandBuffer, const std::vector<VkClearRect>& rects, VkClearColorValue color) const
+    {
+        if (rects.empty())
+        {
+            return;
+        }
+
+        const VkClearAttachment attachment
+        {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .colorAttachment = 0,
+            .clearValue = { .color = color }
+        };
+
+        vkCmdClearAttachments(commandBuffer, 1, &attachment, static_cast<u32>(rects.size()), rects.data());
+    }
+}
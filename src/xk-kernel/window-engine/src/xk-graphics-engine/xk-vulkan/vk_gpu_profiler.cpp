@@ -0,0 +1,245 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <optional>
+#include <algorithm>
+
+#include <utility/log.h>
+#include <utility/trace.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_gpu_profiler.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    GpuProfiler::ScopedZone::ScopedZone(GpuProfiler& profiler, VkCommandBuffer commandBuffer, std::string_view name)
+        : m_profiler{ profiler }
+        , m_commandBuffer{ commandBuffer }
+        , m_zone{ profiler.beginZone(commandBuffer, name) }
+    {}
+
+    GpuProfiler::ScopedZone::~ScopedZone()
+    {
+        m_profiler.endZone(m_commandBuffer, m_zone);
+    }
+
+    GpuProfiler::GpuProfiler(VkPhysicalDevice gpu, VkDevice device, u32 queueFamilyIndex, Size_t framesInFlight)
+        : m_device{ device }
+        , m_frames(framesInFlight)
+    {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(gpu, &properties);
+
+        u32 queueFamilyCount{ 0 };
+        vkGetPhysicalDeviceQueueFamilyProperties(gpu, &queueFamilyCount, nullptr);
+
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(gpu, &queueFamilyCount, queueFamilies.data());
+
+        const auto validBits = queueFamilyIndex < queueFamilies.size() ? queueFamilies[queueFamilyIndex].timestampValidBits : 0;
+
+        //Without valid bits the queue cannot write timestamps at all, the profiler stays a no-op
+        if (validBits == 0 || properties.limits.timestampPeriod == 0.0f)
+        {
+            log::warning("GPU profiler: timestamps are not supported on the graphics queue");
+
+            return;
+        }
+
+        m_timestampPeriod = static_cast<f64>(properties.limits.timestampPeriod);
+        m_timestampMask = validBits >= 64 ? ~u64{ 0 } : (u64{ 1 } << validBits) - 1;
+
+        const VkQueryPoolCreateInfo poolInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = static_cast<u32>(framesInFlight) * MaxZonesPerFrame * 2
+        };
+
+        if (vkCreateQueryPool(m_device, &poolInfo, nullptr, &m_queryPool) != VK_SUCCESS)
+        {
+            throw Exception::GPUError("failed to create timestamp query pool");
+        }
+
+        log::info("GPU profiler: {} ns per tick, {} valid bits", m_timestampPeriod, validBits);
+    }
+
+    GpuProfiler::~GpuProfiler()
+    {
+        vkDestroyQueryPool(m_device, m_queryPool, nullptr);
+    }
+
+    void
+    GpuProfiler::beginFrame(VkCommandBuffer commandBuffer, Index_t frameSlot)
+    {
+        if (!isSupported())
+        {
+            return;
+        }
+
+        m_currentFrame = frameSlot % static_cast<Index_t>(m_frames.size());
+
+        auto& frame = m_frames[m_currentFrame];
+
+        //The slot is reused only after its fence was waited on, so its queries are already written
+        if (frame.hasResults)
+        {
+            resolve(frame);
+        }
+
+        vkCmdResetQueryPool(commandBuffer, m_queryPool, queryBase(m_currentFrame), MaxZonesPerFrame * 2);
+
+        frame.zones.clear();
+        frame.usedQueries = 0;
+        frame.openZones = 0;
+        frame.cpuStartUs = trace::Collector::instance().nowUs();
+        frame.hasResults = false;
+    }
+
+    GpuProfiler::ZoneId
+    GpuProfiler::beginZone(VkCommandBuffer commandBuffer, std::string_view name)
+    {
+        if (!isSupported())
+        {
+            return InvalidZone;
+        }
+
+        auto& frame = m_frames[m_currentFrame];
+
+        if (frame.usedQueries + 2 > MaxZonesPerFrame * 2)
+        {
+            return InvalidZone;
+        }
+
+        const auto zone = static_cast<ZoneId>(frame.zones.size());
+
+        frame.zones.push_back(Zone
+        {
+            .name = std::string{ name },
+            .depth = frame.openZones,
+            .beginQuery = queryBase(m_currentFrame) + frame.usedQueries,
+            .endQuery = queryBase(m_currentFrame) + frame.usedQueries + 1
+        });
+
+        frame.usedQueries += 2;
+        ++frame.openZones;
+
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, frame.zones.back().beginQuery);
+
+        return zone;
+    }
+
+    void
+    GpuProfiler::endZone(VkCommandBuffer commandBuffer, ZoneId zone)
+    {
+        if (zone == InvalidZone)
+        {
+            return;
+        }
+
+        auto& frame = m_frames[m_currentFrame];
+
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, frame.zones[zone].endQuery);
+
+        --frame.openZones;
+        frame.hasResults = true;
+    }
+
+    void
+    GpuProfiler::resolve(FrameData& frame)
+    {
+        const auto slot = static_cast<Index_t>(&frame - m_frames.data());
+
+        //Pairs of { timestamp, availability }
+        std::vector<u64> data(static_cast<Size_t>(frame.usedQueries) * 2);
+
+        const auto result = vkGetQueryPoolResults(m_device,
+                                                  m_queryPool,
+                                                  queryBase(slot),
+                                                  frame.usedQueries,
+                                                  data.size() * sizeof(u64),
+                                                  data.data(),
+                                                  sizeof(u64) * 2,
+                                                  VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        if (result != VK_SUCCESS && result != VK_NOT_READY)
+        {
+            log::warning("GPU profiler: failed to read queries {}", getVulkanErrorName(result));
+
+            return;
+        }
+
+        auto timestamp = [&](u32 query) -> std::optional<u64>
+        {
+            const auto local = query - queryBase(slot);
+
+            if (data[local * 2 + 1] == 0)
+            {
+                return std::nullopt;
+            }
+
+            return data[local * 2] & m_timestampMask;
+        };
+
+        std::optional<u64> frameBegin{};
+        std::optional<u64> frameEnd{};
+
+        for (const auto& zone : frame.zones)
+        {
+            const auto begin = timestamp(zone.beginQuery);
+            const auto end = timestamp(zone.endQuery);
+
+            if (begin && end)
+            {
+                frameBegin = std::min(frameBegin.value_or(*begin), *begin);
+                frameEnd = std::max(frameEnd.value_or(*end), *end);
+            }
+        }
+
+        if (!frameBegin)
+        {
+            return;
+        }
+
+        auto toUs = [&](u64 ticks) { return static_cast<f64>(ticks) * m_timestampPeriod / 1000.0; };
+
+        m_lastResults.clear();
+
+        auto& collector = trace::Collector::instance();
+
+        for (const auto& zone : frame.zones)
+        {
+            const auto begin = timestamp(zone.beginQuery);
+            const auto end = timestamp(zone.endQuery);
+
+            if (!begin || !end)
+            {
+                continue;
+            }
+
+            //GPU zones are anchored at the CPU time the frame was recorded, the offset inside the frame is exact
+            ZoneResult zoneResult
+            {
+                .name = zone.name,
+                .depth = zone.depth,
+                .startUs = frame.cpuStartUs + toUs(*begin - *frameBegin),
+                .durationUs = toUs(*end - *begin)
+            };
+
+            collector.add(trace::Event
+            {
+                .name = zoneResult.name,
+                .category = "gpu",
+                .timeline = trace::Timeline::Gpu,
+                .threadId = zoneResult.depth,
+                .startUs = zoneResult.startUs,
+                .durationUs = zoneResult.durationUs
+            });
+
+            m_lastResults.emplace_back(std::move(zoneResult));
+        }
+
+        m_lastFrameTimeMs = toUs(*frameEnd - *frameBegin) / 1000.0;
+    }
+}
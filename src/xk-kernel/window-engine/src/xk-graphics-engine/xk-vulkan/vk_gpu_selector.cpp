@@ -0,0 +1,273 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <cctype>
+#include <cstdlib>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include <utility/log.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_gpu_selector.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    namespace
+    {
+        std::string toLower(std::string_view text)
+        {
+            std::string lower{ text };
+
+            std::ranges::transform(lower, lower.begin(), [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+
+            return lower;
+        }
+
+        constexpr s64 deviceTypeScore(VkPhysicalDeviceType type)
+        {
+            switch (type)
+            {
+                case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+                {
+                    return 100'000;
+                }
+                case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+                {
+                    return 40'000;
+                }
+                case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+                {
+                    return 20'000;
+                }
+                case VK_PHYSICAL_DEVICE_TYPE_CPU:
+                {
+                    return 1'000;
+                }
+                default:
+                {
+                    return 0;
+                }
+            }
+        }
+
+        constexpr std::string_view deviceTypeName(VkPhysicalDeviceType type)
+        {
+            switch (type)
+            {
+                case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+                {
+                    return "discrete";
+                }
+                case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+                {
+                    return "integrated";
+                }
+                case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+                {
+                    return "virtual";
+                }
+                case VK_PHYSICAL_DEVICE_TYPE_CPU:
+                {
+                    return "cpu";
+                }
+                default:
+                {
+                    return "other";
+                }
+            }
+        }
+    }
+
+    GpuPreference
+    GpuPreference::resolve(const GpuPreference& configured)
+    {
+        if (const char* environment = std::getenv(EnvironmentVariable.data()); environment != nullptr && *environment != '\0')
+        {
+            return GpuPreference{ .nameOrUuid = environment };
+        }
+
+        return configured;
+    }
+
+    u64
+    GpuSelector::deviceLocalMemory(const VkPhysicalDeviceMemoryProperties& memoryProperties)
+    {
+        u64 size{ 0 };
+
+        for (u32 i{ 0 }; i < memoryProperties.memoryHeapCount; ++i)
+        {
+            if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+            {
+                size += memoryProperties.memoryHeaps[i].size;
+            }
+        }
+
+        return size;
+    }
+
+    s64
+    GpuSelector::score(const GpuCandidate& candidate)
+    {
+        static constexpr u64 MiB{ 1024 * 1024 };
+
+        const auto& properties = candidate.properties;
+        const auto& limits = properties.limits;
+        const auto& features = candidate.features;
+
+        s64 total{ deviceTypeScore(properties.deviceType) };
+
+        //VRAM: one point per 16 MiB up to 32 GiB, so it only orders devices of the same type
+        total += static_cast<s64>(std::min<u64>(deviceLocalMemory(candidate.memoryProperties) / (16 * MiB), 2048));
+
+        //Limits that matter for a GUI: large textures, many descriptors, big push constant blocks
+        total += static_cast<s64>(limits.maxImageDimension2D / 1024);
+        total += static_cast<s64>(std::min<u32>(limits.maxPerStageDescriptorSampledImages, 1u << 20) / 4096);
+        total += static_cast<s64>(limits.maxPushConstantsSize / 64);
+
+        //Optional features we can take advantage of
+        total += features.textureCompressionBC ? 50 : 0;
+        total += features.multiDrawIndirect ? 50 : 0;
+        total += features.fillModeNonSolid ? 10 : 0;
+        total += features.wideLines ? 10 : 0;
+
+        //Queue topology: dedicated transfer and async compute families allow overlapping uploads
+        bool hasDedicatedTransfer{ false };
+        bool hasAsyncCompute{ false };
+
+        for (const auto& family : candidate.queueFamilies)
+        {
+            const auto flags = family.queueFlags;
+
+            if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+            {
+                hasDedicatedTransfer = true;
+            }
+
+            if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT))
+            {
+                hasAsyncCompute = true;
+            }
+        }
+
+        total += hasDedicatedTransfer ? 200 : 0;
+        total += hasAsyncCompute ? 200 : 0;
+
+        return total;
+    }
+
+    std::vector<RankedGpu>
+    GpuSelector::rank(std::span<const GpuCandidate> candidates)
+    {
+        std::vector<RankedGpu> ranking{};
+
+        ranking.reserve(candidates.size());
+
+        for (Index_t i{ 0 }; i < candidates.size(); ++i)
+        {
+            const auto& candidate = candidates[i];
+
+            ranking.push_back(RankedGpu
+            {
+                .candidate = i,
+                .score = score(candidate),
+                .name = candidate.properties.deviceName,
+                .type = deviceTypeName(candidate.properties.deviceType),
+                .uuid = formatUuid(candidate.uuid),
+                .isSuitable = candidate.isSuitable
+            });
+        }
+
+        std::ranges::stable_sort(ranking, [](const RankedGpu& left, const RankedGpu& right)
+        {
+            if (left.isSuitable != right.isSuitable)
+            {
+                return left.isSuitable;
+            }
+
+            return left.score > right.score;
+        });
+
+        return ranking;
+    }
+
+    bool
+    GpuSelector::matches(const GpuCandidate& candidate, const GpuPreference& preference)
+    {
+        if (preference.isEmpty())
+        {
+            return false;
+        }
+
+        const auto wanted = toLower(preference.nameOrUuid);
+
+        if (toLower(formatUuid(candidate.uuid)) == wanted)
+        {
+            return true;
+        }
+
+        return toLower(candidate.properties.deviceName).find(wanted) != std::string::npos;
+    }
+
+    std::optional<Index_t>
+    GpuSelector::select(std::span<const GpuCandidate> candidates, const GpuPreference& preference)
+    {
+        const auto ranking = rank(candidates);
+
+        logReport(ranking);
+
+        if (!preference.isEmpty())
+        {
+            for (const auto& ranked : ranking)
+            {
+                if (ranked.isSuitable && matches(candidates[ranked.candidate], preference))
+                {
+                    log::info("GPU override '{}' selected {}", preference.nameOrUuid, ranked.name);
+
+                    return ranked.candidate;
+                }
+            }
+
+            log::warning("GPU override '{}' does not match any suitable device, falling back to the best score", preference.nameOrUuid);
+        }
+
+        if (ranking.empty() || !ranking.front().isSuitable)
+        {
+            return std::nullopt;
+        }
+
+        return ranking.front().candidate;
+    }
+
+    std::string
+    GpuSelector::formatUuid(const std::array<u8, VK_UUID_SIZE>& uuid)
+    {
+        std::string text{};
+
+        for (Index_t i{ 0 }; i < uuid.size(); ++i)
+        {
+            if (i == 4 || i == 6 || i == 8 || i == 10)
+            {
+                text.push_back('-');
+            }
+
+            text += fmt::format("{:02x}", uuid[i]);
+        }
+
+        return text;
+    }
+
+    void
+    GpuSelector::logReport(std::span<const RankedGpu> ranking)
+    {
+        log::info("GPU ranking:");
+
+        for (Index_t place{ 0 }; place < ranking.size(); ++place)
+        {
+            const auto& ranked = ranking[place];
+
+            log::info("  #{} {} ({}) [{}] score {}{}", place + 1, ranked.name, ranked.type, ranked.uuid, ranked.score, ranked.isSuitable ? "" : " (unsuitable)");
+        }
+    }
+}
@@ -6,6 +6,8 @@
 #include <ranges>
 #include <cassert>
 
+#include <fmt/format.h>
+
 #include <application/app_info.h>
 #include <utility/log.h>
 #include <window/win_main_window.h>
@@ -42,7 +44,28 @@ namespace xk::graphics_engine::vulkan
         createPresentationSurface();
         pickGpu();
         createLogicalDevice();
+        createMemoryBudget();
         createCommandPool();
+        createDescriptorHeap();
+        createPipelineCache();
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    GpuWrapper<ValidationLayersEnabled>::setupHeadless()
+    {
+        m_headless = true;
+
+        createVulkanInstance();
+        setupDebugger();
+        pickGpu();
+        createLogicalDevice();
+        createMemoryBudget();
+        createCommandPool();
+        createDescriptorHeap();
+        createPipelineCache();
+
+        log::info("Running headless, no presentation surface");
     }
 
     template<bool ValidationLayersEnabled>
@@ -70,11 +93,19 @@ namespace xk::graphics_engine::vulkan
             .applicationVersion = VK_MAKE_VERSION(1,0,0),
             .pEngineName        = "Best Framework Ever",
             .engineVersion      = VK_MAKE_VERSION(1,0,0),
-            .apiVersion         = VK_API_VERSION_1_0
+            .apiVersion         = VK_API_VERSION_1_2
         };
 
         auto extensions = requiredGlfwExtensions();
 
+        //Optional, SurfaceFormatPolicy falls back to 8 bit sRGB when the surface offers no HDR color space
+        if (!m_headless && areGlfwExtensionsSupported({ VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME }))
+        {
+            extensions.emplace_back(VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME);
+
+            m_swapChainColorSpaces = true;
+        }
+
         VkInstanceCreateInfo instanceCreateInfo
         {
             .sType                      = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
@@ -145,11 +176,17 @@ namespace xk::graphics_engine::vulkan
             log::info("Obtaining required window extensions");
         }
 
-        u32 extensionCount = 0;
+        std::vector<const char*> returnValue{};
+
+        //Without a window GLFW is not initialized and no surface extension is needed
+        if (!m_headless)
+        {
+            u32 extensionCount = 0;
 
-        const char** extensions = glfwGetRequiredInstanceExtensions(&extensionCount);
+            const char** extensions = glfwGetRequiredInstanceExtensions(&extensionCount);
 
-        std::vector<const char*> returnValue(extensions, extensions + extensionCount);
+            returnValue.assign(extensions, extensions + extensionCount);
+        }
 
         if constexpr(ValidationLayersEnabled)
         {
@@ -163,7 +200,7 @@ namespace xk::graphics_engine::vulkan
             }
         }
 
-        if(returnValue.empty())
+        if(returnValue.empty() && !m_headless)
         {
             throw Exception::InstanceError("Could not obtain extensions");
         }
@@ -199,14 +236,49 @@ namespace xk::graphics_engine::vulkan
 
         log::info("Device count: {}", gpus.size());
 
+        std::vector<GpuCandidate> candidates{};
+
+        candidates.reserve(gpus.size());
+
         for (const VkPhysicalDevice &gpu : gpus)
         {
-            if (isGpuGood(gpu, supportedOperations))
+            auto& candidate = candidates.emplace_back(GpuCandidate{ .handle = gpu });
+
+            VkPhysicalDeviceIDProperties idProperties
             {
-                m_gpu = gpu;
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES
+            };
 
-                break;
-            }
+            VkPhysicalDeviceProperties2 properties
+            {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                .pNext = &idProperties
+            };
+
+            vkGetPhysicalDeviceProperties2(gpu, &properties);
+
+            candidate.properties = properties.properties;
+
+            std::ranges::copy(idProperties.deviceUUID, candidate.uuid.begin());
+
+            vkGetPhysicalDeviceMemoryProperties(gpu, &candidate.memoryProperties);
+
+            vkGetPhysicalDeviceFeatures(gpu, &candidate.features);
+
+            u32 queueFamilyCount{ 0 };
+            vkGetPhysicalDeviceQueueFamilyProperties(gpu, &queueFamilyCount, nullptr);
+
+            candidate.queueFamilies.resize(queueFamilyCount);
+            vkGetPhysicalDeviceQueueFamilyProperties(gpu, &queueFamilyCount, candidate.queueFamilies.data());
+
+            candidate.isSuitable = isGpuGood(gpu, supportedOperations);
+        }
+
+        const auto selected = GpuSelector::select(candidates, GpuPreference::resolve(m_gpuPreference));
+
+        if (selected.has_value())
+        {
+            m_gpu = candidates[*selected].handle;
         }
 
         if (m_gpu == VK_NULL_HANDLE)
@@ -248,18 +320,125 @@ namespace xk::graphics_engine::vulkan
             });
         }
 
+        //Descriptor indexing backs the bindless descriptor heap, every feature here is checked by DescriptorHeap::isSupported
+        VkPhysicalDeviceVulkan12Features vulkan12Features
+        {
+            .sType                                          = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+            .descriptorIndexing                             = VK_TRUE,
+            .shaderSampledImageArrayNonUniformIndexing      = VK_TRUE,
+            .shaderStorageBufferArrayNonUniformIndexing     = VK_TRUE,
+            .descriptorBindingSampledImageUpdateAfterBind   = VK_TRUE,
+            .descriptorBindingStorageBufferUpdateAfterBind  = VK_TRUE,
+            .descriptorBindingUpdateUnusedWhilePending      = VK_TRUE,
+            .descriptorBindingPartiallyBound                = VK_TRUE,
+            .runtimeDescriptorArray                         = VK_TRUE
+        };
+
+        //Render pass and framebuffer objects are only created when this is not available
+        const bool useDynamicRendering{ DynamicRendering::isSupported(m_gpu) && !DynamicRendering::isDisabled() };
+
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures
+        {
+            .sType              = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+            .dynamicRendering   = VK_TRUE
+        };
+
+        //Headless devices never present, so there is nothing to wait for
+        const bool usePresentWait{ !m_headless && PresentWait::isSupported(m_gpu) && !PresentWait::isDisabled() };
+
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures
+        {
+            .sType          = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+            .presentWait    = VK_TRUE
+        };
+
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures
+        {
+            .sType          = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+            .pNext          = &presentWaitFeatures,
+            .presentId      = VK_TRUE
+        };
+
+        //Optional features are appended behind the Vulkan 1.2 ones
+        void** featureChain = &vulkan12Features.pNext;
+
+        if (useDynamicRendering)
+        {
+            *featureChain = &dynamicRenderingFeatures;
+            featureChain = &dynamicRenderingFeatures.pNext;
+        }
+
+        if (usePresentWait)
+        {
+            *featureChain = &presentIdFeatures;
+            featureChain = &presentWaitFeatures.pNext;
+        }
+
         const VkPhysicalDeviceFeatures deviceDesiredFeatures
         {
             .samplerAnisotropy = VK_TRUE
         };
 
+        std::vector<const char*> enabledExtensions{};
+
+        if (!m_headless)
+        {
+            enabledExtensions = DeviceExtensions;
+        }
+
+        for (const auto& extension : OptionalDeviceExtensions)
+        {
+            if (areDeviceExtensionsSupported(m_gpu, { extension }))
+            {
+                enabledExtensions.push_back(extension);
+            }
+            else
+            {
+                log::info("Optional device extension {} is not supported", extension);
+            }
+        }
+
+        if (useDynamicRendering)
+        {
+            enabledExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        }
+
+        //Depends on the swapchain extension, which headless devices do not enable
+        if (!m_headless)
+        {
+            if (areDeviceExtensionsSupported(m_gpu, { VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME }))
+            {
+                enabledExtensions.push_back(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+            }
+            else
+            {
+                log::info("Optional device extension {} is not supported", VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+            }
+        }
+
+        if (usePresentWait)
+        {
+            enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        }
+
+        log::info("Rendering path: {}", useDynamicRendering ? "dynamic rendering" : "render pass");
+
+        if (!m_headless)
+        {
+            log::info("Present timing: {}", usePresentWait ? "present wait" : "fence estimate");
+        }
+
+        m_enabledDeviceExtensions.assign(enabledExtensions.begin(), enabledExtensions.end());
+
         VkDeviceCreateInfo deviceCreateInfo
         {
             .sType                      = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+            .pNext                      = &vulkan12Features,
             .queueCreateInfoCount       = static_cast<u32>(queueCreateInfos.size()),
             .pQueueCreateInfos          = queueCreateInfos.data(),
-            .enabledExtensionCount      = static_cast<u32>(DeviceExtensions.size()),
-            .ppEnabledExtensionNames    =  DeviceExtensions.data(),
+            .enabledExtensionCount      = static_cast<u32>(enabledExtensions.size()),
+            .ppEnabledExtensionNames    =  enabledExtensions.data(),
             .pEnabledFeatures           =  &deviceDesiredFeatures
         };
 
@@ -281,6 +460,30 @@ namespace xk::graphics_engine::vulkan
         vkGetDeviceQueue(m_logicalDevice, indices.graphicsFamily.value(), 0, &m_graphicsQueue);
 
         vkGetDeviceQueue(m_logicalDevice, indices.presentFamily.value(), 0, &m_presentQueue);
+
+        if (useDynamicRendering)
+        {
+            m_dynamicRendering = std::make_unique<DynamicRendering>(m_logicalDevice);
+        }
+
+        if (usePresentWait)
+        {
+            m_presentWait = std::make_unique<PresentWait>(m_logicalDevice);
+        }
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    GpuWrapper<ValidationLayersEnabled>::createMemoryBudget()
+    {
+        m_memoryBudget = std::make_unique<MemoryBudget>(m_gpu, isDeviceExtensionEnabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME));
+    }
+
+    template<bool ValidationLayersEnabled>
+    bool
+    GpuWrapper<ValidationLayersEnabled>::isDeviceExtensionEnabled(std::string_view extension) const
+    {
+        return std::ranges::find(m_enabledDeviceExtensions, extension) != m_enabledDeviceExtensions.end();
     }
 
     template<bool ValidationLayersEnabled>
@@ -304,6 +507,20 @@ namespace xk::graphics_engine::vulkan
         }
     }
 
+    template<bool ValidationLayersEnabled>
+    void
+    GpuWrapper<ValidationLayersEnabled>::createDescriptorHeap()
+    {
+        m_descriptorHeap = std::make_unique<DescriptorHeap>(m_gpu, m_logicalDevice, m_deletionQueue);
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    GpuWrapper<ValidationLayersEnabled>::createPipelineCache()
+    {
+        m_pipelineCache = std::make_unique<PipelineCache>(m_logicalDevice, m_gpuProperties);
+    }
+
     template<bool ValidationLayersEnabled>
     bool
     GpuWrapper<ValidationLayersEnabled>::areValidationLayersSupported(const std::vector<const char*>& validationLayers) const
@@ -377,13 +594,14 @@ namespace xk::graphics_engine::vulkan
     {
         const auto indices = findQueueFamilies(gpu, operationsToBeSupported);
 
-        const bool extensionsSupported = areDeviceExtensionsSupported(gpu, DeviceExtensions);
+        //Headless rendering never presents, so neither the swapchain extension nor surface support is needed
+        const bool extensionsSupported = m_headless || areDeviceExtensionsSupported(gpu, DeviceExtensions);
 
-        bool swapChainAdequate = false;
+        bool swapChainAdequate = m_headless;
 
-        if (extensionsSupported)
+        if (extensionsSupported && !m_headless)
         {
-            const auto swapChainSupport = querySwapChainSupport(gpu);
+            const auto swapChainSupport = querySwapChainSupport(gpu, m_surface);
 
             swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
         }
@@ -392,7 +610,7 @@ namespace xk::graphics_engine::vulkan
         
         vkGetPhysicalDeviceFeatures(gpu, &supportedFeatures);
 
-        return indices.isComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy;
+        return indices.isComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy && DescriptorHeap::isSupported(gpu);
     }
 
     template<bool ValidationLayersEnabled>
@@ -454,13 +672,21 @@ namespace xk::graphics_engine::vulkan
                 indices.graphicsFamily = std::make_optional(i);
             }
 
-            VkBool32 presentSupport{ VkBool32{ 0 } };
+            if (m_headless)
+            {
+                //Nothing is presented, the graphics queue stands in so the indices stay complete
+                indices.presentFamily = indices.graphicsFamily;
+            }
+            else
+            {
+                VkBool32 presentSupport{ VkBool32{ 0 } };
 
-            vkGetPhysicalDeviceSurfaceSupportKHR(gpu, i, m_surface, &presentSupport);
+                vkGetPhysicalDeviceSurfaceSupportKHR(gpu, i, m_surface, &presentSupport);
 
-            if(familyProperties.queueCount > 0 && presentSupport)
-            {
-                indices.presentFamily = std::make_optional(i);
+                if(familyProperties.queueCount > 0 && presentSupport)
+                {
+                    indices.presentFamily = std::make_optional(i);
+                }
             }
 
             if(indices.isComplete())
@@ -481,33 +707,64 @@ namespace xk::graphics_engine::vulkan
 
     template<bool ValidationLayersEnabled>
     SwapChainSupportDetails /*! Done*/
-    GpuWrapper<ValidationLayersEnabled>::querySwapChainSupport(const VkPhysicalDevice& gpu) const
+    GpuWrapper<ValidationLayersEnabled>::querySwapChainSupport(const VkPhysicalDevice& gpu, VkSurfaceKHR surface) const
     {
         SwapChainSupportDetails details{};
-        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(gpu, m_surface, &details.capabilities);
+        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(gpu, surface, &details.capabilities);
 
         u32 formatCount{};
-        vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, m_surface, &formatCount, nullptr);
+        vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, surface, &formatCount, nullptr);
 
         if(formatCount != 0)
         {
             details.formats.resize(formatCount);
-            vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, m_surface, &formatCount, details.formats.data());
+            vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, surface, &formatCount, details.formats.data());
         }
 
         u32 presentModeCount{};
-        vkGetPhysicalDeviceSurfacePresentModesKHR(gpu, m_surface, &presentModeCount, nullptr);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(gpu, surface, &presentModeCount, nullptr);
 
         if (presentModeCount != 0)
         {
             details.presentModes.resize(presentModeCount);
 
-            vkGetPhysicalDeviceSurfacePresentModesKHR(gpu, m_surface, &presentModeCount, details.presentModes.data());
+            vkGetPhysicalDeviceSurfacePresentModesKHR(gpu, surface, &presentModeCount, details.presentModes.data());
         }
 
         return details;
     }
 
+    template<bool ValidationLayersEnabled>
+    bool
+    GpuWrapper<ValidationLayersEnabled>::isPresentSupported(VkSurfaceKHR surface) const
+    {
+        VkBool32 presentSupport{ VK_FALSE };
+
+        vkGetPhysicalDeviceSurfaceSupportKHR(m_gpu, findPhysicalQueueFamilies().presentFamily.value(), surface, &presentSupport);
+
+        return presentSupport == VK_TRUE;
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    GpuWrapper<ValidationLayersEnabled>::destroySurface(VkSurfaceKHR surface)
+    {
+        vkDestroySurfaceKHR(m_instance, surface, nullptr);
+    }
+
+    template<bool ValidationLayersEnabled>
+    VkSurfaceKHR
+    GpuWrapper<ValidationLayersEnabled>::recreateSurface()
+    {
+        vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+
+        m_surface = EmptyGenericValue;
+
+        createPresentationSurface();
+
+        return m_surface;
+    }
+
     template<bool ValidationLayersEnabled>
     VkFormat /*! Done*/
     GpuWrapper<ValidationLayersEnabled>::findSupportedFormat(const std::vector<VkFormat>& formats, VkImageTiling tiling, VkFormatFeatureFlags features)
@@ -532,7 +789,7 @@ namespace xk::graphics_engine::vulkan
 
     template<bool ValidationLayersEnabled>
     u32
-    GpuWrapper<ValidationLayersEnabled>::findMemoryType(u32 typeFilter, VkMemoryPropertyFlagBits properties) const
+    GpuWrapper<ValidationLayersEnabled>::findMemoryType(u32 typeFilter, VkMemoryPropertyFlags properties) const
     {
         VkPhysicalDeviceMemoryProperties memoryProperties;
         vkGetPhysicalDeviceMemoryProperties(m_gpu, &memoryProperties);
@@ -548,9 +805,37 @@ namespace xk::graphics_engine::vulkan
         throw Exception::InstanceError("failed to find suitable memory type!");
     }
 
+    template<bool ValidationLayersEnabled>
+    bool
+    GpuWrapper<ValidationLayersEnabled>::hasMemoryType(u32 typeFilter, VkMemoryPropertyFlags properties) const
+    {
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(m_gpu, &memoryProperties);
+
+        for (u32 i{ 0 }; i < memoryProperties.memoryTypeCount; ++i)
+        {
+            if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    template<bool ValidationLayersEnabled>
+    VkMemoryPropertyFlags
+    GpuWrapper<ValidationLayersEnabled>::transientMemoryProperties(u32 typeFilter) const
+    {
+        static constexpr VkMemoryPropertyFlags LazyProperties{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT };
+
+        //Desktop GPUs usually have no lazily allocated type, the attachment then takes regular device memory
+        return hasMemoryType(typeFilter, LazyProperties) ? LazyProperties : VkMemoryPropertyFlags{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+    }
+
     template<bool ValidationLayersEnabled>
     std::tuple<VkBuffer, VkDeviceMemory>
-    GpuWrapper<ValidationLayersEnabled>::createVertexBuffer(u64 size, VkBufferUsageFlags usage, VkMemoryPropertyFlagBits properties)
+    GpuWrapper<ValidationLayersEnabled>::createVertexBuffer(u64 size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
     {
         VkBufferCreateInfo bufferInfo
         {
@@ -571,23 +856,106 @@ namespace xk::graphics_engine::vulkan
         VkMemoryRequirements memoryRequirements;
         vkGetBufferMemoryRequirements(m_logicalDevice, vertexBuffer, &memoryRequirements);
 
-        VkMemoryAllocateInfo allocInfo
+        VkDeviceMemory bufferMemory{};
+
+        try
+        {
+            bufferMemory = allocateMemory(memoryRequirements, properties, MemoryCategory::Buffer);
+        }
+        catch (const Exception&)
+        {
+            vkDestroyBuffer(m_logicalDevice, vertexBuffer, nullptr);
+
+            throw;
+        }
+
+        vkBindBufferMemory(m_logicalDevice, vertexBuffer, bufferMemory, 0);
+
+        return { vertexBuffer, bufferMemory };
+    }
+
+    template<bool ValidationLayersEnabled>
+    VkDeviceMemory
+    GpuWrapper<ValidationLayersEnabled>::allocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, MemoryCategory category)
+    {
+        static constexpr Size_t MaxEvictionAttempts{ 3 };
+
+        const auto memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, properties);
+        const auto heapIndex = m_memoryBudget->heapIndex(memoryTypeIndex);
+
+        //Going over budget makes the driver page or fail later, so caches are trimmed before we get there
+        if (m_memoryBudget->wouldExceedBudget(memoryTypeIndex, requirements.size))
+        {
+            m_memoryBudget->evict(heapIndex, requirements.size);
+        }
+
+        const VkMemoryAllocateInfo allocInfo
         {
             .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .allocationSize = memoryRequirements.size,
-            .memoryTypeIndex = findMemoryType(memoryRequirements.memoryTypeBits, properties)
+            .allocationSize = requirements.size,
+            .memoryTypeIndex = memoryTypeIndex
         };
 
-        VkDeviceMemory bufferMemory{};
+        VkResult result{ VK_ERROR_OUT_OF_DEVICE_MEMORY };
 
-        if (vkAllocateMemory(m_logicalDevice, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
+        for (Size_t attempt{ 0 }; attempt <= MaxEvictionAttempts; ++attempt)
         {
-            throw Exception::InstanceError("failed to allocate vertex buffer memory!");
+            VkDeviceMemory memory{};
+
+            result = vkAllocateMemory(m_logicalDevice, &allocInfo, nullptr, &memory);
+
+            if (result == VK_SUCCESS)
+            {
+                m_memoryBudget->onAllocate(memory, memoryTypeIndex, requirements.size, category);
+
+                return memory;
+            }
+
+            if (result != VK_ERROR_OUT_OF_DEVICE_MEMORY && result != VK_ERROR_OUT_OF_HOST_MEMORY)
+            {
+                throw Exception::InstanceError("failed to allocate memory", result);
+            }
+
+            const auto released = m_memoryBudget->evict(heapIndex, requirements.size);
+
+            //Memory retired in frames that completed meanwhile is given back too, callbacks free theirs before returning
+            m_deletionQueue.collect(m_logicalDevice);
+
+            if (released == 0)
+            {
+                break;
+            }
         }
 
-        vkBindBufferMemory(m_logicalDevice, vertexBuffer, bufferMemory, 0);
+        m_memoryBudget->logReport();
 
-        return { vertexBuffer, bufferMemory };
+        throw Exception::OutOfMemoryError(fmt::format("{} bytes of {}", requirements.size, toString(category)), result);
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    GpuWrapper<ValidationLayersEnabled>::freeMemory(VkDeviceMemory memory)
+    {
+        if (memory == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        m_memoryBudget->onFree(memory);
+
+        vkFreeMemory(m_logicalDevice, memory, nullptr);
+    }
+
+    template<bool ValidationLayersEnabled>
+    void
+    GpuWrapper<ValidationLayersEnabled>::releaseMemory(VkDeviceMemory memory)
+    {
+        if (memory == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        m_deletionQueue.push([this, memory](VkDevice) { freeMemory(memory); });
     }
 
     template<bool ValidationLayersEnabled>
@@ -682,7 +1050,7 @@ namespace xk::graphics_engine::vulkan
 
     template<bool ValidationLayersEnabled>
     std::tuple<VkImage, VkDeviceMemory>
-    GpuWrapper<ValidationLayersEnabled>::createImageWithInfo(const VkImageCreateInfo& info, VkMemoryPropertyFlagBits properties)
+    GpuWrapper<ValidationLayersEnabled>::createImageWithInfo(const VkImageCreateInfo& info, VkMemoryPropertyFlags properties, MemoryCategory category)
     {
         VkImage image{};
 
@@ -694,23 +1062,60 @@ namespace xk::graphics_engine::vulkan
         VkMemoryRequirements memoryRequirements;
         vkGetImageMemoryRequirements(m_logicalDevice, image, &memoryRequirements);
 
-        VkMemoryAllocateInfo allocInfo
+        VkDeviceMemory imageMemory{};
+
+        try
         {
-            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .allocationSize = memoryRequirements.size,
-            .memoryTypeIndex = findMemoryType(memoryRequirements.memoryTypeBits, properties)
-        };
+            imageMemory = allocateMemory(memoryRequirements, properties, category);
+        }
+        catch (const Exception&)
+        {
+            vkDestroyImage(m_logicalDevice, image, nullptr);
+
+            throw;
+        }
+
+        if (vkBindImageMemory(m_logicalDevice, image, imageMemory, 0) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to bind image memory!");
+        }
+
+        return { image, imageMemory };
+    }
+
+    template<bool ValidationLayersEnabled>
+    std::tuple<VkImage, VkDeviceMemory>
+    GpuWrapper<ValidationLayersEnabled>::createTransientAttachment(VkImageCreateInfo info, MemoryCategory category)
+    {
+        info.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+        VkImage image{};
+
+        if (vkCreateImage(m_logicalDevice, &info, nullptr, &image) != VK_SUCCESS)
+        {
+            throw Exception::InstanceError("failed to create transient attachment!");
+        }
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(m_logicalDevice, image, &memoryRequirements);
 
         VkDeviceMemory imageMemory{};
 
-        if (vkAllocateMemory(m_logicalDevice, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
+        //Lazily allocated memory is committed on demand, the budget still counts the full size as an upper bound
+        try
+        {
+            imageMemory = allocateMemory(memoryRequirements, transientMemoryProperties(memoryRequirements.memoryTypeBits), category);
+        }
+        catch (const Exception&)
         {
-            throw std::runtime_error("failed to allocate image memory!");
+            vkDestroyImage(m_logicalDevice, image, nullptr);
+
+            throw;
         }
 
         if (vkBindImageMemory(m_logicalDevice, image, imageMemory, 0) != VK_SUCCESS)
         {
-            throw std::runtime_error("failed to bind image memory!");
+            throw Exception::InstanceError("failed to bind transient attachment memory!");
         }
 
         return { image, imageMemory };
@@ -720,12 +1125,41 @@ namespace xk::graphics_engine::vulkan
     void
     GpuWrapper<ValidationLayersEnabled>::cleanUp()
     {
-        vkDestroyCommandPool(m_logicalDevice, m_commandPool, nullptr);
-        vkDestroyDevice(m_logicalDevice, nullptr);
+        if (m_logicalDevice != VK_NULL_HANDLE)
+        {
+            //Shutdown is the only place where waiting for the whole device is acceptable
+            vkDeviceWaitIdle(m_logicalDevice);
+
+            m_deletionQueue.flush(m_logicalDevice);
+        }
+
+        if (m_pipelineCache)
+        {
+            m_pipelineCache->save();
+        }
+
+        m_pipelineCache.reset();
+        m_descriptorHeap.reset();
+        m_memoryBudget.reset();
+
+        //A setup that failed half way, e.g. while recovering from a lost device, leaves later handles empty
+        if (m_logicalDevice != VK_NULL_HANDLE)
+        {
+            vkDestroyCommandPool(m_logicalDevice, m_commandPool, nullptr);
+            vkDestroyDevice(m_logicalDevice, nullptr);
+        }
+
+        if (m_instance == VK_NULL_HANDLE)
+        {
+            return;
+        }
 
         if constexpr (ValidationLayersEnabled)
         {
-            DestroyDebugUtilsMessengerEXT(m_instance, m_debugMessenger, nullptr);
+            if (m_debugMessenger != VK_NULL_HANDLE)
+            {
+                DestroyDebugUtilsMessengerEXT(m_instance, m_debugMessenger, nullptr);
+            }
         }
 
         vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
@@ -0,0 +1,207 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <utility/log.h>
+#include <utility/cast.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_memory_budget.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    MemoryBudget::MemoryBudget(VkPhysicalDevice gpu, bool isBudgetExtensionEnabled)
+        : m_gpu{ gpu }
+        , m_isBudgetExtensionEnabled{ isBudgetExtensionEnabled }
+    {
+        vkGetPhysicalDeviceMemoryProperties(m_gpu, &m_memoryProperties);
+
+        log::info("Memory budget: {}", m_isBudgetExtensionEnabled ? "VK_EXT_memory_budget" : "own heap accounting");
+    }
+
+    u32
+    MemoryBudget::heapIndex(u32 memoryTypeIndex) const
+    {
+        return m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    }
+
+    void
+    MemoryBudget::onAllocate(VkDeviceMemory memory, u32 memoryTypeIndex, u64 size, MemoryCategory category)
+    {
+        const auto heap = heapIndex(memoryTypeIndex);
+
+        std::scoped_lock lock{ m_mutex };
+
+        m_allocations.emplace(memory, Allocation{ .heapIndex = heap, .size = size, .category = category });
+
+        m_heapUsage[heap] += size;
+        m_categoryUsage[static_cast<Size_t>(category)] += size;
+    }
+
+    void
+    MemoryBudget::onFree(VkDeviceMemory memory)
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        const auto allocation = m_allocations.find(memory);
+
+        if (allocation == m_allocations.end())
+        {
+            return;
+        }
+
+        m_heapUsage[allocation->second.heapIndex] -= allocation->second.size;
+        m_categoryUsage[static_cast<Size_t>(allocation->second.category)] -= allocation->second.size;
+
+        m_allocations.erase(allocation);
+    }
+
+    std::vector<HeapBudget>
+    MemoryBudget::queryHeaps() const
+    {
+        std::vector<HeapBudget> heaps(m_memoryProperties.memoryHeapCount);
+
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT
+        };
+
+        if (m_isBudgetExtensionEnabled)
+        {
+            VkPhysicalDeviceMemoryProperties2 memoryProperties
+            {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+                .pNext = &budgetProperties
+            };
+
+            vkGetPhysicalDeviceMemoryProperties2(m_gpu, &memoryProperties);
+        }
+
+        std::scoped_lock lock{ m_mutex };
+
+        for (u32 i{ 0 }; i < heaps.size(); ++i)
+        {
+            const auto& heap = m_memoryProperties.memoryHeaps[i];
+
+            heaps[i].tracked = m_heapUsage[i];
+            heaps[i].isDeviceLocal = (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+
+            if (m_isBudgetExtensionEnabled)
+            {
+                heaps[i].budget = budgetProperties.heapBudget[i];
+                heaps[i].usage = budgetProperties.heapUsage[i];
+            }
+            else
+            {
+                heaps[i].budget = static_cast<u64>(static_cast<f64>(heap.size) * FallbackBudgetRatio);
+                heaps[i].usage = m_heapUsage[i];
+            }
+        }
+
+        return heaps;
+    }
+
+    u32
+    MemoryBudget::heapOf(VkDeviceMemory memory) const
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        const auto allocation = m_allocations.find(memory);
+
+        return allocation != m_allocations.end() ? allocation->second.heapIndex : Bad<u32>();
+    }
+
+    bool
+    MemoryBudget::wouldExceedBudget(u32 memoryTypeIndex, u64 size) const
+    {
+        const auto heaps = queryHeaps();
+        const auto& heap = heaps[heapIndex(memoryTypeIndex)];
+
+        return heap.usage + size > heap.budget;
+    }
+
+    u64
+    MemoryBudget::categoryUsage(MemoryCategory category) const
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        return m_categoryUsage[static_cast<Size_t>(category)];
+    }
+
+    MemoryBudget::CallbackId
+    MemoryBudget::addEvictionCallback(EvictionCallback callback)
+    {
+        std::scoped_lock lock{ m_callbackMutex };
+
+        const auto id = m_nextCallbackId++;
+
+        m_evictionCallbacks.emplace(id, std::move(callback));
+
+        return id;
+    }
+
+    void
+    MemoryBudget::removeEvictionCallback(CallbackId id)
+    {
+        std::scoped_lock lock{ m_callbackMutex };
+
+        m_evictionCallbacks.erase(id);
+    }
+
+    u64
+    MemoryBudget::evict(u32 heapIndex, u64 bytesNeeded)
+    {
+        std::vector<EvictionCallback> callbacks{};
+
+        //Called without the lock, a callback frees memory through the budget or adds and removes callbacks itself
+        {
+            std::scoped_lock lock{ m_callbackMutex };
+
+            callbacks.reserve(m_evictionCallbacks.size());
+
+            for (const auto& [id, callback] : m_evictionCallbacks)
+            {
+                callbacks.push_back(callback);
+            }
+        }
+
+        u64 released{ 0 };
+
+        //Callbacks run in registration order, the first registered cache is the first to give memory back
+        for (auto& callback : callbacks)
+        {
+            if (released >= bytesNeeded)
+            {
+                break;
+            }
+
+            released += callback(heapIndex, bytesNeeded - released);
+        }
+
+        log::warning("Memory pressure on heap {}: needed {} bytes, eviction released {} bytes", heapIndex, bytesNeeded, released);
+
+        return released;
+    }
+
+    void
+    MemoryBudget::logReport() const
+    {
+        const auto heaps = queryHeaps();
+
+        static constexpr f64 MiB{ 1024.0 * 1024.0 };
+
+        for (u32 i{ 0 }; i < heaps.size(); ++i)
+        {
+            log::info("Heap {}{}: {:.1f} / {:.1f} MiB used, {:.1f} MiB tracked",
+                      i,
+                      heaps[i].isDeviceLocal ? " (device local)" : "",
+                      static_cast<f64>(heaps[i].usage) / MiB,
+                      static_cast<f64>(heaps[i].budget) / MiB,
+                      static_cast<f64>(heaps[i].tracked) / MiB);
+        }
+
+        for (Size_t category{ 0 }; category < static_cast<Size_t>(MemoryCategory::Count); ++category)
+        {
+            log::info("  {}: {:.1f} MiB", toString(static_cast<MemoryCategory>(category)), static_cast<f64>(categoryUsage(static_cast<MemoryCategory>(category))) / MiB);
+        }
+    }
+}
@@ -0,0 +1,471 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <array>
+#include <cstring>
+
+#include <utility/cast.h>
+#include <utility/image_file.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_offscreen_target.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    void
+    ReadbackImage::savePng(const std::filesystem::path& path) const
+    {
+        io::writePng(path, width, height, pixels);
+    }
+
+    void
+    ReadbackImage::saveRaw(const std::filesystem::path& path) const
+    {
+        io::writeRaw(path, pixels);
+    }
+
+    template<bool ValidationEnabled>
+    OffscreenTarget<ValidationEnabled>::OffscreenTarget(std::weak_ptr<InstanceT> gpuWrapper, VkExtent2D extent)
+        : m_gpuWrapper{ gpuWrapper }
+        , m_dynamicRendering{ gpuWrapper.lock()->getDynamicRendering() }
+        , m_extent{ extent }
+    {
+        if (m_extent.width == 0 || m_extent.height == 0)
+        {
+            throw Exception::InstanceError("offscreen target needs a non-empty extent");
+        }
+
+        m_depthFormat = gpuWrapper.lock()->findSupportedFormat({ VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT },
+                                                          VK_IMAGE_TILING_OPTIMAL,
+                                                          VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+
+        createImages();
+
+        if (!usesDynamicRendering())
+        {
+            createRenderPass();
+        }
+
+        createReadbackBuffer();
+
+        m_evictionCallback = gpuWrapper.lock()->getMemoryBudget().addEvictionCallback([this](u32 heapIndex, u64) { return evictReadbackBuffer(heapIndex); });
+    }
+
+    template<bool ValidationEnabled>
+    OffscreenTarget<ValidationEnabled>::~OffscreenTarget()
+    {
+        auto gpuWrapper = m_gpuWrapper.lock();
+        auto& deletionQueue = gpuWrapper->getDeletionQueue();
+
+        gpuWrapper->getMemoryBudget().removeEvictionCallback(m_evictionCallback);
+
+        deletionQueue.destroyLater(m_framebuffer);
+        deletionQueue.destroyLater(m_renderPass);
+        deletionQueue.destroyLater(m_colorView);
+        deletionQueue.destroyLater(m_colorImage);
+        deletionQueue.destroyLater(m_depthView);
+        deletionQueue.destroyLater(m_depthImage);
+        deletionQueue.destroyLater(m_readbackBuffer);
+
+        gpuWrapper->releaseMemory(m_colorMemory);
+        gpuWrapper->releaseMemory(m_depthMemory);
+        gpuWrapper->releaseMemory(m_readbackMemory);
+    }
+
+    template<bool ValidationEnabled>
+    void
+    OffscreenTarget<ValidationEnabled>::createImages()
+    {
+        auto gpuWrapper = m_gpuWrapper.lock();
+        const auto device = gpuWrapper->getLogicalDevice();
+
+        const bool hasStencil{ m_depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || m_depthFormat == VK_FORMAT_D24_UNORM_S8_UINT };
+
+        struct Attachment
+        {
+            VkFormat            format;
+            VkImageUsageFlags   usage;
+            VkImageAspectFlags  aspect;
+
+            //Cleared and never stored, it does not need memory backing it outside of the render pass
+            bool                transient;
+
+            VkImage&            image;
+            VkDeviceMemory&     memory;
+            VkImageView&        view;
+        };
+
+        const std::array attachments
+        {
+            Attachment{ ColorFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_IMAGE_ASPECT_COLOR_BIT, false, m_colorImage, m_colorMemory, m_colorView },
+            Attachment{ m_depthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, hasStencil ? VkImageAspectFlags{ VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT } : VkImageAspectFlags{ VK_IMAGE_ASPECT_DEPTH_BIT }, true, m_depthImage, m_depthMemory, m_depthView }
+        };
+
+        for (const auto& attachment : attachments)
+        {
+            const VkImageCreateInfo imageInfo
+            {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                .imageType = VK_IMAGE_TYPE_2D,
+                .format = attachment.format,
+                .extent = { m_extent.width, m_extent.height, 1 },
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .tiling = VK_IMAGE_TILING_OPTIMAL,
+                .usage = attachment.usage,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+            };
+
+            std::tie(attachment.image, attachment.memory) = attachment.transient
+                                                            ? gpuWrapper->createTransientAttachment(imageInfo, MemoryCategory::Other)
+                                                            : gpuWrapper->createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryCategory::Other);
+
+            const VkImageViewCreateInfo viewInfo
+            {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                .image = attachment.image,
+                .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                .format = attachment.format,
+                .subresourceRange = { attachment.aspect, 0, 1, 0, 1 }
+            };
+
+            if (vkCreateImageView(device, &viewInfo, nullptr, &attachment.view) != VK_SUCCESS)
+            {
+                throw Exception::InstanceError("failed to create offscreen image view!");
+            }
+        }
+    }
+
+    template<bool ValidationEnabled>
+    void
+    OffscreenTarget<ValidationEnabled>::createRenderPass()
+    {
+        const auto device = m_gpuWrapper.lock()->getLogicalDevice();
+
+        const std::array<VkAttachmentDescription, 2> attachments
+        {
+            VkAttachmentDescription
+            {
+                .format = ColorFormat,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+                .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                //Left ready for the copy into the readback buffer instead of presentation
+                .finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+            },
+            VkAttachmentDescription
+            {
+                .format = m_depthFormat,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+            }
+        };
+
+        const VkAttachmentReference colorAttachmentRef{ 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+        const VkAttachmentReference depthAttachmentRef{ 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+        const VkSubpassDescription subpass
+        {
+            .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .colorAttachmentCount = 1,
+            .pColorAttachments = &colorAttachmentRef,
+            .pDepthStencilAttachment = &depthAttachmentRef
+        };
+
+        const std::array<VkSubpassDependency, 2> dependencies
+        {
+            VkSubpassDependency
+            {
+                .srcSubpass = VK_SUBPASS_EXTERNAL,
+                .dstSubpass = 0,
+                .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+                .srcAccessMask = 0,
+                .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+            },
+            VkSubpassDependency
+            {
+                .srcSubpass = 0,
+                .dstSubpass = VK_SUBPASS_EXTERNAL,
+                .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
+                .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT
+            }
+        };
+
+        const VkRenderPassCreateInfo renderPassInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+            .attachmentCount = to_u32(attachments.size()),
+            .pAttachments = attachments.data(),
+            .subpassCount = 1,
+            .pSubpasses = &subpass,
+            .dependencyCount = to_u32(dependencies.size()),
+            .pDependencies = dependencies.data()
+        };
+
+        if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS)
+        {
+            throw Exception::InstanceError("failed to create offscreen render pass!");
+        }
+
+        const std::array views{ m_colorView, m_depthView };
+
+        const VkFramebufferCreateInfo framebufferInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+            .renderPass = m_renderPass,
+            .attachmentCount = to_u32(views.size()),
+            .pAttachments = views.data(),
+            .width = m_extent.width,
+            .height = m_extent.height,
+            .layers = 1
+        };
+
+        if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &m_framebuffer) != VK_SUCCESS)
+        {
+            throw Exception::InstanceError("failed to create offscreen framebuffer!");
+        }
+    }
+
+    template<bool ValidationEnabled>
+    void
+    OffscreenTarget<ValidationEnabled>::createReadbackBuffer()
+    {
+        //Host coherent, so reading after the fence needs no invalidate
+        std::tie(m_readbackBuffer, m_readbackMemory) = m_gpuWrapper.lock()->createVertexBuffer(readbackSize(),
+                                                                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+
+    template<bool ValidationEnabled>
+    u64
+    OffscreenTarget<ValidationEnabled>::evictReadbackBuffer(u32 heapIndex)
+    {
+        auto gpuWrapper = m_gpuWrapper.lock();
+
+        if (m_readbackPending || m_readbackBuffer == VK_NULL_HANDLE || gpuWrapper->getMemoryBudget().heapOf(m_readbackMemory) != heapIndex)
+        {
+            return 0;
+        }
+
+        //No frame uses the buffer between readback and the next endRendering, so it is freed right away
+        vkDestroyBuffer(gpuWrapper->getLogicalDevice(), m_readbackBuffer, nullptr);
+
+        gpuWrapper->freeMemory(m_readbackMemory);
+
+        m_readbackBuffer = VK_NULL_HANDLE;
+        m_readbackMemory = VK_NULL_HANDLE;
+
+        return readbackSize();
+    }
+
+    template<bool ValidationEnabled>
+    void
+    OffscreenTarget<ValidationEnabled>::beginRendering(VkCommandBuffer commandBuffer, VkClearColorValue clearColor) const
+    {
+        if (usesDynamicRendering())
+        {
+            const bool hasStencil{ m_depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || m_depthFormat == VK_FORMAT_D24_UNORM_S8_UINT };
+
+            m_dynamicRendering->begin(commandBuffer, RenderTarget
+            {
+                .colorImage = m_colorImage,
+                .colorView = m_colorView,
+                .depthImage = m_depthImage,
+                .depthView = m_depthView,
+                .depthAspect = hasStencil ? VkImageAspectFlags{ VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT } : VkImageAspectFlags{ VK_IMAGE_ASPECT_DEPTH_BIT },
+                .extent = m_extent,
+                .clearColor = clearColor,
+                .finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+            });
+
+            return;
+        }
+
+        const std::array<VkClearValue, 2> clearValues
+        {
+            VkClearValue{ .color = clearColor },
+            VkClearValue{ .depthStencil = { 1.0f, 0 } }
+        };
+
+        const VkRenderPassBeginInfo renderPassInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .renderPass = m_renderPass,
+            .framebuffer = m_framebuffer,
+            .renderArea = { { 0, 0 }, m_extent },
+            .clearValueCount = to_u32(clearValues.size()),
+            .pClearValues = clearValues.data()
+        };
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    template<bool ValidationEnabled>
+    void
+    OffscreenTarget<ValidationEnabled>::endRendering(VkCommandBuffer commandBuffer)
+    {
+        if (m_readbackBuffer == VK_NULL_HANDLE)
+        {
+            createReadbackBuffer();
+        }
+
+        m_readbackPending = true;
+
+        if (usesDynamicRendering())
+        {
+            m_dynamicRendering->end(commandBuffer, RenderTarget
+            {
+                .colorImage = m_colorImage,
+                .colorView = m_colorView,
+                .finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+            });
+        }
+        else
+        {
+            vkCmdEndRenderPass(commandBuffer);
+        }
+
+        //Rows are tightly packed, matching ReadbackImage
+        const VkBufferImageCopy region
+        {
+            .bufferOffset = 0,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+            .imageOffset = { 0, 0, 0 },
+            .imageExtent = { m_extent.width, m_extent.height, 1 }
+        };
+
+        vkCmdCopyImageToBuffer(commandBuffer, m_colorImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_readbackBuffer, 1, &region);
+
+        const VkBufferMemoryBarrier barrier
+        {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = m_readbackBuffer,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE
+        };
+
+        vkCmdPipelineBarrier(commandBuffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_HOST_BIT,
+                             0,
+                             0, nullptr,
+                             1, &barrier,
+                             0, nullptr);
+    }
+
+    template<bool ValidationEnabled>
+    void
+    OffscreenTarget<ValidationEnabled>::configurePipeline(PipelineConfigInfo& config) const
+    {
+        if (usesDynamicRendering())
+        {
+            config.renderPass = VK_NULL_HANDLE;
+            config.colorAttachmentFormat = ColorFormat;
+            config.depthAttachmentFormat = m_depthFormat;
+
+            return;
+        }
+
+        config.renderPass = m_renderPass;
+        config.colorAttachmentFormat = VK_FORMAT_UNDEFINED;
+        config.depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+    }
+
+    template<bool ValidationEnabled>
+    ReadbackImage
+    OffscreenTarget<ValidationEnabled>::render(const std::function<void(VkCommandBuffer)>& record, VkClearColorValue clearColor)
+    {
+        auto gpuWrapper = m_gpuWrapper.lock();
+
+        auto commandBuffer = gpuWrapper->beginSingleTimeCommands();
+
+        const VkViewport viewport
+        {
+            .x = 0.0f,
+            .y = 0.0f,
+            .width = to_f32(m_extent.width),
+            .height = to_f32(m_extent.height),
+            .minDepth = 0.0f,
+            .maxDepth = 1.0f
+        };
+
+        const VkRect2D scissor{ { 0, 0 }, m_extent };
+
+        beginRendering(commandBuffer, clearColor);
+
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        record(commandBuffer);
+
+        endRendering(commandBuffer);
+
+        //Waits for the queue, the readback buffer is complete afterwards
+        gpuWrapper->endSingleTimeCommands(&commandBuffer);
+
+        //With the queue idle nothing retired so far is in use, headless setups have no swap chain collecting for them
+        auto& deletionQueue = gpuWrapper->getDeletionQueue();
+
+        deletionQueue.beginFrame();
+        deletionQueue.collect(gpuWrapper->getLogicalDevice());
+
+        return readback();
+    }
+
+    template<bool ValidationEnabled>
+    ReadbackImage
+    OffscreenTarget<ValidationEnabled>::readback()
+    {
+        if (!m_readbackPending)
+        {
+            throw Exception::InstanceError("no offscreen frame waits to be read back!");
+        }
+
+        ReadbackImage image
+        {
+            .width = m_extent.width,
+            .height = m_extent.height,
+            .pixels = std::vector<u8>(Size_t{ m_extent.width } * m_extent.height * 4)
+        };
+
+        const auto device = m_gpuWrapper.lock()->getLogicalDevice();
+
+        void* data{ nullptr };
+
+        if (vkMapMemory(device, m_readbackMemory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS)
+        {
+            throw Exception::InstanceError("failed to map the offscreen readback buffer!");
+        }
+
+        std::memcpy(image.pixels.data(), data, image.pixels.size());
+
+        vkUnmapMemory(device, m_readbackMemory);
+
+        m_readbackPending = false;
+
+        return image;
+    }
+
+    template class OffscreenTarget<true>;
+    template class OffscreenTarget<false>;
+}
@@ -0,0 +1,292 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+#include <utility/log.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_cache.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    namespace
+    {
+        u64 fnv1a(std::span<const u8> data)
+        {
+            u64 hash{ 0xcbf29ce484222325ull };
+
+            for (const auto byte : data)
+            {
+                hash ^= byte;
+                hash *= 0x100000001b3ull;
+            }
+
+            return hash;
+        }
+
+        bool isColdStartForced()
+        {
+            const char* environment = std::getenv(PipelineCache::EnvironmentVariable.data());
+
+            return environment != nullptr && std::string_view{ environment } == "cold";
+        }
+    }
+
+    PipelineCache::PipelineCache(VkDevice device, const VkPhysicalDeviceProperties& gpuProperties, std::filesystem::path path)
+        : m_device{ device }
+        , m_gpuProperties{ gpuProperties }
+        , m_path{ std::move(path) }
+    {
+        const auto blob = isColdStartForced() ? std::vector<u8>{} : load();
+
+        m_isWarm = !blob.empty();
+
+        const VkPipelineCacheCreateInfo cacheInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .initialDataSize = blob.size(),
+            .pInitialData = blob.empty() ? nullptr : blob.data()
+        };
+
+        if (vkCreatePipelineCache(m_device, &cacheInfo, nullptr, &m_cache) != VK_SUCCESS)
+        {
+            throw Exception::PipelineError("failed to create pipeline cache");
+        }
+
+        log::info("Pipeline cache: {} start from {}", m_isWarm ? "warm" : "cold", m_path.string());
+    }
+
+    PipelineCache::~PipelineCache()
+    {
+        for (auto workerCache : m_workerCaches)
+        {
+            vkDestroyPipelineCache(m_device, workerCache, nullptr);
+        }
+
+        vkDestroyPipelineCache(m_device, m_cache, nullptr);
+    }
+
+    std::filesystem::path
+    PipelineCache::defaultPath()
+    {
+        static constexpr std::string_view FileName{ "pipeline_cache.bin" };
+
+#ifdef _WIN32
+        if (const char* localAppData = std::getenv("LOCALAPPDATA"); localAppData != nullptr)
+        {
+            return std::filesystem::path{ localAppData } / "xk" / FileName;
+        }
+#else
+        if (const char* cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome != nullptr && *cacheHome != '\0')
+        {
+            return std::filesystem::path{ cacheHome } / "xk" / FileName;
+        }
+
+        if (const char* home = std::getenv("HOME"); home != nullptr)
+        {
+            return std::filesystem::path{ home } / ".cache" / "xk" / FileName;
+        }
+#endif
+
+        return std::filesystem::temp_directory_path() / "xk" / FileName;
+    }
+
+    bool
+    PipelineCache::isCompatible(std::span<const u8> blob, const VkPhysicalDeviceProperties& gpuProperties)
+    {
+        VkPipelineCacheHeaderVersionOne header{};
+
+        if (blob.size() < sizeof(header))
+        {
+            return false;
+        }
+
+        //The blob has no alignment guarantees, so the header is copied out instead of cast
+        std::memcpy(&header, blob.data(), sizeof(header));
+
+        return header.headerSize >= sizeof(header)
+            && header.headerSize <= blob.size()
+            && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            && header.vendorID == gpuProperties.vendorID
+            && header.deviceID == gpuProperties.deviceID
+            && std::equal(std::begin(header.pipelineCacheUUID), std::end(header.pipelineCacheUUID), std::begin(gpuProperties.pipelineCacheUUID));
+    }
+
+    std::vector<u8>
+    PipelineCache::load() const
+    {
+        std::ifstream file{ m_path, std::ios::binary };
+
+        if (!file.is_open())
+        {
+            return {};
+        }
+
+        FileHeader header{};
+
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != FileHeader::Magic || header.version != FileHeader::Version)
+        {
+            log::warning("Pipeline cache: {} is not a pipeline cache file, ignoring it", m_path.string());
+
+            return {};
+        }
+
+        std::error_code error{};
+
+        const auto fileSize = std::filesystem::file_size(m_path, error);
+
+        //The size comes from the file, so it is checked before anything is allocated for it
+        if (error || fileSize < sizeof(header) || header.dataSize != fileSize - sizeof(header))
+        {
+            log::warning("Pipeline cache: {} is truncated or corrupted, ignoring it", m_path.string());
+
+            return {};
+        }
+
+        std::vector<u8> blob(static_cast<size_t>(header.dataSize));
+
+        if (!file.read(reinterpret_cast<char*>(blob.data()), static_cast<std::streamsize>(blob.size())) || fnv1a(blob) != header.checksum)
+        {
+            log::warning("Pipeline cache: {} is truncated or corrupted, ignoring it", m_path.string());
+
+            return {};
+        }
+
+        if (!isCompatible(blob, m_gpuProperties))
+        {
+            log::info("Pipeline cache: {} was written by another device or driver, ignoring it", m_path.string());
+
+            return {};
+        }
+
+        return blob;
+    }
+
+    VkPipelineCache
+    PipelineCache::createWorkerCache()
+    {
+        //Seeded with the main cache, the blob loaded from disk and what was merged since, otherwise every compile starts cold
+        //reading the main cache needs no lock, VkPipelineCache is internally synchronized
+        std::vector<u8> data{};
+
+        size_t size{ 0 };
+
+        if (vkGetPipelineCacheData(m_device, m_cache, &size, nullptr) == VK_SUCCESS && size > 0)
+        {
+            data.resize(size);
+
+            if (vkGetPipelineCacheData(m_device, m_cache, &size, data.data()) == VK_SUCCESS)
+            {
+                data.resize(size);
+            }
+            else
+            {
+                data.clear();
+            }
+        }
+
+        const VkPipelineCacheCreateInfo cacheInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .initialDataSize = data.size(),
+            .pInitialData = data.empty() ? nullptr : data.data()
+        };
+
+        VkPipelineCache workerCache{ VK_NULL_HANDLE };
+
+        if (vkCreatePipelineCache(m_device, &cacheInfo, nullptr, &workerCache) != VK_SUCCESS)
+        {
+            throw Exception::PipelineError("failed to create worker pipeline cache");
+        }
+
+        std::scoped_lock lock{ m_workerMutex };
+
+        m_workerCaches.push_back(workerCache);
+
+        return workerCache;
+    }
+
+    void
+    PipelineCache::mergeWorkerCaches()
+    {
+        std::scoped_lock lock{ m_workerMutex };
+
+        if (m_workerCaches.empty())
+        {
+            return;
+        }
+
+        if (vkMergePipelineCaches(m_device, m_cache, static_cast<u32>(m_workerCaches.size()), m_workerCaches.data()) != VK_SUCCESS)
+        {
+            log::warning("Pipeline cache: failed to merge {} worker caches", m_workerCaches.size());
+        }
+    }
+
+    bool
+    PipelineCache::save()
+    {
+        mergeWorkerCaches();
+
+        size_t size{ 0 };
+
+        if (vkGetPipelineCacheData(m_device, m_cache, &size, nullptr) != VK_SUCCESS || size == 0)
+        {
+            return false;
+        }
+
+        std::vector<u8> blob(size);
+
+        if (vkGetPipelineCacheData(m_device, m_cache, &size, blob.data()) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        blob.resize(size);
+
+        const FileHeader header
+        {
+            .dataSize = blob.size(),
+            .checksum = fnv1a(blob)
+        };
+
+        std::error_code error{};
+
+        std::filesystem::create_directories(m_path.parent_path(), error);
+
+        auto temporaryPath = m_path;
+        temporaryPath += ".tmp";
+
+        {
+            std::ofstream file{ temporaryPath, std::ios::binary | std::ios::trunc };
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+
+            if (!file.good())
+            {
+                log::warning("Pipeline cache: failed to write {}", temporaryPath.string());
+
+                return false;
+            }
+        }
+
+        //Rename replaces the previous cache in one step, readers see either the old or the new file
+        std::filesystem::rename(temporaryPath, m_path, error);
+
+        if (error)
+        {
+            log::warning("Pipeline cache: failed to replace {}: {}", m_path.string(), error.message());
+
+            return false;
+        }
+
+        log::info("Pipeline cache: saved {} bytes to {}", blob.size(), m_path.string());
+
+        return true;
+    }
+}
@@ -0,0 +1,467 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <bit>
+#include <array>
+#include <chrono>
+
+#include <utility/log.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_compiler.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    namespace
+    {
+        class FieldWriter
+        {
+        public:
+            template<typename T>
+            FieldWriter& operator<<(const T& value)
+            {
+                if constexpr (std::is_floating_point_v<T>)
+                {
+                    //Compare the bits so 0.0f and -0.0f stay distinct like they are for the driver
+                    return *this << std::bit_cast<std::conditional_t<sizeof(T) == 4, u32, u64>>(value);
+                }
+                else if constexpr (std::is_pointer_v<T>)
+                {
+                    return *this << reinterpret_cast<std::uintptr_t>(value);
+                }
+                else
+                {
+                    m_words.push_back(static_cast<u64>(value));
+
+                    return *this;
+                }
+            }
+
+            FieldWriter& operator<<(const VkStencilOpState& state)
+            {
+                return *this << state.failOp << state.passOp << state.depthFailOp << state.compareOp
+                             << state.compareMask << state.writeMask << state.reference;
+            }
+
+            [[nodiscard]] inline auto& words() const { return m_words; }
+
+        private:
+            std::vector<u64> m_words{};
+        };
+
+        //Field by field, struct padding and the self referencing pointers of the config must not leak into hash or comparison
+        std::vector<u64>
+        fieldsOf(const PipelineDescription& description)
+        {
+            const auto& config = description.config;
+
+            FieldWriter writer{};
+
+            //Counts first, so fields of different lists cannot line up to the same words
+            writer << config.bindingDescriptions.size() << config.attributeDescriptions.size() << config.dynamicStateEnables.size()
+                   << description.specialization.size();
+
+            for (const auto& binding : config.bindingDescriptions)
+            {
+                writer << binding.binding << binding.stride << binding.inputRate;
+            }
+
+            for (const auto& attribute : config.attributeDescriptions)
+            {
+                writer << attribute.location << attribute.binding << attribute.format << attribute.offset;
+            }
+
+            for (const auto dynamicState : config.dynamicStateEnables)
+            {
+                writer << dynamicState;
+            }
+
+            const auto& inputAssembly = config.inputAssemblyStateCreateInfo;
+            writer << inputAssembly.topology << inputAssembly.primitiveRestartEnable;
+
+            writer << config.viewportStateCreateInfo.viewportCount << config.viewportStateCreateInfo.scissorCount;
+
+            const auto& rasterization = config.rasterizationStateCreateInfo;
+            writer << rasterization.depthClampEnable << rasterization.rasterizerDiscardEnable << rasterization.polygonMode
+                   << rasterization.cullMode << rasterization.frontFace << rasterization.depthBiasEnable
+                   << rasterization.depthBiasConstantFactor << rasterization.depthBiasClamp << rasterization.depthBiasSlopeFactor
+                   << rasterization.lineWidth;
+
+            const auto& multisample = config.multisampleStateCreateInfo;
+            writer << multisample.rasterizationSamples << multisample.sampleShadingEnable << multisample.minSampleShading
+                   << multisample.alphaToCoverageEnable << multisample.alphaToOneEnable;
+
+            const auto& blendAttachment = config.colorBlendAttachmentState;
+            writer << blendAttachment.blendEnable << blendAttachment.srcColorBlendFactor << blendAttachment.dstColorBlendFactor
+                   << blendAttachment.colorBlendOp << blendAttachment.srcAlphaBlendFactor << blendAttachment.dstAlphaBlendFactor
+                   << blendAttachment.alphaBlendOp << blendAttachment.colorWriteMask;
+
+            const auto& colorBlend = config.colorBlendStateCreateInfo;
+            writer << colorBlend.logicOpEnable << colorBlend.logicOp << colorBlend.attachmentCount;
+
+            for (const auto constant : colorBlend.blendConstants)
+            {
+                writer << constant;
+            }
+
+            const auto& depthStencil = config.depthStencilStateCreateInfo;
+            writer << depthStencil.depthTestEnable << depthStencil.depthWriteEnable << depthStencil.depthCompareOp
+                   << depthStencil.depthBoundsTestEnable << depthStencil.stencilTestEnable << depthStencil.front << depthStencil.back
+                   << depthStencil.minDepthBounds << depthStencil.maxDepthBounds;
+
+            writer << config.pipelineLayout << config.renderPass << config.subPass << config.colorAttachmentFormat << config.depthAttachmentFormat
+                   << description.vertexShader << description.fragmentShader;
+
+            for (const auto& constant : description.specialization)
+            {
+                writer << constant.constantId << constant.value;
+            }
+
+            return writer.words();
+        }
+    }
+
+    u64
+    PipelineDescription::hash() const
+    {
+        u64 hash{ 0xcbf29ce484222325ull };
+
+        for (const auto word : fieldsOf(*this))
+        {
+            hash ^= word + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        }
+
+        return hash;
+    }
+
+    bool
+    PipelineDescription::operator==(const PipelineDescription& other) const
+    {
+        return fieldsOf(*this) == fieldsOf(other);
+    }
+
+    void
+    PipelineHandle::wait() const
+    {
+        if (m_state)
+        {
+            m_state->status.wait(Status::Pending, std::memory_order_acquire);
+        }
+    }
+
+    PipelineCompiler::PipelineCompiler(VkDevice device,
+                                       PipelineCache& pipelineCache,
+                                       DeletionQueue& deletionQueue,
+                                       VkPipelineLayout defaultLayout,
+                                       core::async::TaskScheduler& scheduler)
+        : m_device{ device }
+        , m_pipelineCache{ pipelineCache }
+        , m_deletionQueue{ deletionQueue }
+        , m_defaultLayout{ defaultLayout }
+        , m_scheduler{ scheduler }
+    {}
+
+    PipelineCompiler::~PipelineCompiler()
+    {
+        //Workers reference this object, so it has to outlive every scheduled compile
+        waitIdle();
+
+        for (const auto& [description, handle] : m_pipelines)
+        {
+            if (handle.isReady())
+            {
+                m_deletionQueue.destroyLater(handle.m_state->pipeline.load(std::memory_order_acquire));
+            }
+        }
+    }
+
+    PipelineHandle
+    PipelineCompiler::compile(PipelineDescription description)
+    {
+        if (!description.config.pipelineLayout)
+        {
+            description.config.pipelineLayout = m_defaultLayout;
+        }
+
+        std::shared_ptr<PipelineHandle::State> state{};
+
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            const auto existing = m_pipelines.find(description);
+
+            //A failed compile is tried again, e.g. once its shader was fixed or its render pass was recreated
+            if (existing != m_pipelines.end() && existing->second.status() != PipelineHandle::Status::Failed)
+            {
+                return existing->second;
+            }
+
+            state = std::make_shared<PipelineHandle::State>();
+
+            if (existing != m_pipelines.end())
+            {
+                existing->second = PipelineHandle{ state };
+            }
+            else
+            {
+                m_pipelines.emplace(description, PipelineHandle{ state });
+            }
+        }
+
+        m_pendingCount.fetch_add(1, std::memory_order_acq_rel);
+
+        m_scheduler.schedule([this, description = std::move(description), state]
+        {
+            compileOnWorker(description, state);
+        });
+
+        return PipelineHandle{ state };
+    }
+
+    void
+    PipelineCompiler::compileOnWorker(const PipelineDescription& description, const std::shared_ptr<PipelineHandle::State>& state)
+    {
+        const auto cache = acquireWorkerCache();
+
+        try
+        {
+            state->pipeline.store(build(description, cache), std::memory_order_release);
+            state->status.store(PipelineHandle::Status::Ready, std::memory_order_release);
+        }
+        catch (const std::exception& exception)
+        {
+            log::error("Pipeline compiler: {}", exception.what());
+
+            state->status.store(PipelineHandle::Status::Failed, std::memory_order_release);
+        }
+
+        state->status.notify_all();
+
+        releaseWorkerCache(cache);
+
+        std::scoped_lock lock{ m_pendingMutex };
+
+        if (m_pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            m_pendingCondition.notify_all();
+        }
+    }
+
+    VkPipeline
+    PipelineCompiler::build(const PipelineDescription& description, VkPipelineCache cache) const
+    {
+        const auto& config = description.config;
+
+        if (!config.renderPass && config.colorAttachmentFormat == VK_FORMAT_UNDEFINED)
+        {
+            throw Exception::PipelineError("no renderPass or attachment formats provided in config");
+        }
+
+        //Without a render pass the attachment formats are chained instead, the pipeline is then usable with dynamic rendering
+        const VkPipelineRenderingCreateInfoKHR renderingInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR,
+            .colorAttachmentCount = 1,
+            .pColorAttachmentFormats = &config.colorAttachmentFormat,
+            .depthAttachmentFormat = config.depthAttachmentFormat
+        };
+
+        static constexpr auto NumberOfShaders{ 2 }; //vertex + fragment shader
+
+        //Every constant is 32 bit, so entry i reads the i-th word of the data
+        std::vector<VkSpecializationMapEntry> specializationEntries{};
+        std::vector<u32> specializationData{};
+
+        for (const auto& constant : description.specialization)
+        {
+            specializationEntries.push_back(VkSpecializationMapEntry
+            {
+                .constantID = constant.constantId,
+                .offset = static_cast<u32>(specializationData.size() * sizeof(u32)),
+                .size = sizeof(u32)
+            });
+
+            specializationData.push_back(constant.value);
+        }
+
+        const VkSpecializationInfo specializationInfo
+        {
+            .mapEntryCount = static_cast<u32>(specializationEntries.size()),
+            .pMapEntries = specializationEntries.data(),
+            .dataSize = specializationData.size() * sizeof(u32),
+            .pData = specializationData.data()
+        };
+
+        const auto* specialization = specializationEntries.empty() ? nullptr : &specializationInfo;
+
+        const std::array<VkPipelineShaderStageCreateInfo, NumberOfShaders> shaderStages
+        {
+            VkPipelineShaderStageCreateInfo
+            {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage = VK_SHADER_STAGE_VERTEX_BIT,
+                .module = description.vertexShader,
+                .pName = "main",
+                .pSpecializationInfo = specialization
+            },
+            VkPipelineShaderStageCreateInfo
+            {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+                .module = description.fragmentShader,
+                .pName = "main",
+                .pSpecializationInfo = specialization
+            }
+        };
+
+        const VkPipelineVertexInputStateCreateInfo vertexInputInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+            .vertexBindingDescriptionCount = static_cast<u32>(config.bindingDescriptions.size()),
+            .pVertexBindingDescriptions = config.bindingDescriptions.data(),
+            .vertexAttributeDescriptionCount = static_cast<u32>(config.attributeDescriptions.size()),
+            .pVertexAttributeDescriptions = config.attributeDescriptions.data()
+        };
+
+        //The config points into itself, after being copied into the task those pointers refer to the original
+        auto colorBlendState = config.colorBlendStateCreateInfo;
+        colorBlendState.pAttachments = &config.colorBlendAttachmentState;
+
+        auto dynamicState = config.dynamicStateCreateInfo;
+        dynamicState.dynamicStateCount = static_cast<u32>(config.dynamicStateEnables.size());
+        dynamicState.pDynamicStates = config.dynamicStateEnables.data();
+
+        const VkGraphicsPipelineCreateInfo pipelineInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            .pNext = config.renderPass ? nullptr : &renderingInfo,
+            .stageCount = NumberOfShaders,
+            .pStages = shaderStages.data(),
+            .pVertexInputState = &vertexInputInfo,
+            .pInputAssemblyState = &config.inputAssemblyStateCreateInfo,
+            .pViewportState = &config.viewportStateCreateInfo,
+            .pRasterizationState = &config.rasterizationStateCreateInfo,
+            .pMultisampleState = &config.multisampleStateCreateInfo,
+            .pDepthStencilState = &config.depthStencilStateCreateInfo,
+            .pColorBlendState = &colorBlendState,
+            .pDynamicState = &dynamicState,
+            .layout = config.pipelineLayout,
+            .renderPass = config.renderPass,
+            .subpass = config.subPass,
+            .basePipelineHandle = VK_NULL_HANDLE,
+            .basePipelineIndex = -1
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+
+        VkPipeline pipeline{ VK_NULL_HANDLE };
+
+        if (const auto result = vkCreateGraphicsPipelines(m_device, cache, 1, &pipelineInfo, nullptr, &pipeline); result != VK_SUCCESS)
+        {
+            throw Exception::PipelineError(std::string{ "failed to create graphics pipeline, error code: " } + getVulkanErrorName(result).data());
+        }
+
+        //Comparing this between a run with XK_PIPELINE_CACHE=cold and a normal run shows what the cache saves
+        const std::chrono::duration<f64, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+
+        log::debug("Graphics pipeline created in {:.2f} ms ({} pipeline cache)", elapsed.count(), m_pipelineCache.isWarm() ? "warm" : "cold");
+
+        return pipeline;
+    }
+
+    VkPipelineCache
+    PipelineCompiler::acquireWorkerCache()
+    {
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            if (!m_idleWorkerCaches.empty())
+            {
+                const auto cache = m_idleWorkerCaches.back();
+
+                m_idleWorkerCaches.pop_back();
+
+                return cache;
+            }
+        }
+
+        //At most one cache per concurrently running compile, the pipeline cache owns and merges them
+        return m_pipelineCache.createWorkerCache();
+    }
+
+    void
+    PipelineCompiler::releaseWorkerCache(VkPipelineCache cache)
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        m_idleWorkerCaches.push_back(cache);
+    }
+
+    void
+    PipelineCompiler::setFallback(PipelineHandle fallback, FallbackMode mode)
+    {
+        m_fallback = std::move(fallback);
+        m_fallbackMode = mode;
+    }
+
+    VkPipeline
+    PipelineCompiler::resolve(const PipelineHandle& handle) const
+    {
+        if (handle.isReady())
+        {
+            return handle.get();
+        }
+
+        if (m_fallbackMode == FallbackMode::UseFallback && m_fallback.isReady())
+        {
+            return m_fallback.get();
+        }
+
+        handle.wait();
+
+        return handle.get();
+    }
+
+    void
+    PipelineCompiler::replace(const PipelineHandle& target, const PipelineHandle& replacement)
+    {
+        if (!target.isValid() || !replacement.isReady())
+        {
+            throw Exception::PipelineError("pipeline replacement requires a valid target and a ready replacement");
+        }
+
+        //Replacing a pipeline with itself would retire the pipeline that is still in use
+        if (target.m_state == replacement.m_state)
+        {
+            return;
+        }
+
+        std::scoped_lock lock{ m_mutex };
+
+        std::erase_if(m_pipelines, [&target](const auto& entry) { return entry.second.m_state == target.m_state; });
+
+        //The description of the replacement now resolves to target, which took over its pipeline
+        for (auto& [description, handle] : m_pipelines)
+        {
+            if (handle.m_state == replacement.m_state)
+            {
+                handle = target;
+            }
+        }
+
+        const auto retired = target.m_state->pipeline.exchange(replacement.get(), std::memory_order_acq_rel);
+
+        target.m_state->status.store(PipelineHandle::Status::Ready, std::memory_order_release);
+
+        m_deletionQueue.destroyLater(retired);
+    }
+
+    void
+    PipelineCompiler::waitIdle() const
+    {
+        std::unique_lock lock{ m_pendingMutex };
+
+        m_pendingCondition.wait(lock, [this] { return pendingCount() == 0; });
+    }
+}
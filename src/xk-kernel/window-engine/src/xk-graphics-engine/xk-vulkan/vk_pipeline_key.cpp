@@ -0,0 +1,331 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <bit>
+#include <limits>
+#include <string>
+#include <cstring>
+#include <algorithm>
+
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_key.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    namespace
+    {
+        template<typename Handle>
+        u64 handleToKey(Handle handle)
+        {
+            if constexpr (std::is_pointer_v<Handle>)
+            {
+                return static_cast<u64>(reinterpret_cast<std::uintptr_t>(handle));
+            }
+            else
+            {
+                return static_cast<u64>(handle);
+            }
+        }
+
+        template<typename Handle>
+        Handle keyToHandle(u64 value)
+        {
+            if constexpr (std::is_pointer_v<Handle>)
+            {
+                return reinterpret_cast<Handle>(static_cast<std::uintptr_t>(value));
+            }
+            else
+            {
+                return static_cast<Handle>(value);
+            }
+        }
+
+        template<typename Narrow, typename Wide>
+        Narrow narrow(Wide value, std::string_view field)
+        {
+            if (static_cast<u64>(value) > std::numeric_limits<Narrow>::max())
+            {
+                throw Exception::PipelineError("pipeline key cannot represent " + std::string{ field } + " = " + std::to_string(static_cast<u64>(value)));
+            }
+
+            return static_cast<Narrow>(value);
+        }
+
+        bool operator==(const VkStencilOpState& lhs, const VkStencilOpState& rhs)
+        {
+            return lhs.failOp == rhs.failOp && lhs.passOp == rhs.passOp && lhs.depthFailOp == rhs.depthFailOp && lhs.compareOp == rhs.compareOp
+                && lhs.compareMask == rhs.compareMask && lhs.writeMask == rhs.writeMask && lhs.reference == rhs.reference;
+        }
+
+        //Everything the key does not store must be left at the value of defaultPipelineConfigInfo
+        template<typename T>
+        void requireDefault(const T& value, const T& defaultValue, std::string_view field)
+        {
+            if (!(value == defaultValue))
+            {
+                throw Exception::PipelineError("pipeline key cannot represent a non default " + std::string{ field });
+            }
+        }
+    }
+
+    u64
+    PipelineKey::hash() const
+    {
+        static constexpr Size_t WordCount{ sizeof(PipelineKey) / sizeof(u64) };
+
+        static_assert(sizeof(PipelineKey) % sizeof(u64) == 0);
+
+        std::array<u64, WordCount> words{};
+
+        std::memcpy(words.data(), this, sizeof(PipelineKey));
+
+        u64 hash{ 0xcbf29ce484222325ull };
+
+        for (const auto word : words)
+        {
+            hash ^= word + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        }
+
+        return hash;
+    }
+
+    PipelineKey
+    PipelineKey::fromConfig(const PipelineConfigInfo& config, ShaderId vertexShader, ShaderId fragmentShader)
+    {
+        if (config.bindingDescriptions.size() > MaxVertexBindings || config.attributeDescriptions.size() > MaxVertexAttributes)
+        {
+            throw Exception::PipelineError("pipeline key supports at most " + std::to_string(MaxVertexBindings) + " vertex bindings and "
+                                           + std::to_string(MaxVertexAttributes) + " vertex attributes");
+        }
+
+        const auto defaults = PipelineConfigInfo::defaultPipelineConfigInfo();
+
+        const auto& depthStencil = config.depthStencilStateCreateInfo;
+        const auto& rasterization = config.rasterizationStateCreateInfo;
+        const auto& multisample = config.multisampleStateCreateInfo;
+        const auto& colorBlend = config.colorBlendStateCreateInfo;
+
+        requireDefault(depthStencil.depthBoundsTestEnable, defaults.depthStencilStateCreateInfo.depthBoundsTestEnable, "depthBoundsTestEnable");
+        requireDefault(depthStencil.minDepthBounds, defaults.depthStencilStateCreateInfo.minDepthBounds, "minDepthBounds");
+        requireDefault(depthStencil.maxDepthBounds, defaults.depthStencilStateCreateInfo.maxDepthBounds, "maxDepthBounds");
+        requireDefault(depthStencil.front, defaults.depthStencilStateCreateInfo.front, "stencil front state");
+        requireDefault(depthStencil.back, defaults.depthStencilStateCreateInfo.back, "stencil back state");
+        requireDefault(rasterization.rasterizerDiscardEnable, defaults.rasterizationStateCreateInfo.rasterizerDiscardEnable, "rasterizerDiscardEnable");
+        requireDefault(multisample.alphaToCoverageEnable, defaults.multisampleStateCreateInfo.alphaToCoverageEnable, "alphaToCoverageEnable");
+        requireDefault(multisample.alphaToOneEnable, defaults.multisampleStateCreateInfo.alphaToOneEnable, "alphaToOneEnable");
+        requireDefault(multisample.pSampleMask, defaults.multisampleStateCreateInfo.pSampleMask, "pSampleMask");
+        requireDefault(colorBlend.attachmentCount, defaults.colorBlendStateCreateInfo.attachmentCount, "color attachment count");
+
+        PipelineKey key{};
+
+        key.vertexShader = vertexShader;
+        key.fragmentShader = fragmentShader;
+        key.renderPass = handleToKey(config.renderPass);
+        key.pipelineLayout = handleToKey(config.pipelineLayout);
+        key.subPass = config.subPass;
+        key.colorFormat = static_cast<u32>(config.colorAttachmentFormat);
+        key.depthFormat = static_cast<u32>(config.depthAttachmentFormat);
+
+        key.depth.testEnable = narrow<u8>(depthStencil.depthTestEnable, "depthTestEnable");
+        key.depth.writeEnable = narrow<u8>(depthStencil.depthWriteEnable, "depthWriteEnable");
+        key.depth.compareOp = narrow<u8>(depthStencil.depthCompareOp, "depthCompareOp");
+        key.depth.stencilEnable = narrow<u8>(depthStencil.stencilTestEnable, "stencilTestEnable");
+
+        key.rasterizer.topology = narrow<u8>(config.inputAssemblyStateCreateInfo.topology, "topology");
+        key.rasterizer.primitiveRestartEnable = narrow<u8>(config.inputAssemblyStateCreateInfo.primitiveRestartEnable, "primitiveRestartEnable");
+        key.rasterizer.polygonMode = narrow<u8>(rasterization.polygonMode, "polygonMode");
+        key.rasterizer.cullMode = narrow<u8>(rasterization.cullMode, "cullMode");
+        key.rasterizer.frontFace = narrow<u8>(rasterization.frontFace, "frontFace");
+        key.rasterizer.depthBiasEnable = narrow<u8>(rasterization.depthBiasEnable, "depthBiasEnable");
+        key.rasterizer.depthClampEnable = narrow<u8>(rasterization.depthClampEnable, "depthClampEnable");
+        key.rasterizer.samples = narrow<u8>(config.multisampleStateCreateInfo.rasterizationSamples, "rasterizationSamples");
+
+        const auto& blend = config.colorBlendAttachmentState;
+        key.blend.enable = narrow<u8>(blend.blendEnable, "blendEnable");
+        key.blend.srcColorFactor = narrow<u8>(blend.srcColorBlendFactor, "srcColorBlendFactor");
+        key.blend.dstColorFactor = narrow<u8>(blend.dstColorBlendFactor, "dstColorBlendFactor");
+        key.blend.colorOp = narrow<u8>(blend.colorBlendOp, "colorBlendOp");
+        key.blend.srcAlphaFactor = narrow<u8>(blend.srcAlphaBlendFactor, "srcAlphaBlendFactor");
+        key.blend.dstAlphaFactor = narrow<u8>(blend.dstAlphaBlendFactor, "dstAlphaBlendFactor");
+        key.blend.alphaOp = narrow<u8>(blend.alphaBlendOp, "alphaBlendOp");
+        key.blend.writeMask = narrow<u8>(blend.colorWriteMask, "colorWriteMask");
+
+        auto& fixedFunction = key.fixedFunction;
+        fixedFunction.lineWidth = std::bit_cast<u32>(rasterization.lineWidth);
+        fixedFunction.depthBiasConstantFactor = std::bit_cast<u32>(rasterization.depthBiasConstantFactor);
+        fixedFunction.depthBiasClamp = std::bit_cast<u32>(rasterization.depthBiasClamp);
+        fixedFunction.depthBiasSlopeFactor = std::bit_cast<u32>(rasterization.depthBiasSlopeFactor);
+        fixedFunction.minSampleShading = std::bit_cast<u32>(multisample.minSampleShading);
+        fixedFunction.sampleShadingEnable = narrow<u8>(multisample.sampleShadingEnable, "sampleShadingEnable");
+        fixedFunction.logicOpEnable = narrow<u8>(colorBlend.logicOpEnable, "logicOpEnable");
+        fixedFunction.logicOp = narrow<u8>(colorBlend.logicOp, "logicOp");
+        fixedFunction.viewportCount = narrow<u8>(config.viewportStateCreateInfo.viewportCount, "viewportCount");
+        fixedFunction.scissorCount = narrow<u8>(config.viewportStateCreateInfo.scissorCount, "scissorCount");
+
+        for (Size_t i{ 0 }; i < fixedFunction.blendConstants.size(); ++i)
+        {
+            fixedFunction.blendConstants[i] = std::bit_cast<u32>(colorBlend.blendConstants[i]);
+        }
+
+        fixedFunction.dynamicStates = 0;
+
+        for (const auto dynamicState : config.dynamicStateEnables)
+        {
+            if (static_cast<u64>(dynamicState) >= 32)
+            {
+                throw Exception::PipelineError("pipeline key cannot represent dynamic state " + std::to_string(static_cast<u64>(dynamicState)));
+            }
+
+            fixedFunction.dynamicStates |= 1u << static_cast<u32>(dynamicState);
+        }
+
+        key.vertexBindingCount = static_cast<u8>(config.bindingDescriptions.size());
+
+        for (Size_t i{ 0 }; i < key.vertexBindingCount; ++i)
+        {
+            const auto& binding = config.bindingDescriptions[i];
+
+            key.vertexBindings[i] = VertexBinding
+            {
+                .stride = narrow<u16>(binding.stride, "stride"),
+                .binding = narrow<u8>(binding.binding, "binding"),
+                .inputRate = narrow<u8>(binding.inputRate, "inputRate")
+            };
+        }
+
+        key.vertexAttributeCount = static_cast<u8>(config.attributeDescriptions.size());
+
+        for (Size_t i{ 0 }; i < key.vertexAttributeCount; ++i)
+        {
+            const auto& attribute = config.attributeDescriptions[i];
+
+            key.vertexAttributes[i] = VertexAttribute
+            {
+                .format = static_cast<u32>(attribute.format),
+                .offset = narrow<u16>(attribute.offset, "offset"),
+                .location = narrow<u8>(attribute.location, "location"),
+                .binding = narrow<u8>(attribute.binding, "binding")
+            };
+        }
+
+        return key;
+    }
+
+    PipelineConfigInfo
+    PipelineKey::toConfig() const
+    {
+        auto config = PipelineConfigInfo::defaultPipelineConfigInfo();
+
+        config.renderPass = keyToHandle<VkRenderPass>(renderPass);
+        config.pipelineLayout = keyToHandle<VkPipelineLayout>(pipelineLayout);
+        config.subPass = subPass;
+        config.colorAttachmentFormat = static_cast<VkFormat>(colorFormat);
+        config.depthAttachmentFormat = static_cast<VkFormat>(depthFormat);
+
+        config.depthStencilStateCreateInfo.depthTestEnable = depth.testEnable;
+        config.depthStencilStateCreateInfo.depthWriteEnable = depth.writeEnable;
+        config.depthStencilStateCreateInfo.depthCompareOp = static_cast<VkCompareOp>(depth.compareOp);
+        config.depthStencilStateCreateInfo.stencilTestEnable = depth.stencilEnable;
+
+        config.inputAssemblyStateCreateInfo.topology = static_cast<VkPrimitiveTopology>(rasterizer.topology);
+        config.inputAssemblyStateCreateInfo.primitiveRestartEnable = rasterizer.primitiveRestartEnable;
+        config.rasterizationStateCreateInfo.polygonMode = static_cast<VkPolygonMode>(rasterizer.polygonMode);
+        config.rasterizationStateCreateInfo.cullMode = rasterizer.cullMode;
+        config.rasterizationStateCreateInfo.frontFace = static_cast<VkFrontFace>(rasterizer.frontFace);
+        config.rasterizationStateCreateInfo.depthBiasEnable = rasterizer.depthBiasEnable;
+        config.rasterizationStateCreateInfo.depthClampEnable = rasterizer.depthClampEnable;
+        config.multisampleStateCreateInfo.rasterizationSamples = static_cast<VkSampleCountFlagBits>(rasterizer.samples);
+
+        config.colorBlendAttachmentState.blendEnable = blend.enable;
+        config.colorBlendAttachmentState.srcColorBlendFactor = static_cast<VkBlendFactor>(blend.srcColorFactor);
+        config.colorBlendAttachmentState.dstColorBlendFactor = static_cast<VkBlendFactor>(blend.dstColorFactor);
+        config.colorBlendAttachmentState.colorBlendOp = static_cast<VkBlendOp>(blend.colorOp);
+        config.colorBlendAttachmentState.srcAlphaBlendFactor = static_cast<VkBlendFactor>(blend.srcAlphaFactor);
+        config.colorBlendAttachmentState.dstAlphaBlendFactor = static_cast<VkBlendFactor>(blend.dstAlphaFactor);
+        config.colorBlendAttachmentState.alphaBlendOp = static_cast<VkBlendOp>(blend.alphaOp);
+        config.colorBlendAttachmentState.colorWriteMask = blend.writeMask;
+
+        config.rasterizationStateCreateInfo.lineWidth = std::bit_cast<f32>(fixedFunction.lineWidth);
+        config.rasterizationStateCreateInfo.depthBiasConstantFactor = std::bit_cast<f32>(fixedFunction.depthBiasConstantFactor);
+        config.rasterizationStateCreateInfo.depthBiasClamp = std::bit_cast<f32>(fixedFunction.depthBiasClamp);
+        config.rasterizationStateCreateInfo.depthBiasSlopeFactor = std::bit_cast<f32>(fixedFunction.depthBiasSlopeFactor);
+        config.multisampleStateCreateInfo.minSampleShading = std::bit_cast<f32>(fixedFunction.minSampleShading);
+        config.multisampleStateCreateInfo.sampleShadingEnable = fixedFunction.sampleShadingEnable;
+        config.colorBlendStateCreateInfo.logicOpEnable = fixedFunction.logicOpEnable;
+        config.colorBlendStateCreateInfo.logicOp = static_cast<VkLogicOp>(fixedFunction.logicOp);
+        config.viewportStateCreateInfo.viewportCount = fixedFunction.viewportCount;
+        config.viewportStateCreateInfo.scissorCount = fixedFunction.scissorCount;
+
+        for (Size_t i{ 0 }; i < fixedFunction.blendConstants.size(); ++i)
+        {
+            config.colorBlendStateCreateInfo.blendConstants[i] = std::bit_cast<f32>(fixedFunction.blendConstants[i]);
+        }
+
+        config.dynamicStateEnables.clear();
+
+        for (u32 dynamicState{ 0 }; dynamicState < 32; ++dynamicState)
+        {
+            if (fixedFunction.dynamicStates & (1u << dynamicState))
+            {
+                config.dynamicStateEnables.push_back(static_cast<VkDynamicState>(dynamicState));
+            }
+        }
+
+        for (Size_t i{ 0 }; i < vertexBindingCount; ++i)
+        {
+            config.bindingDescriptions.push_back(VkVertexInputBindingDescription
+            {
+                .binding = vertexBindings[i].binding,
+                .stride = vertexBindings[i].stride,
+                .inputRate = static_cast<VkVertexInputRate>(vertexBindings[i].inputRate)
+            });
+        }
+
+        for (Size_t i{ 0 }; i < vertexAttributeCount; ++i)
+        {
+            config.attributeDescriptions.push_back(VkVertexInputAttributeDescription
+            {
+                .location = vertexAttributes[i].location,
+                .binding = vertexAttributes[i].binding,
+                .format = static_cast<VkFormat>(vertexAttributes[i].format),
+                .offset = vertexAttributes[i].offset
+            });
+        }
+
+        //The blend and dynamic state pointers of the returned copy are re-pointed by the pipeline compiler
+        return config;
+    }
+
+    void
+    PipelineKey::setSpecialization(SpecializationValue specialization)
+    {
+        const auto last = specializations.begin() + specializationCount;
+
+        const auto position = std::ranges::lower_bound(specializations.begin(), last, specialization.constantId, {}, &SpecializationValue::constantId);
+
+        if (position != last && position->constantId == specialization.constantId)
+        {
+            position->value = specialization.value;
+
+            return;
+        }
+
+        if (specializationCount == MaxSpecializationConstants)
+        {
+            throw Exception::PipelineError("pipeline key supports at most " + std::to_string(MaxSpecializationConstants) + " specialization constants");
+        }
+
+        std::move_backward(position, last, last + 1);
+
+        *position = specialization;
+
+        ++specializationCount;
+    }
+
+    std::vector<SpecializationValue>
+    PipelineKey::specializationValues() const
+    {
+        return { specializations.begin(), specializations.begin() + specializationCount };
+    }
+}
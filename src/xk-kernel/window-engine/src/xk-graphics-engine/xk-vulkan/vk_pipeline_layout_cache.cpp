@@ -0,0 +1,222 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <string>
+#include <iterator>
+#include <algorithm>
+
+#include <utility/log.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_layout_cache.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    namespace
+    {
+        u64 combine(u64 seed, u64 value)
+        {
+            return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+        }
+    }
+
+    u64
+    PipelineLayoutCache::LayoutKeyHash::operator()(const std::vector<DescriptorBinding>& bindings) const
+    {
+        u64 hash{ 0xcbf29ce484222325ull };
+
+        for (const auto& binding : bindings)
+        {
+            hash = combine(hash, binding.set);
+            hash = combine(hash, binding.binding);
+            hash = combine(hash, static_cast<u64>(binding.type));
+            hash = combine(hash, binding.count);
+            hash = combine(hash, binding.stages);
+        }
+
+        return hash;
+    }
+
+    u64
+    PipelineLayoutCache::LayoutKeyHash::operator()(const LayoutKey& key) const
+    {
+        return combine(combine((*this)(key.bindings), key.pushConstantSize), key.pushConstantStages);
+    }
+
+    PipelineLayoutCache::PipelineLayoutCache(VkDevice device, DeletionQueue& deletionQueue, const DescriptorHeap& descriptorHeap)
+        : m_device{ device }
+        , m_deletionQueue{ deletionQueue }
+        , m_descriptorHeap{ descriptorHeap }
+    {}
+
+    PipelineLayoutCache::~PipelineLayoutCache()
+    {
+        for (auto& [key, layout] : m_layouts)
+        {
+            m_deletionQueue.destroyLater(layout);
+        }
+
+        for (auto& [bindings, setLayout] : m_setLayouts)
+        {
+            m_deletionQueue.destroyLater(setLayout);
+        }
+    }
+
+    bool
+    PipelineLayoutCache::isHeapCompatible(const ShaderReflection& reflection) const
+    {
+        if (reflection.pushConstantSize > DescriptorHeap::PushConstantSize)
+        {
+            return false;
+        }
+
+        return std::ranges::all_of(reflection.bindings, [](const auto& binding)
+        {
+            if (binding.set != 0)
+            {
+                return false;
+            }
+
+            switch (binding.binding)
+            {
+                case DescriptorHeap::SampledImageBinding:
+                {
+                    return binding.type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                case DescriptorHeap::StorageBufferBinding:
+                {
+                    return binding.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                }
+                case DescriptorHeap::SamplerBinding:
+                {
+                    return binding.type == VK_DESCRIPTOR_TYPE_SAMPLER;
+                }
+                default:
+                {
+                    return false;
+                }
+            }
+        });
+    }
+
+    VkPipelineLayout
+    PipelineLayoutCache::get(const ShaderReflection& reflection)
+    {
+        //The common case, no layout object and no extra descriptor set to bind
+        if (isHeapCompatible(reflection))
+        {
+            return m_descriptorHeap.getPipelineLayout();
+        }
+
+        LayoutKey key
+        {
+            .bindings = reflection.bindings,
+            .pushConstantSize = reflection.pushConstantSize,
+            .pushConstantStages = reflection.pushConstantSize ? reflection.stages : 0
+        };
+
+        std::scoped_lock lock{ m_mutex };
+
+        if (const auto existing = m_layouts.find(key); existing != m_layouts.end())
+        {
+            return existing->second;
+        }
+
+        //Sets without bindings in between still need a layout, Vulkan indexes sets by position
+        const u32 setCount{ key.bindings.empty() ? 0 : key.bindings.back().set + 1 };
+
+        std::vector<VkDescriptorSetLayout> setLayouts{};
+
+        for (u32 set{ 0 }; set < setCount; ++set)
+        {
+            std::vector<DescriptorBinding> setBindings{};
+
+            std::ranges::copy_if(key.bindings, std::back_inserter(setBindings), [set](const auto& binding) { return binding.set == set; });
+
+            setLayouts.push_back(getSetLayout(setBindings));
+        }
+
+        const VkPushConstantRange pushConstantRange
+        {
+            .stageFlags = key.pushConstantStages,
+            .offset = 0,
+            .size = key.pushConstantSize
+        };
+
+        const VkPipelineLayoutCreateInfo layoutInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = static_cast<u32>(setLayouts.size()),
+            .pSetLayouts = setLayouts.data(),
+            .pushConstantRangeCount = key.pushConstantSize ? 1u : 0u,
+            .pPushConstantRanges = key.pushConstantSize ? &pushConstantRange : nullptr
+        };
+
+        VkPipelineLayout layout{ VK_NULL_HANDLE };
+
+        if (const auto result = vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &layout); result != VK_SUCCESS)
+        {
+            throw Exception::PipelineError(std::string{ "failed to create reflected pipeline layout, error code: " } + getVulkanErrorName(result).data());
+        }
+
+        log::debug("Pipeline layout cache: created layout with {} sets and {} bytes of push constants", setCount, key.pushConstantSize);
+
+        m_layouts.emplace(std::move(key), layout);
+
+        return layout;
+    }
+
+    VkDescriptorSetLayout
+    PipelineLayoutCache::getSetLayout(const std::vector<DescriptorBinding>& bindings)
+    {
+        if (const auto existing = m_setLayouts.find(bindings); existing != m_setLayouts.end())
+        {
+            return existing->second;
+        }
+
+        std::vector<VkDescriptorSetLayoutBinding> layoutBindings{};
+
+        for (const auto& binding : bindings)
+        {
+            if (binding.count == 0)
+            {
+                throw Exception::PipelineError("runtime sized descriptor arrays are only supported through the bindless heap");
+            }
+
+            layoutBindings.push_back(VkDescriptorSetLayoutBinding
+            {
+                .binding = binding.binding,
+                .descriptorType = binding.type,
+                .descriptorCount = binding.count,
+                .stageFlags = binding.stages
+            });
+        }
+
+        const VkDescriptorSetLayoutCreateInfo setLayoutInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = static_cast<u32>(layoutBindings.size()),
+            .pBindings = layoutBindings.data()
+        };
+
+        VkDescriptorSetLayout setLayout{ VK_NULL_HANDLE };
+
+        if (const auto result = vkCreateDescriptorSetLayout(m_device, &setLayoutInfo, nullptr, &setLayout); result != VK_SUCCESS)
+        {
+            throw Exception::PipelineError(std::string{ "failed to create reflected descriptor set layout, error code: " } + getVulkanErrorName(result).data());
+        }
+
+        m_setLayouts.emplace(bindings, setLayout);
+
+        return setLayout;
+    }
+
+    Size_t
+    PipelineLayoutCache::layoutCount() const
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        return static_cast<Size_t>(m_layouts.size());
+    }
+}
@@ -0,0 +1,233 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <mutex>
+#include <string>
+#include <algorithm>
+
+#include <utility/log.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_state_cache.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    PipelineStateCache::PipelineStateCache(PipelineCompiler& compiler, const ShaderRegistry& shaderRegistry, PipelineLayoutCache& layoutCache)
+        : m_compiler{ compiler }
+        , m_shaderRegistry{ shaderRegistry }
+        , m_layoutCache{ layoutCache }
+    {}
+
+    PipelineDescription
+    PipelineStateCache::describe(const PipelineKey& key)
+    {
+        PipelineDescription description
+        {
+            .config = key.toConfig(),
+            .vertexShader = m_shaderRegistry.module(key.vertexShader),
+            .fragmentShader = m_shaderRegistry.module(key.fragmentShader)
+        };
+
+        auto reflection = m_shaderRegistry.reflection(key.vertexShader);
+
+        reflection.merge(m_shaderRegistry.reflection(key.fragmentShader));
+
+        if (!description.config.pipelineLayout)
+        {
+            description.config.pipelineLayout = m_layoutCache.get(reflection);
+        }
+
+        description.specialization = key.specializationValues();
+
+        if (key.vertexAttributeCount == 0)
+        {
+            auto vertexInput = reflection.vertexInputLayout();
+
+            description.config.bindingDescriptions = std::move(vertexInput.bindings);
+            description.config.attributeDescriptions = std::move(vertexInput.attributes);
+        }
+
+        return description;
+    }
+
+    PipelineHandle
+    PipelineStateCache::getHandle(const PipelineKey& key)
+    {
+        const auto hash = key.hash();
+
+        auto& shard = shardOf(hash);
+
+        {
+            std::shared_lock lock{ shard.mutex };
+
+            if (const auto pipeline = shard.pipelines.find(key); pipeline != shard.pipelines.end())
+            {
+                m_hits.fetch_add(1, std::memory_order_relaxed);
+
+                return pipeline->second;
+            }
+        }
+
+        std::unique_lock lock{ shard.mutex };
+
+        //Another thread may have inserted the key between the two locks
+        if (const auto pipeline = shard.pipelines.find(key); pipeline != shard.pipelines.end())
+        {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+
+            return pipeline->second;
+        }
+
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+
+        auto handle = m_compiler.compile(describe(key));
+
+        shard.pipelines.emplace(key, handle);
+
+        return handle;
+    }
+
+    VkPipeline
+    PipelineStateCache::get(const PipelineKey& key)
+    {
+        return m_compiler.resolve(getHandle(key));
+    }
+
+    PipelineKey
+    PipelineStateCache::specialize(PipelineKey key, std::string_view name, SpecializationType type, u32 value) const
+    {
+        auto reflection = m_shaderRegistry.reflection(key.vertexShader);
+
+        reflection.merge(m_shaderRegistry.reflection(key.fragmentShader));
+
+        const auto constant = std::ranges::find(reflection.specializationConstants, name, &SpecializationConstantInfo::name);
+
+        if (constant == reflection.specializationConstants.end())
+        {
+            throw Exception::PipelineError("no specialization constant named " + std::string{ name } + " in the shaders of this pipeline");
+        }
+
+        if (constant->type != type)
+        {
+            throw Exception::PipelineError("specialization constant " + std::string{ name } + " is declared with a different type in the shader");
+        }
+
+        key.setSpecialization(SpecializationValue{ .constantId = constant->constantId, .value = value });
+
+        return key;
+    }
+
+    std::vector<PipelineRebuild>
+    PipelineStateCache::rebuild(ShaderId shader)
+    {
+        //Failed pipelines hold nothing to keep drawing with, they are simply compiled again
+        const auto retried = retryFailed([shader](const PipelineKey& key) { return key.vertexShader == shader || key.fragmentShader == shader; });
+
+        std::vector<std::pair<PipelineKey, PipelineHandle>> affected{};
+
+        for (auto& shard : m_shards)
+        {
+            std::shared_lock lock{ shard.mutex };
+
+            for (const auto& [key, handle] : shard.pipelines)
+            {
+                //A retried key already compiles the new code, a rebuild of it would replace its handle with itself
+                if ((key.vertexShader == shader || key.fragmentShader == shader) && handle.status() != PipelineHandle::Status::Failed && !retried.contains(key))
+                {
+                    affected.emplace_back(key, handle);
+                }
+            }
+        }
+
+        std::vector<PipelineRebuild> rebuilds{};
+
+        rebuilds.reserve(affected.size());
+
+        //The key is unchanged, the description picks up the new module and reflection
+        for (const auto& [key, handle] : affected)
+        {
+            rebuilds.push_back(PipelineRebuild{ .current = handle, .replacement = m_compiler.compile(describe(key)) });
+        }
+
+        return rebuilds;
+    }
+
+    Size_t
+    PipelineStateCache::retryFailed()
+    {
+        return static_cast<Size_t>(retryFailed([](const PipelineKey&) { return true; }).size());
+    }
+
+    std::unordered_set<PipelineKey, PipelineKeyHash>
+    PipelineStateCache::retryFailed(const std::function<bool(const PipelineKey&)>& filter)
+    {
+        std::unordered_set<PipelineKey, PipelineKeyHash> retried{};
+
+        for (auto& shard : m_shards)
+        {
+            std::unique_lock lock{ shard.mutex };
+
+            for (auto& [key, handle] : shard.pipelines)
+            {
+                if (handle.status() == PipelineHandle::Status::Failed && filter(key))
+                {
+                    //The next get() of the key draws the new handle, the failed one is dropped by the compiler as well
+                    handle = m_compiler.compile(describe(key));
+
+                    retried.insert(key);
+                }
+            }
+        }
+
+        if (!retried.empty())
+        {
+            log::info("Pipeline state cache: compiling {} failed pipelines again", retried.size());
+        }
+
+        return retried;
+    }
+
+    std::vector<PipelineKey>
+    PipelineStateCache::keys() const
+    {
+        std::vector<PipelineKey> keys{};
+
+        for (const auto& shard : m_shards)
+        {
+            std::shared_lock lock{ shard.mutex };
+
+            for (const auto& [key, handle] : shard.pipelines)
+            {
+                keys.push_back(key);
+            }
+        }
+
+        return keys;
+    }
+
+    PipelineCacheStats
+    PipelineStateCache::stats() const
+    {
+        return PipelineCacheStats
+        {
+            .hits = m_hits.load(std::memory_order_relaxed),
+            .misses = m_misses.load(std::memory_order_relaxed)
+        };
+    }
+
+    void
+    PipelineStateCache::resetStats()
+    {
+        m_hits.store(0, std::memory_order_relaxed);
+        m_misses.store(0, std::memory_order_relaxed);
+    }
+
+    void
+    PipelineStateCache::logStats() const
+    {
+        const auto current = stats();
+
+        log::info("Pipeline state cache: {} hits, {} misses, {:.1f}% hit rate", current.hits, current.misses, current.hitRate() * 100.0);
+    }
+}
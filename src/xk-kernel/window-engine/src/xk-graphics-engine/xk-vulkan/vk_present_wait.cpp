@@ -0,0 +1,83 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+#include <xk-graphics-engine/xk-vulkan/vk_present_wait.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    bool
+    PresentWait::isSupported(VkPhysicalDevice gpu)
+    {
+        u32 extensionCount{ 0 };
+
+        vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount, nullptr);
+
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+
+        vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount, extensions.data());
+
+        auto hasExtension = [&](std::string_view name)
+        {
+            return std::ranges::any_of(extensions, [&](const auto& extension)
+            {
+                return std::string_view{ extension.extensionName } == name;
+            });
+        };
+
+        if (!hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) || !hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+        {
+            return false;
+        }
+
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR
+        };
+
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+            .pNext = &presentWaitFeatures
+        };
+
+        VkPhysicalDeviceFeatures2 features
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &presentIdFeatures
+        };
+
+        vkGetPhysicalDeviceFeatures2(gpu, &features);
+
+        return presentIdFeatures.presentId == VK_TRUE && presentWaitFeatures.presentWait == VK_TRUE;
+    }
+
+    bool
+    PresentWait::isDisabled()
+    {
+        const char* environment = std::getenv(EnvironmentVariable.data());
+
+        return environment != nullptr && std::string_view{ environment } == "off";
+    }
+
+    PresentWait::PresentWait(VkDevice device)
+        : m_device{ device }
+        , m_waitForPresent{ reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(device, "vkWaitForPresentKHR")) }
+    {
+        if (m_waitForPresent == nullptr)
+        {
+            throw Exception::InstanceError("present wait is enabled but its entry point is missing");
+        }
+    }
+
+    VkResult
+    PresentWait::wait(VkSwapchainKHR swapChain, u64 presentId, u64 timeoutNanoseconds) const
+    {
+        return m_waitForPresent(m_device, swapChain, presentId, timeoutNanoseconds);
+    }
+}
@@ -0,0 +1,372 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <system_error>
+
+#ifdef __linux__
+    #include <poll.h>
+    #include <unistd.h>
+    #include <sys/wait.h>
+    #include <sys/inotify.h>
+#endif
+
+#include <utility/log.h>
+#include <utility/mapped_file.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_shader_hot_reload.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    namespace
+    {
+        //Runs program with arguments without a shell, so names reported by inotify are never interpreted
+        //true when it exited with status 0
+        bool
+        runProcess(const std::filesystem::path& program, const std::vector<std::string>& arguments)
+        {
+#ifdef __linux__
+            std::vector<char*> argv{};
+
+            argv.reserve(arguments.size() + 2);
+
+            auto programName = program.string();
+
+            argv.push_back(programName.data());
+
+            for (const auto& argument : arguments)
+            {
+                argv.push_back(const_cast<char*>(argument.c_str()));
+            }
+
+            argv.push_back(nullptr);
+
+            const pid_t child = fork();
+
+            if (child < 0)
+            {
+                log::error("Shader hot reload: fork failed, {}", std::system_category().message(errno));
+
+                return false;
+            }
+
+            if (child == 0)
+            {
+                execvp(argv.front(), argv.data());
+
+                //Only reached when the compiler could not be started, exit without running the handlers of the parent
+                _exit(127);
+            }
+
+            int status{ 0 };
+
+            while (waitpid(child, &status, 0) < 0)
+            {
+                if (errno != EINTR)
+                {
+                    return false;
+                }
+            }
+
+            return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+            return false;
+#endif
+        }
+    }
+
+    bool
+    ShaderHotReload::isRequested()
+    {
+        const char* environment = std::getenv(EnvironmentVariable.data());
+
+        return environment != nullptr && *environment != '\0' && std::string_view{ environment } != "0";
+    }
+
+    ShaderHotReload::ShaderHotReload(ShaderRegistry& shaderRegistry,
+                                     PipelineStateCache& pipelineStateCache,
+                                     PipelineCompiler& pipelineCompiler,
+                                     DeletionQueue& deletionQueue,
+                                     std::filesystem::path sourceDirectory,
+                                     std::filesystem::path glslCompiler,
+                                     core::async::TaskScheduler& scheduler)
+        : m_shaderRegistry{ shaderRegistry }
+        , m_pipelineStateCache{ pipelineStateCache }
+        , m_pipelineCompiler{ pipelineCompiler }
+        , m_deletionQueue{ deletionQueue }
+        , m_sourceDirectory{ std::move(sourceDirectory) }
+        , m_glslCompiler{ std::move(glslCompiler) }
+        , m_outputDirectory{ std::filesystem::temp_directory_path() / "xk-shader-hot-reload" }
+        , m_scheduler{ scheduler }
+    {
+#ifdef __linux__
+        std::filesystem::create_directories(m_outputDirectory);
+
+        m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (m_inotify < 0)
+        {
+            throw Exception::PipelineError("shader hot reload: inotify_init1 failed, " + std::system_category().message(errno));
+        }
+
+        //Editors either rewrite the file in place or rename a temporary over it
+        if (inotify_add_watch(m_inotify, m_sourceDirectory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            close(m_inotify);
+
+            throw Exception::PipelineError("shader hot reload: cannot watch " + m_sourceDirectory.string() + ", " + std::system_category().message(errno));
+        }
+
+        m_watcher = std::jthread{ [this](std::stop_token stopToken) { watch(stopToken); } };
+
+        log::info("Shader hot reload: watching {}", m_sourceDirectory.string());
+#else
+        log::warning("Shader hot reload: needs inotify, not supported on this platform");
+#endif
+    }
+
+    ShaderHotReload::~ShaderHotReload()
+    {
+        if (m_watcher.joinable())
+        {
+            m_watcher.request_stop();
+            m_watcher.join();
+        }
+
+        {
+            //Workers reference this object, so it has to outlive every scheduled recompile
+            std::unique_lock lock{ m_pendingMutex };
+
+            m_pendingCondition.wait(lock, [this] { return m_pendingCount.load(std::memory_order_acquire) == 0; });
+        }
+
+#ifdef __linux__
+        if (m_inotify >= 0)
+        {
+            close(m_inotify);
+        }
+#endif
+
+        //Rebuilds still pending stay owned by the compiler, only the retired modules are left to release
+        for (auto module : m_retiredModules)
+        {
+            m_deletionQueue.destroyLater(module);
+        }
+    }
+
+    bool
+    ShaderHotReload::isShaderSource(std::string_view name)
+    {
+        constexpr std::array extensions{ ".vert", ".frag", ".comp", ".geom", ".tesc", ".tese" };
+
+        return std::ranges::any_of(extensions, [name](std::string_view extension) { return name.ends_with(extension); });
+    }
+
+    void
+    ShaderHotReload::watch(std::stop_token stopToken)
+    {
+#ifdef __linux__
+        //Aligned like struct inotify_event, each read returns whole events
+        alignas(inotify_event) std::array<char, 4096> buffer{};
+
+        while (!stopToken.stop_requested())
+        {
+            pollfd descriptor{ .fd = m_inotify, .events = POLLIN, .revents = 0 };
+
+            //The timeout bounds how long the destructor waits for the thread to notice the stop request
+            if (poll(&descriptor, 1, 100) <= 0)
+            {
+                continue;
+            }
+
+            const auto length = read(m_inotify, buffer.data(), buffer.size());
+
+            for (ssize_t offset{ 0 }; offset < length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+
+                if (event->len > 0 && isShaderSource(event->name))
+                {
+                    scheduleRecompile(event->name);
+                }
+
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            }
+        }
+#endif
+    }
+
+    void
+    ShaderHotReload::scheduleRecompile(const std::string& name)
+    {
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            if (!m_scheduled.insert(name).second)
+            {
+                return;
+            }
+        }
+
+        m_pendingCount.fetch_add(1, std::memory_order_acq_rel);
+
+        m_scheduler.schedule([this, name]
+        {
+            recompile(name);
+
+            std::scoped_lock lock{ m_pendingMutex };
+
+            if (m_pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                m_pendingCondition.notify_all();
+            }
+        });
+    }
+
+    void
+    ShaderHotReload::recompile(const std::string& name)
+    {
+        {
+            //Writes arriving from now on schedule another recompile
+            std::scoped_lock lock{ m_mutex };
+
+            m_scheduled.erase(name);
+        }
+
+        const auto source = m_sourceDirectory / name;
+        //Unique per compile, two compiles of the same file may overlap when it is saved again meanwhile
+        const auto output = m_outputDirectory / (name + "." + std::to_string(m_compileCount.fetch_add(1, std::memory_order_relaxed)) + ".spv");
+
+        //Reloaded shaders skip spirv-opt, the optimized build comes back with the next regular build
+        if (!runProcess(m_glslCompiler, { "-V", source.string(), "-o", output.string() }))
+        {
+            log::error("Shader hot reload: {} failed to compile, keeping the previous version", name);
+
+            return;
+        }
+
+        CompiledShader compiled{ .name = name };
+
+        try
+        {
+            const io::MappedFile file{ output };
+
+            const auto bytes = file.bytes();
+
+            compiled.code.resize(bytes.size() / sizeof(u32));
+
+            std::memcpy(compiled.code.data(), bytes.data(), compiled.code.size() * sizeof(u32));
+        }
+        catch (const std::system_error& error)
+        {
+            log::error("Shader hot reload: {}", error.what());
+
+            return;
+        }
+
+        std::error_code ignored{};
+
+        std::filesystem::remove(output, ignored);
+
+        std::scoped_lock lock{ m_mutex };
+
+        //A newer compile of the same file replaces one the frame thread has not picked up yet
+        std::erase_if(m_compiled, [&name](const auto& pending) { return pending.name == name; });
+
+        m_compiled.push_back(std::move(compiled));
+    }
+
+    bool
+    ShaderHotReload::update()
+    {
+        std::vector<CompiledShader> compiled{};
+
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            compiled.swap(m_compiled);
+        }
+
+        for (const auto& shader : compiled)
+        {
+            const auto id = m_shaderRegistry.find(shader.name);
+
+            if (!id)
+            {
+                log::debug("Shader hot reload: {} is not used by any pipeline", shader.name);
+
+                continue;
+            }
+
+            try
+            {
+                m_retiredModules.push_back(m_shaderRegistry.replace(*id, shader.code));
+            }
+            catch (const std::exception& exception)
+            {
+                log::error("Shader hot reload: {}", exception.what());
+
+                continue;
+            }
+
+            auto rebuilds = m_pipelineStateCache.rebuild(*id);
+
+            log::info("Shader hot reload: {} changed, rebuilding {} pipelines", shader.name, rebuilds.size());
+
+            //A rebuild still compiling the previous save would otherwise overwrite the newer one if it finished last
+            std::erase_if(m_rebuilds, [&rebuilds](const auto& pending)
+            {
+                return std::ranges::any_of(rebuilds, [&pending](const auto& rebuild) { return rebuild.current == pending.current; });
+            });
+
+            std::ranges::move(rebuilds, std::back_inserter(m_rebuilds));
+        }
+
+        bool swapped{ false };
+
+        //Swapped here, between two frames, so a frame never mixes both versions
+        std::erase_if(m_rebuilds, [&](const auto& rebuild)
+        {
+            switch (rebuild.replacement.status())
+            {
+                case PipelineHandle::Status::Pending:
+                {
+                    return false;
+                }
+                case PipelineHandle::Status::Ready:
+                {
+                    m_pipelineCompiler.replace(rebuild.current, rebuild.replacement);
+
+                    swapped = true;
+
+                    return true;
+                }
+                default:
+                {
+                    log::error("Shader hot reload: pipeline rebuild failed, keeping the previous pipeline");
+
+                    return true;
+                }
+            }
+        });
+
+        //Old modules may still be read by compiles that started before the reload
+        if (m_rebuilds.empty() && !m_retiredModules.empty() && m_pipelineCompiler.pendingCount() == 0)
+        {
+            for (auto module : m_retiredModules)
+            {
+                m_deletionQueue.destroyLater(module);
+            }
+
+            m_retiredModules.clear();
+        }
+
+        return swapped;
+    }
+}
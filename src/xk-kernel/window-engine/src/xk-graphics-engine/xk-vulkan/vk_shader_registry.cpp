@@ -0,0 +1,269 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <mutex>
+#include <string>
+#include <system_error>
+
+#include <utility/log.h>
+#include <utility/mapped_file.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_shader_registry.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    ShaderRegistry::ShaderRegistry(VkDevice device, DeletionQueue& deletionQueue)
+        : m_device{ device }
+        , m_deletionQueue{ deletionQueue }
+    {}
+
+    ShaderRegistry::~ShaderRegistry()
+    {
+        for (auto& entry : m_entries)
+        {
+            m_deletionQueue.destroyLater(entry.module);
+        }
+    }
+
+    u64
+    ShaderRegistry::contentHash(std::span<const u32> code)
+    {
+        u64 hash{ 0xcbf29ce484222325ull };
+
+        for (const auto word : code)
+        {
+            hash ^= word;
+            hash *= 0x100000001b3ull;
+        }
+
+        return hash ^ code.size();
+    }
+
+    ShaderId
+    ShaderRegistry::load(const std::filesystem::path& path)
+    {
+        io::MappedFile file{};
+
+        try
+        {
+            file = io::MappedFile{ path };
+        }
+        catch (const std::system_error& error)
+        {
+            throw Exception::PipelineError(error.what());
+        }
+
+        const auto bytes = file.bytes();
+
+        if (bytes.size() % sizeof(u32) != 0)
+        {
+            throw Exception::PipelineError(path.string() + " is not SPIR-V, its size is not a multiple of 4");
+        }
+
+        //The mapping is page aligned, so the words can be read in place
+        return add({ reinterpret_cast<const u32*>(bytes.data()), bytes.size() / sizeof(u32) }, path.filename().string());
+    }
+
+    VkShaderModule
+    ShaderRegistry::createModule(std::span<const u32> code) const
+    {
+        const VkShaderModuleCreateInfo createInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .codeSize = code.size_bytes(),
+            .pCode = code.data()
+        };
+
+        VkShaderModule module{ VK_NULL_HANDLE };
+
+        if (const auto result = vkCreateShaderModule(m_device, &createInfo, nullptr, &module); result != VK_SUCCESS)
+        {
+            throw Exception::PipelineError(std::string{ "failed to create shader module, error code: " } + getVulkanErrorName(result).data());
+        }
+
+        return module;
+    }
+
+    ShaderId
+    ShaderRegistry::add(std::span<const u32> code, std::string_view name)
+    {
+        if (code.empty() || code.front() != SpirvMagic)
+        {
+            throw Exception::PipelineError("shader code does not start with the SPIR-V magic number");
+        }
+
+        const auto hash = contentHash(code);
+
+        {
+            std::shared_lock lock{ m_mutex };
+
+            if (const auto existing = m_idsByHash.find(hash); existing != m_idsByHash.end() && (name.empty() || m_idsByName.contains(std::string{ name })))
+            {
+                return existing->second;
+            }
+        }
+
+        //Reflected outside of the lock, it only reads the code
+        auto reflection = ShaderReflection::reflect(code);
+
+        std::unique_lock lock{ m_mutex };
+
+        if (const auto existing = m_idsByHash.find(hash); existing != m_idsByHash.end())
+        {
+            if (!name.empty())
+            {
+                m_idsByName.try_emplace(std::string{ name }, existing->second);
+            }
+
+            return existing->second;
+        }
+
+        const auto id = static_cast<ShaderId>(m_entries.size());
+
+        m_entries.push_back(Entry{ .module = createModule(code), .hash = hash, .reflection = std::move(reflection), .code = { code.begin(), code.end() } });
+        m_idsByHash.emplace(hash, id);
+
+        if (!name.empty())
+        {
+            m_idsByName.try_emplace(std::string{ name }, id);
+        }
+
+        return id;
+    }
+
+    std::optional<ShaderId>
+    ShaderRegistry::find(std::string_view name) const
+    {
+        std::shared_lock lock{ m_mutex };
+
+        if (const auto existing = m_idsByName.find(std::string{ name }); existing != m_idsByName.end())
+        {
+            return existing->second;
+        }
+
+        return std::nullopt;
+    }
+
+    VkShaderModule
+    ShaderRegistry::replace(ShaderId id, std::span<const u32> code)
+    {
+        if (code.empty() || code.front() != SpirvMagic)
+        {
+            throw Exception::PipelineError("shader code does not start with the SPIR-V magic number");
+        }
+
+        auto reflection = ShaderReflection::reflect(code);
+
+        const auto module = createModule(code);
+
+        const auto hash = contentHash(code);
+
+        std::unique_lock lock{ m_mutex };
+
+        if (id >= m_entries.size())
+        {
+            m_deletionQueue.destroyLater(module);
+
+            throw Exception::PipelineError("unknown shader id " + std::to_string(id));
+        }
+
+        auto& entry = m_entries[id];
+
+        //The old code no longer maps to id, registering it again creates a fresh module
+        if (const auto existing = m_idsByHash.find(entry.hash); existing != m_idsByHash.end() && existing->second == id)
+        {
+            m_idsByHash.erase(existing);
+        }
+
+        m_idsByHash.try_emplace(hash, id);
+
+        const auto previous = entry.module;
+
+        entry = Entry{ .module = module, .hash = hash, .reflection = std::move(reflection), .code = { code.begin(), code.end() } };
+
+        return previous;
+    }
+
+    VkShaderModule
+    ShaderRegistry::module(ShaderId id) const
+    {
+        std::shared_lock lock{ m_mutex };
+
+        if (id >= m_entries.size())
+        {
+            throw Exception::PipelineError("unknown shader id " + std::to_string(id));
+        }
+
+        return m_entries[id].module;
+    }
+
+    ShaderReflection
+    ShaderRegistry::reflection(ShaderId id) const
+    {
+        std::shared_lock lock{ m_mutex };
+
+        if (id >= m_entries.size())
+        {
+            throw Exception::PipelineError("unknown shader id " + std::to_string(id));
+        }
+
+        return m_entries[id].reflection;
+    }
+
+    Size_t
+    ShaderRegistry::moduleCount() const
+    {
+        std::shared_lock lock{ m_mutex };
+
+        return static_cast<Size_t>(m_entries.size());
+    }
+
+    std::vector<ShaderSource>
+    ShaderRegistry::sources() const
+    {
+        std::shared_lock lock{ m_mutex };
+
+        std::vector<ShaderSource> sources(m_entries.size());
+
+        for (Size_t id{ 0 }; id < m_entries.size(); ++id)
+        {
+            sources[id].code = m_entries[id].code;
+        }
+
+        for (const auto& [name, id] : m_idsByName)
+        {
+            sources[id].names.push_back(name);
+        }
+
+        return sources;
+    }
+
+    void
+    ShaderRegistry::restore(std::span<const ShaderSource> sources)
+    {
+        std::unique_lock lock{ m_mutex };
+
+        if (!m_entries.empty())
+        {
+            throw Exception::PipelineError("shaders can only be restored into an empty registry");
+        }
+
+        for (const auto& source : sources)
+        {
+            const auto id = static_cast<ShaderId>(m_entries.size());
+            const auto hash = contentHash(source.code);
+
+            m_entries.push_back(Entry{ .module = createModule(source.code), .hash = hash, .reflection = ShaderReflection::reflect(source.code), .code = source.code });
+
+            //A replaced shader may carry the code of another one, the lower id keeps the hash as add() would
+            m_idsByHash.try_emplace(hash, id);
+
+            for (const auto& name : source.names)
+            {
+                m_idsByName.try_emplace(name, id);
+            }
+        }
+    }
+}
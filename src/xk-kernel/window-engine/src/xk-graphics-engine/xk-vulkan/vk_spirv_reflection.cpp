@@ -0,0 +1,693 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <array>
+#include <tuple>
+#include <string>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+
+#include <xk-graphics-engine/xk-vulkan/vk_spirv_reflection.h>
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    namespace
+    {
+        //Subset of the SPIR-V specification needed to describe a shader interface
+        namespace spirv
+        {
+            constexpr u32 Magic{ 0x07230203 };
+            constexpr u32 HeaderWords{ 5 };
+
+            enum Op : u16
+            {
+                OpName = 5,
+                OpEntryPoint = 15,
+                OpTypeBool = 20,
+                OpTypeInt = 21,
+                OpTypeFloat = 22,
+                OpTypeVector = 23,
+                OpTypeMatrix = 24,
+                OpTypeImage = 25,
+                OpTypeSampler = 26,
+                OpTypeSampledImage = 27,
+                OpTypeArray = 28,
+                OpTypeRuntimeArray = 29,
+                OpTypeStruct = 30,
+                OpTypePointer = 32,
+                OpConstant = 43,
+                OpSpecConstantTrue = 48,
+                OpSpecConstantFalse = 49,
+                OpSpecConstant = 50,
+                OpVariable = 59,
+                OpDecorate = 71,
+                OpMemberDecorate = 72,
+                OpTypeAccelerationStructureKHR = 5341
+            };
+
+            enum Decoration : u32
+            {
+                SpecId = 1,
+                BufferBlock = 3,
+                ArrayStride = 6,
+                MatrixStride = 7,
+                BuiltIn = 11,
+                Location = 30,
+                Binding = 33,
+                DescriptorSet = 34,
+                Offset = 35
+            };
+
+            enum StorageClass : u32
+            {
+                UniformConstant = 0,
+                Input = 1,
+                Uniform = 2,
+                PushConstant = 9,
+                StorageBuffer = 12
+            };
+
+            enum Dim : u32
+            {
+                DimBuffer = 5,
+                DimSubpassData = 6
+            };
+        }
+
+        struct Id
+        {
+            //Defining instruction and its operands after the result id
+            u16                 opcode{ 0 };
+            std::vector<u32>    operands{};
+
+            std::string         name{};
+
+            std::optional<u32>  location{};
+            std::optional<u32>  binding{};
+            std::optional<u32>  set{};
+            std::optional<u32>  specId{};
+            u32                 arrayStride{ 0 };
+            u32                 matrixStride{ 0 };
+            bool                isBuiltIn{ false };
+            bool                isBufferBlock{ false };
+
+            std::vector<u32>    memberOffsets{};
+        };
+
+        struct Variable
+        {
+            u32 id{ 0 };
+            u32 pointerType{ 0 };
+            u32 storageClass{ 0 };
+        };
+
+        class Module
+        {
+        public:
+            explicit Module(std::span<const u32> code)
+            {
+                if (code.size() < spirv::HeaderWords || code[0] != spirv::Magic)
+                {
+                    throw Exception::PipelineError("reflection: code is not SPIR-V");
+                }
+
+                m_ids.resize(code[3]);
+
+                for (Size_t offset{ spirv::HeaderWords }; offset < code.size();)
+                {
+                    const u32 wordCount{ code[offset] >> 16 };
+                    const u16 opcode{ static_cast<u16>(code[offset] & 0xffff) };
+
+                    if (wordCount == 0 || offset + wordCount > code.size())
+                    {
+                        throw Exception::PipelineError("reflection: truncated SPIR-V instruction");
+                    }
+
+                    parse(opcode, code.subspan(offset + 1, wordCount - 1));
+
+                    offset += wordCount;
+                }
+            }
+
+            [[nodiscard]] inline auto stages() const { return m_stages; }
+
+            [[nodiscard]] inline auto& variables() const { return m_variables; }
+
+            [[nodiscard]] inline auto& specializationConstants() const { return m_specializationConstants; }
+
+            [[nodiscard]] const Id& id(u32 index) const
+            {
+                if (index >= m_ids.size())
+                {
+                    throw Exception::PipelineError("reflection: id out of bound");
+                }
+
+                return m_ids[index];
+            }
+
+            /** Byte size of a type as laid out in a block, 0 for opaque types */
+            [[nodiscard]] u32 sizeOf(u32 typeId) const
+            {
+                const auto& type = id(typeId);
+
+                switch (type.opcode)
+                {
+                    case spirv::OpTypeInt:
+                    case spirv::OpTypeFloat:
+                    {
+                        return type.operands.at(0) / 8;
+                    }
+                    case spirv::OpTypeVector:
+                    {
+                        return sizeOf(type.operands.at(0)) * type.operands.at(1);
+                    }
+                    case spirv::OpTypeMatrix:
+                    {
+                        return (type.matrixStride ? type.matrixStride : sizeOf(type.operands.at(0))) * type.operands.at(1);
+                    }
+                    case spirv::OpTypeArray:
+                    {
+                        const auto stride = type.arrayStride ? type.arrayStride : sizeOf(type.operands.at(0));
+
+                        return stride * constant(type.operands.at(1));
+                    }
+                    case spirv::OpTypeStruct:
+                    {
+                        u32 size{ 0 };
+
+                        for (Size_t member{ 0 }; member < type.operands.size(); ++member)
+                        {
+                            const auto offset = member < type.memberOffsets.size() ? type.memberOffsets[member] : size;
+
+                            size = std::max(size, offset + sizeOf(type.operands[member]));
+                        }
+
+                        return size;
+                    }
+                    default:
+                    {
+                        return 0;
+                    }
+                }
+            }
+
+            [[nodiscard]] u32 constant(u32 constantId) const
+            {
+                const auto& value = id(constantId);
+
+                if (value.opcode != spirv::OpConstant)
+                {
+                    throw Exception::PipelineError("reflection: array length is not a constant, specialization constants are not supported here");
+                }
+
+                //Operands: result type, result id, value (low word for 64 bit constants)
+                return value.operands.at(2);
+            }
+
+        private:
+            void parse(u16 opcode, std::span<const u32> operands)
+            {
+                //Every instruction decoded here has at least a target and one more operand
+                if (operands.empty() || (operands.size() < 2 && opcode != spirv::OpTypeBool && opcode != spirv::OpTypeSampler && opcode != spirv::OpTypeAccelerationStructureKHR))
+                {
+                    return;
+                }
+
+                switch (opcode)
+                {
+                    case spirv::OpName:
+                    {
+                        auto& target = mutableId(operands[0]);
+
+                        //Literal strings are nul terminated and packed four characters per word
+                        const std::string_view characters{ reinterpret_cast<const char*>(operands.data() + 1), (operands.size() - 1) * sizeof(u32) };
+
+                        target.name.assign(characters.substr(0, characters.find('\0')));
+
+                        break;
+                    }
+                    case spirv::OpEntryPoint:
+                    {
+                        m_stages |= toStage(operands[0]);
+
+                        break;
+                    }
+                    case spirv::OpDecorate:
+                    {
+                        decorate(mutableId(operands[0]), operands[1], operands.size() > 2 ? operands[2] : 0);
+
+                        break;
+                    }
+                    case spirv::OpMemberDecorate:
+                    {
+                        auto& structure = mutableId(operands[0]);
+
+                        if (operands[2] == spirv::Offset && operands.size() > 3)
+                        {
+                            if (structure.memberOffsets.size() <= operands[1])
+                            {
+                                structure.memberOffsets.resize(operands[1] + 1, 0);
+                            }
+
+                            structure.memberOffsets[operands[1]] = operands[3];
+                        }
+                        else if (operands[2] == spirv::BuiltIn)
+                        {
+                            //gl_PerVertex and friends, the whole block is a built-in
+                            structure.isBuiltIn = true;
+                        }
+
+                        break;
+                    }
+                    case spirv::OpTypeBool:
+                    case spirv::OpTypeInt:
+                    case spirv::OpTypeFloat:
+                    case spirv::OpTypeVector:
+                    case spirv::OpTypeMatrix:
+                    case spirv::OpTypeImage:
+                    case spirv::OpTypeSampler:
+                    case spirv::OpTypeSampledImage:
+                    case spirv::OpTypeArray:
+                    case spirv::OpTypeRuntimeArray:
+                    case spirv::OpTypeStruct:
+                    case spirv::OpTypePointer:
+                    case spirv::OpTypeAccelerationStructureKHR:
+                    {
+                        auto& type = mutableId(operands[0]);
+
+                        type.opcode = opcode;
+                        type.operands.assign(operands.begin() + 1, operands.end());
+
+                        break;
+                    }
+                    case spirv::OpConstant:
+                    {
+                        auto& value = mutableId(operands[1]);
+
+                        value.opcode = opcode;
+                        value.operands.assign(operands.begin(), operands.end());
+
+                        break;
+                    }
+                    case spirv::OpSpecConstantTrue:
+                    case spirv::OpSpecConstantFalse:
+                    case spirv::OpSpecConstant:
+                    {
+                        auto& value = mutableId(operands[1]);
+
+                        value.opcode = opcode;
+                        value.operands.assign(operands.begin(), operands.end());
+
+                        m_specializationConstants.push_back(operands[1]);
+
+                        break;
+                    }
+                    case spirv::OpVariable:
+                    {
+                        m_variables.push_back(Variable{ .id = operands[1], .pointerType = operands[0], .storageClass = operands[2] });
+
+                        break;
+                    }
+                    default:
+                    {
+                        break;
+                    }
+                }
+            }
+
+            static void decorate(Id& target, u32 decoration, u32 value)
+            {
+                switch (decoration)
+                {
+                    case spirv::SpecId:         target.specId = value; break;
+                    case spirv::BufferBlock:    target.isBufferBlock = true; break;
+                    case spirv::ArrayStride:    target.arrayStride = value; break;
+                    case spirv::MatrixStride:   target.matrixStride = value; break;
+                    case spirv::BuiltIn:        target.isBuiltIn = true; break;
+                    case spirv::Location:       target.location = value; break;
+                    case spirv::Binding:        target.binding = value; break;
+                    case spirv::DescriptorSet:  target.set = value; break;
+                    default:                    break;
+                }
+            }
+
+            static VkShaderStageFlags toStage(u32 executionModel)
+            {
+                static constexpr std::array<VkShaderStageFlagBits, 6> Stages
+                {
+                    VK_SHADER_STAGE_VERTEX_BIT,
+                    VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
+                    VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+                    VK_SHADER_STAGE_GEOMETRY_BIT,
+                    VK_SHADER_STAGE_FRAGMENT_BIT,
+                    VK_SHADER_STAGE_COMPUTE_BIT
+                };
+
+                return executionModel < Stages.size() ? Stages[executionModel] : 0;
+            }
+
+            Id& mutableId(u32 index)
+            {
+                if (index >= m_ids.size())
+                {
+                    throw Exception::PipelineError("reflection: id out of bound");
+                }
+
+                return m_ids[index];
+            }
+
+            std::vector<Id>         m_ids{};
+
+            std::vector<Variable>   m_variables{};
+
+            std::vector<u32>        m_specializationConstants{};
+
+            VkShaderStageFlags      m_stages{ 0 };
+        };
+
+        VkFormat toVertexFormat(const Module& module, u32 typeId)
+        {
+            const auto& type = module.id(typeId);
+
+            const u32 components{ type.opcode == spirv::OpTypeVector ? type.operands.at(1) : 1 };
+
+            const auto& scalar = type.opcode == spirv::OpTypeVector ? module.id(type.operands.at(0)) : type;
+
+            const u32 width{ scalar.operands.at(0) };
+
+            if (components < 1 || components > 4 || (scalar.opcode != spirv::OpTypeFloat && scalar.opcode != spirv::OpTypeInt))
+            {
+                throw Exception::PipelineError("reflection: only scalar and vector vertex inputs are supported");
+            }
+
+            static constexpr std::array<VkFormat, 4> Float32{ VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+            static constexpr std::array<VkFormat, 4> Float64{ VK_FORMAT_R64_SFLOAT, VK_FORMAT_R64G64_SFLOAT, VK_FORMAT_R64G64B64_SFLOAT, VK_FORMAT_R64G64B64A64_SFLOAT };
+            static constexpr std::array<VkFormat, 4> Int32{ VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+            static constexpr std::array<VkFormat, 4> UInt32{ VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+
+            if (scalar.opcode == spirv::OpTypeFloat)
+            {
+                return width == 64 ? Float64[components - 1] : Float32[components - 1];
+            }
+
+            if (width != 32)
+            {
+                throw Exception::PipelineError("reflection: only 32 bit integer vertex inputs are supported");
+            }
+
+            const bool isSigned{ scalar.operands.at(1) != 0 };
+
+            return isSigned ? Int32[components - 1] : UInt32[components - 1];
+        }
+
+        SpecializationConstantInfo toSpecializationConstant(const Module& module, const Id& constant)
+        {
+            const auto& type = module.id(constant.operands.at(0));
+
+            SpecializationConstantInfo info{ .name = constant.name, .constantId = *constant.specId };
+
+            if (type.opcode == spirv::OpTypeBool)
+            {
+                info.type = SpecializationType::Bool;
+                info.defaultValue = constant.opcode == spirv::OpSpecConstantTrue ? VK_TRUE : VK_FALSE;
+
+                return info;
+            }
+
+            if ((type.opcode != spirv::OpTypeInt && type.opcode != spirv::OpTypeFloat) || type.operands.at(0) != 32)
+            {
+                throw Exception::PipelineError("reflection: specialization constant " + constant.name + " is not a 32 bit scalar");
+            }
+
+            if (type.opcode == spirv::OpTypeFloat)
+            {
+                info.type = SpecializationType::Float;
+            }
+            else
+            {
+                info.type = type.operands.at(1) != 0 ? SpecializationType::Int : SpecializationType::UInt;
+            }
+
+            //Operands: result type, result id, default value
+            info.defaultValue = constant.operands.at(2);
+
+            return info;
+        }
+
+        VkDescriptorType toDescriptorType(const Module& module, const Id& type, u32 storageClass)
+        {
+            switch (type.opcode)
+            {
+                case spirv::OpTypeSampler:
+                {
+                    return VK_DESCRIPTOR_TYPE_SAMPLER;
+                }
+                case spirv::OpTypeSampledImage:
+                {
+                    const auto& image = module.id(type.operands.at(0));
+
+                    return image.operands.at(1) == spirv::DimBuffer ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                }
+                case spirv::OpTypeImage:
+                {
+                    //Operands: sampled type, dim, depth, arrayed, multisampled, sampled (1 = with sampler, 2 = storage), format
+                    const auto dim = type.operands.at(1);
+                    const bool isStorage{ type.operands.at(5) == 2 };
+
+                    if (dim == spirv::DimBuffer)
+                    {
+                        return isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                    }
+
+                    if (dim == spirv::DimSubpassData)
+                    {
+                        return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                    }
+
+                    return isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                case spirv::OpTypeStruct:
+                {
+                    const bool isStorage{ storageClass == spirv::StorageBuffer || type.isBufferBlock };
+
+                    return isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                }
+                case spirv::OpTypeAccelerationStructureKHR:
+                {
+                    return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                }
+                default:
+                {
+                    throw Exception::PipelineError("reflection: unsupported descriptor type");
+                }
+            }
+        }
+    }
+
+    ShaderReflection
+    ShaderReflection::reflect(std::span<const u32> code)
+    {
+        const Module module{ code };
+
+        ShaderReflection reflection{};
+
+        reflection.stages = module.stages();
+
+        for (const auto& variable : module.variables())
+        {
+            const auto& declaration = module.id(variable.id);
+            const auto& pointer = module.id(variable.pointerType);
+
+            if (pointer.opcode != spirv::OpTypePointer)
+            {
+                continue;
+            }
+
+            const auto pointeeId = pointer.operands.at(1);
+
+            switch (variable.storageClass)
+            {
+                case spirv::Input:
+                {
+                    if ((reflection.stages & VK_SHADER_STAGE_VERTEX_BIT) == 0 || declaration.isBuiltIn || module.id(pointeeId).isBuiltIn || !declaration.location)
+                    {
+                        break;
+                    }
+
+                    const auto format = toVertexFormat(module, pointeeId);
+
+                    reflection.inputs.push_back(ShaderInput
+                    {
+                        .name = declaration.name,
+                        .location = *declaration.location,
+                        .format = format,
+                        .size = module.sizeOf(pointeeId)
+                    });
+
+                    break;
+                }
+                case spirv::PushConstant:
+                {
+                    reflection.pushConstantSize = std::max(reflection.pushConstantSize, module.sizeOf(pointeeId));
+
+                    break;
+                }
+                case spirv::UniformConstant:
+                case spirv::Uniform:
+                case spirv::StorageBuffer:
+                {
+                    //Arrays of resources become one binding with a descriptor count
+                    u32 count{ 1 };
+                    auto typeId = pointeeId;
+
+                    if (const auto& type = module.id(typeId); type.opcode == spirv::OpTypeArray)
+                    {
+                        count = module.constant(type.operands.at(1));
+                        typeId = type.operands.at(0);
+                    }
+                    else if (type.opcode == spirv::OpTypeRuntimeArray)
+                    {
+                        count = 0;
+                        typeId = type.operands.at(0);
+                    }
+
+                    reflection.bindings.push_back(DescriptorBinding
+                    {
+                        .set = declaration.set.value_or(0),
+                        .binding = declaration.binding.value_or(0),
+                        .type = toDescriptorType(module, module.id(typeId), variable.storageClass),
+                        .count = count,
+                        .stages = reflection.stages
+                    });
+
+                    break;
+                }
+                default:
+                {
+                    break;
+                }
+            }
+        }
+
+        for (const auto constantId : module.specializationConstants())
+        {
+            //Constants without a SpecId cannot be set from the API, they are derived from other constants
+            if (const auto& constant = module.id(constantId); constant.specId)
+            {
+                reflection.specializationConstants.push_back(toSpecializationConstant(module, constant));
+            }
+        }
+
+        std::ranges::sort(reflection.inputs, {}, &ShaderInput::location);
+
+        std::ranges::sort(reflection.specializationConstants, {}, &SpecializationConstantInfo::constantId);
+
+        std::ranges::sort(reflection.bindings, [](const auto& left, const auto& right)
+        {
+            return std::tie(left.set, left.binding) < std::tie(right.set, right.binding);
+        });
+
+        return reflection;
+    }
+
+    void
+    ShaderReflection::merge(const ShaderReflection& other)
+    {
+        if (other.stages & VK_SHADER_STAGE_VERTEX_BIT)
+        {
+            inputs = other.inputs;
+        }
+
+        stages |= other.stages;
+
+        pushConstantSize = std::max(pushConstantSize, other.pushConstantSize);
+
+        for (const auto& binding : other.bindings)
+        {
+            const auto existing = std::ranges::find_if(bindings, [&binding](const auto& current)
+            {
+                return current.set == binding.set && current.binding == binding.binding;
+            });
+
+            if (existing == bindings.end())
+            {
+                bindings.push_back(binding);
+
+                continue;
+            }
+
+            if (existing->type != binding.type)
+            {
+                throw Exception::PipelineError("reflection: set " + std::to_string(binding.set) + " binding " + std::to_string(binding.binding)
+                                               + " is declared with different types in different stages");
+            }
+
+            existing->stages |= binding.stages;
+            existing->count = std::max(existing->count, binding.count);
+        }
+
+        std::ranges::sort(bindings, [](const auto& left, const auto& right)
+        {
+            return std::tie(left.set, left.binding) < std::tie(right.set, right.binding);
+        });
+
+        //Both stages see the same VkSpecializationInfo, so a shared id has to mean the same constant
+        for (const auto& constant : other.specializationConstants)
+        {
+            const auto existing = std::ranges::find(specializationConstants, constant.constantId, &SpecializationConstantInfo::constantId);
+
+            if (existing == specializationConstants.end())
+            {
+                specializationConstants.push_back(constant);
+
+                continue;
+            }
+
+            if (existing->type != constant.type)
+            {
+                throw Exception::PipelineError("reflection: specialization constant " + std::to_string(constant.constantId)
+                                               + " is declared with different types in different stages");
+            }
+        }
+
+        std::ranges::sort(specializationConstants, {}, &SpecializationConstantInfo::constantId);
+    }
+
+    VertexInputLayout
+    ShaderReflection::vertexInputLayout() const
+    {
+        VertexInputLayout layout{};
+
+        if (inputs.empty())
+        {
+            return layout;
+        }
+
+        u32 offset{ 0 };
+
+        for (const auto& input : inputs)
+        {
+            layout.attributes.push_back(VkVertexInputAttributeDescription
+            {
+                .location = input.location,
+                .binding = 0,
+                .format = input.format,
+                .offset = offset
+            });
+
+            offset += input.size;
+        }
+
+        layout.bindings.push_back(VkVertexInputBindingDescription
+        {
+            .binding = 0,
+            .stride = offset,
+            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+        });
+
+        return layout;
+    }
+}
@@ -0,0 +1,265 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <cstdlib>
+#include <algorithm>
+#include <charconv>
+
+#include <utility/log.h>
+
+#include <xk-graphics-engine/xk-vulkan/vk_surface_format.h>
+
+namespace xk::graphics_engine::vulkan
+{
+    namespace
+    {
+        //UNORM first, widgets author sRGB colors and the swap image stores them without any conversion
+        const std::vector<VkSurfaceFormatKHR> StandardFormats
+        {
+            { VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+            { VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+            { VK_FORMAT_B8G8R8A8_SRGB,  VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+            { VK_FORMAT_R8G8B8A8_SRGB,  VK_COLOR_SPACE_SRGB_NONLINEAR_KHR }
+        };
+
+        bool
+        isSame(VkSurfaceFormatKHR lhs, VkSurfaceFormatKHR rhs)
+        {
+            return lhs.format == rhs.format && lhs.colorSpace == rhs.colorSpace;
+        }
+
+        bool
+        isSrgbFormat(VkFormat format)
+        {
+            return format == VK_FORMAT_B8G8R8A8_SRGB || format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_A8B8G8R8_SRGB_PACK32;
+        }
+    }
+
+    std::string_view
+    toString(SurfaceFormatMode mode)
+    {
+        switch (mode)
+        {
+            case SurfaceFormatMode::Standard: return "standard";
+            case SurfaceFormatMode::Wide:     return "wide";
+            case SurfaceFormatMode::Hdr10:    return "hdr10";
+            case SurfaceFormatMode::ScRgb:    return "scrgb";
+        }
+
+        return "unknown";
+    }
+
+    std::string_view
+    toString(OutputTransfer transfer)
+    {
+        switch (transfer)
+        {
+            case OutputTransfer::None:       return "None";
+            case OutputTransfer::DecodeSrgb: return "DecodeSrgb";
+            case OutputTransfer::Pq:         return "Pq";
+            case OutputTransfer::Linear:     return "Linear";
+        }
+
+        return "Unknown";
+    }
+
+    std::string_view
+    toString(VkColorSpaceKHR colorSpace)
+    {
+        switch (colorSpace)
+        {
+            case VK_COLOR_SPACE_SRGB_NONLINEAR_KHR:          return "SrgbNonLinear";
+            case VK_COLOR_SPACE_HDR10_ST2084_EXT:            return "Hdr10St2084";
+            case VK_COLOR_SPACE_EXTENDED_SRGB_LINEAR_EXT:    return "ExtendedSrgbLinear";
+            case VK_COLOR_SPACE_EXTENDED_SRGB_NONLINEAR_EXT: return "ExtendedSrgbNonLinear";
+            case VK_COLOR_SPACE_DISPLAY_P3_NONLINEAR_EXT:    return "DisplayP3NonLinear";
+            case VK_COLOR_SPACE_BT2020_LINEAR_EXT:           return "Bt2020Linear";
+            default:                                         return "Unknown";
+        }
+    }
+
+    SurfaceFormatCost
+    SurfaceFormatCost::of(VkSurfaceFormatKHR format)
+    {
+        SurfaceFormatCost cost{};
+
+        switch (format.format)
+        {
+            case VK_FORMAT_R16G16B16A16_SFLOAT: cost.bytesPerPixel = 8; break;
+            default:                            cost.bytesPerPixel = 4; break;
+        }
+
+        switch (format.colorSpace)
+        {
+            case VK_COLOR_SPACE_SRGB_NONLINEAR_KHR:
+            {
+                cost.transfer = isSrgbFormat(format.format) ? OutputTransfer::DecodeSrgb : OutputTransfer::None;
+
+                break;
+            }
+            case VK_COLOR_SPACE_HDR10_ST2084_EXT:
+            {
+                cost.transfer = OutputTransfer::Pq;
+                cost.requiresColorSpaceExtension = true;
+
+                break;
+            }
+            case VK_COLOR_SPACE_EXTENDED_SRGB_LINEAR_EXT:
+            {
+                cost.transfer = OutputTransfer::Linear;
+                cost.requiresColorSpaceExtension = true;
+
+                break;
+            }
+            default:
+            {
+                //Color spaces no mode asks for, colors go out unconverted
+                cost.requiresColorSpaceExtension = true;
+
+                break;
+            }
+        }
+
+        return cost;
+    }
+
+    SurfaceFormatPolicy
+    SurfaceFormatPolicy::forMode(SurfaceFormatMode mode)
+    {
+        switch (mode)
+        {
+            case SurfaceFormatMode::Wide:
+            {
+                return
+                {
+                    .mode = mode,
+                    .formats =
+                    {
+                        { VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+                        { VK_FORMAT_A2R10G10B10_UNORM_PACK32, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR }
+                    }
+                };
+            }
+            case SurfaceFormatMode::Hdr10:
+            {
+                return
+                {
+                    .mode = mode,
+                    .formats =
+                    {
+                        { VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_COLOR_SPACE_HDR10_ST2084_EXT },
+                        { VK_FORMAT_A2R10G10B10_UNORM_PACK32, VK_COLOR_SPACE_HDR10_ST2084_EXT }
+                    }
+                };
+            }
+            case SurfaceFormatMode::ScRgb:
+            {
+                return
+                {
+                    .mode = mode,
+                    .formats = { { VK_FORMAT_R16G16B16A16_SFLOAT, VK_COLOR_SPACE_EXTENDED_SRGB_LINEAR_EXT } }
+                };
+            }
+            case SurfaceFormatMode::Standard:
+            default:
+            {
+                return
+                {
+                    .mode = SurfaceFormatMode::Standard,
+                    .formats = StandardFormats
+                };
+            }
+        }
+    }
+
+    SurfaceFormatPolicy
+    SurfaceFormatPolicy::fromEnvironment()
+    {
+        auto mode = SurfaceFormatMode::Standard;
+
+        if (const char* environment = std::getenv(EnvironmentVariable.data()); environment != nullptr)
+        {
+            const std::string_view value{ environment };
+
+            if (value == "wide")
+            {
+                mode = SurfaceFormatMode::Wide;
+            }
+            else if (value == "hdr10")
+            {
+                mode = SurfaceFormatMode::Hdr10;
+            }
+            else if (value == "scrgb")
+            {
+                mode = SurfaceFormatMode::ScRgb;
+            }
+            else if (value != "standard")
+            {
+                log::warning("{}: unknown mode {}, using standard", EnvironmentVariable, value);
+            }
+        }
+
+        auto policy = forMode(mode);
+
+        if (const char* environment = std::getenv(PaperWhiteVariable.data()); environment != nullptr)
+        {
+            const std::string_view value{ environment };
+
+            f32 nits{ 0.0f };
+
+            if (std::from_chars(value.data(), value.data() + value.size(), nits).ec == std::errc{} && nits > 0.0f)
+            {
+                policy.paperWhiteNits = nits;
+            }
+            else
+            {
+                log::warning("{}: {} is not a brightness in nits", PaperWhiteVariable, value);
+            }
+        }
+
+        return policy;
+    }
+
+    VkSurfaceFormatKHR
+    SurfaceFormatPolicy::choose(const std::vector<VkSurfaceFormatKHR>& availableFormats) const
+    {
+        auto firstOffered = [&](const std::vector<VkSurfaceFormatKHR>& candidates) -> const VkSurfaceFormatKHR*
+        {
+            for (const auto& candidate : candidates)
+            {
+                if (std::ranges::any_of(availableFormats, [&](const auto& available) { return isSame(available, candidate); }))
+                {
+                    return &candidate;
+                }
+            }
+
+            return nullptr;
+        };
+
+        if (const auto* preferred = firstOffered(formats); preferred != nullptr)
+        {
+            return *preferred;
+        }
+
+        if (mode != SurfaceFormatMode::Standard)
+        {
+            log::warning("Surface offers no {} format, using standard", toString(mode));
+        }
+
+        if (const auto* standard = firstOffered(StandardFormats); standard != nullptr)
+        {
+            return *standard;
+        }
+
+        return availableFormats.front();
+    }
+
+    bool
+    SurfaceFormatPolicy::operator==(const SurfaceFormatPolicy& other) const
+    {
+        return mode == other.mode
+            && paperWhiteNits == other.paperWhiteNits
+            && std::ranges::equal(formats, other.formats, isSame);
+    }
+}
@@ -1,93 +1,653 @@
- 
+
 //Created by kafka on 3/17/2022.
- 
+
 
 #include <xk-graphics-engine/xk-vulkan/vk_swap_chain.h>
 #include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
 #include <utility/log.h>
 
 #include <array>
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <set>
 #include <stdexcept>
+#include <thread>
 
 namespace xk::graphics_engine::vulkan
 {
     template<bool ValidationEnabled>
-    SwapChain<ValidationEnabled>::SwapChain(std::weak_ptr<GpuWrapper<ValidationEnabled>> gpuWrapper)
+    SwapChain<ValidationEnabled>::SwapChain(std::weak_ptr<GpuWrapper<ValidationEnabled>> gpuWrapper, VkSurfaceKHR surface, VkExtent2D windowExtent, FramePacingPolicy pacing,
+                                            SurfaceFormatPolicy surfaceFormat)
         : m_gpuWrapper{ gpuWrapper }
+        , m_surface{ surface }
+        , m_windowExtent{ windowExtent }
+        , m_dynamicRendering{ gpuWrapper.lock()->getDynamicRendering() }
+        , m_presentWait{ gpuWrapper.lock()->getPresentWait() }
+        , m_incrementalPresent{ gpuWrapper.lock()->isDeviceExtensionEnabled(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME) }
+        , m_pacing{ std::move(pacing) }
+        , m_surfaceFormatPolicy{ std::move(surfaceFormat) }
     {
-        createSwapChain();
+        log::info("Frame pacing: {}, {} frames in flight", toString(m_pacing.mode), m_pacing.framesInFlight);
+
+        m_frameLimiter.setRate(m_pacing.maxFramesPerSecond);
+
+        createSwapChain(VK_NULL_HANDLE);
         createImageViews();
-        createRenderPass();
+
+        m_depthFormat = findDepthFormat();
+
+        //Dynamic rendering takes the attachments when recording, there is no render pass or framebuffer to create
+        if (!usesDynamicRendering())
+        {
+            createRenderPass();
+        }
+
         createDepthResources();
-        createFramebuffers();
+
+        if (!usesDynamicRendering())
+        {
+            createFramebuffers();
+        }
+
         createSyncObjects();
     }
 
     template<bool ValidationEnabled>
     SwapChain<ValidationEnabled>::~SwapChain()
     {
+        auto gpuWrapper = m_gpuWrapper.lock();
+        const auto logicalDevice = gpuWrapper->getLogicalDevice();
+
+        //Shutdown is the only place where waiting for the whole device is acceptable
+        vkDeviceWaitIdle(logicalDevice);
+
+        for (Index_t slot{ 0 }; slot < m_slotFrames.size(); ++slot)
+        {
+            completeSlot(slot);
+        }
+
         for (auto imageView : m_swapChainImageViews)
         {
-            vkDestroyImageView(m_gpuWrapper. m_gpuWrapper(), imageView, nullptr);
+            vkDestroyImageView(logicalDevice, imageView, nullptr);
         }
 
         m_swapChainImageViews.clear();
 
-        if (m_swapChain != nullptr)
+        if (m_swapChain != VK_NULL_HANDLE)
+        {
+            vkDestroySwapchainKHR(logicalDevice, m_swapChain, nullptr);
+
+            m_swapChain = VK_NULL_HANDLE;
+        }
+
+        vkDestroyImageView(logicalDevice, m_depthImageView, nullptr);
+        vkDestroyImage(logicalDevice, m_depthImage, nullptr);
+        gpuWrapper->freeMemory(m_depthImageMemory);
+
+        for (auto framebuffer : m_swapChainFramebuffers)
+        {
+            vkDestroyFramebuffer(logicalDevice, framebuffer, nullptr);
+        }
+
+        vkDestroyRenderPass(logicalDevice, m_renderPass, nullptr);
+
+        destroySyncObjects();
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::completeSlot(Index_t slot)
+    {
+        auto& frame = m_slotFrames[slot];
+
+        if (frame)
+        {
+            m_gpuWrapper.lock()->getDeletionQueue().markCompleted(*frame);
+
+            frame.reset();
+        }
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::destroySyncObjects()
+    {
+        const auto logicalDevice = device();
+
+        for (Size_t i{ 0 }; i < m_inFlightFences.size(); ++i)
+        {
+            vkDestroySemaphore(logicalDevice, m_renderFinishedSemaphores[i], nullptr);
+            vkDestroySemaphore(logicalDevice, m_imageAvailableSemaphores[i], nullptr);
+            vkDestroyFence(logicalDevice, m_inFlightFences[i], nullptr);
+        }
+
+        m_renderFinishedSemaphores.clear();
+        m_imageAvailableSemaphores.clear();
+        m_inFlightFences.clear();
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::setFramePacing(FramePacingPolicy pacing)
+    {
+        m_pendingPacing = std::move(pacing);
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::setDepthEnabled(bool enabled)
+    {
+        if (enabled == m_depthEnabled && !m_pendingDepthEnabled)
+        {
+            return;
+        }
+
+        m_pendingDepthEnabled = enabled;
+
+        m_recreateRequested = true;
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::setSurfaceFormat(SurfaceFormatPolicy surfaceFormat)
+    {
+        if (surfaceFormat == m_surfaceFormatPolicy)
+        {
+            return;
+        }
+
+        //Only read by createSwapChain, the paper white of the frame being recorded may already change
+        m_surfaceFormatPolicy = std::move(surfaceFormat);
+
+        m_recreateRequested = true;
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::applyPacing()
+    {
+        auto pacing = std::move(*m_pendingPacing);
+
+        m_pendingPacing.reset();
+
+        //Reported per mode, so the modes can be compared by switching between them
+        if (const auto latency = m_latencyTracker.statistics(); latency.samples > 0)
+        {
+            log::info("Frame pacing {}: input to present {:.2f} ms average, {:.2f} min, {:.2f} max over {} inputs",
+                      toString(m_pacing.mode), latency.averageMilliseconds, latency.minMilliseconds, latency.maxMilliseconds, latency.samples);
+        }
+
+        if (const auto present = m_presentTimer.statistics(); present.samples > 0)
+        {
+            log::info("Frame pacing {}: present to present {:.2f} ms average, {:.2f} ms refresh, {:.2f} ms frame cost",
+                      toString(m_pacing.mode), present.averagePresentIntervalMilliseconds, present.refreshMilliseconds, present.frameCostMilliseconds);
+        }
+
+        m_latencyTracker.reset();
+        m_presentTimer.reset();
+
+        if (pacing.framesInFlight != m_pacing.framesInFlight)
+        {
+            const auto logicalDevice = device();
+
+            //Slots are renumbered, so the frames recorded against the old ring have to finish first, the rest of the device keeps running
+            waitForFences(m_inFlightFences);
+
+            for (Index_t slot{ 0 }; slot < m_slotFrames.size(); ++slot)
+            {
+                completeSlot(slot);
+            }
+
+            auto& deletionQueue = m_gpuWrapper.lock()->getDeletionQueue();
+
+            //The semaphores may still be waited on by a pending present
+            for (Size_t i{ 0 }; i < m_inFlightFences.size(); ++i)
+            {
+                deletionQueue.destroyLater(m_renderFinishedSemaphores[i]);
+                deletionQueue.destroyLater(m_imageAvailableSemaphores[i]);
+                deletionQueue.destroyLater(m_inFlightFences[i]);
+            }
+
+            m_renderFinishedSemaphores.clear();
+            m_imageAvailableSemaphores.clear();
+            m_inFlightFences.clear();
+
+            m_pacing.framesInFlight = pacing.framesInFlight;
+
+            m_currentFrame = 0;
+
+            createSyncObjects();
+        }
+
+        m_pacing = std::move(pacing);
+
+        m_frameLimiter.setRate(m_pacing.maxFramesPerSecond);
+
+        //Present mode and image count are swapchain creation parameters
+        m_recreateRequested = true;
+
+        log::info("Frame pacing: {}, {} frames in flight", toString(m_pacing.mode), m_pacing.framesInFlight);
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::waitForPresent()
+    {
+        //A present that never completes, e.g. of an occluded window, must not stall the frame loop
+        static constexpr u64 PresentWaitTimeout{ 100'000'000 };
+
+        if (m_frameNumber == 0)
+        {
+            return;
+        }
+
+        const auto waitStart = FrameTiming::Clock::now();
+
+        const auto previousFrame = (m_currentFrame + framesInFlight() - 1) % framesInFlight();
+
+        waitForFences({ &m_inFlightFences[previousFrame], 1 });
+
+        const auto gpuDone = PresentTimer::Clock::now();
+
+        //Without present wait the frame is assumed to be shown as soon as it is rendered
+        auto presented = gpuDone;
+
+        if (usesPresentWait() && m_lastPresentId != 0)
+        {
+            const auto result = m_presentWait->wait(m_swapChain, m_lastPresentId, PresentWaitTimeout);
+
+            if (result == VK_SUCCESS)
+            {
+                presented = PresentTimer::Clock::now();
+            }
+            else if (result == VK_ERROR_OUT_OF_DATE_KHR)
+            {
+                m_recreateRequested = true;
+            }
+            else if (result == VK_ERROR_SURFACE_LOST_KHR)
+            {
+                m_surfaceLost = true;
+            }
+            else if (result == VK_ERROR_DEVICE_LOST)
+            {
+                throw Exception::GPUError("device lost while waiting for a present", result);
+            }
+        }
+
+        m_latencyTracker.markPresent(m_frameNumber - 1, presented);
+
+        m_presentTimer.markPresented(m_frameStart, gpuDone, presented);
+
+        const auto sleepStart = FrameTiming::Clock::now();
+
+        m_frameTiming.add(FrameMetric::PresentWait, sleepStart - waitStart);
+
+        if (const auto start = m_presentTimer.nextFrameStart(); start > sleepStart)
+        {
+            std::this_thread::sleep_until(start);
+
+            m_frameTiming.add(FrameMetric::Idle, FrameTiming::Clock::now() - sleepStart);
+        }
+    }
+
+    template<bool ValidationEnabled>
+    VkDevice
+    SwapChain<ValidationEnabled>::device() const
+    {
+        return m_gpuWrapper.lock()->getLogicalDevice();
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::waitForFences(std::span<const VkFence> fences) const
+    {
+        //A lost device may never signal, the wait returns at once and the whole device has to be rebuilt
+        if (const auto result = vkWaitForFences(device(), to_u32(fences.size()), fences.data(), VK_TRUE, std::numeric_limits<uint64_t>::max()); result == VK_ERROR_DEVICE_LOST)
+        {
+            throw Exception::GPUError("device lost while waiting for a frame", result);
+        }
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::releaseSurface()
+    {
+        if (m_swapChain == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        auto gpuWrapper = m_gpuWrapper.lock();
+        auto& deletionQueue = gpuWrapper->getDeletionQueue();
+
+        //Rare enough to wait for the device, the surface may only be destroyed once nothing built on it is in use
+        vkDeviceWaitIdle(device());
+
+        for (Index_t slot{ 0 }; slot < m_slotFrames.size(); ++slot)
+        {
+            completeSlot(slot);
+        }
+
+        retireSizeDependentResources();
+
+        deletionQueue.destroyLater(m_swapChain);
+
+        //The device is idle, so every retired handle can go, including those of the frame being recorded
+        deletionQueue.flush(device());
+
+        m_swapChain = VK_NULL_HANDLE;
+        m_swapChainImages.clear();
+        m_pendingPresent.reset();
+
+        //Present ids and the present history belong to the released swapchain
+        m_lastPresentId = 0;
+        m_presentTimer.reset();
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::setSurface(VkSurfaceKHR surface)
+    {
+        m_surface = surface;
+
+        m_surfaceLost = false;
+
+        m_recreateRequested = true;
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::requestRecreate(VkExtent2D windowExtent)
+    {
+        m_windowExtent = windowExtent;
+
+        m_recreateRequested = true;
+    }
+
+    template<bool ValidationEnabled>
+    bool
+    SwapChain<ValidationEnabled>::recreate()
+    {
+        auto gpuWrapper = m_gpuWrapper.lock();
+
+        //A minimized window has a zero sized surface, no swapchain can be created until it is restored
+        const auto extent = chooseSwapExtent(gpuWrapper->getSwapChainSupport(m_surface).capabilities);
+
+        if (extent.width == 0 || extent.height == 0)
+        {
+            return false;
+        }
+
+        auto& deletionQueue = gpuWrapper->getDeletionQueue();
+
+        const auto oldSwapChain = m_swapChain;
+        const auto oldImageFormat = m_swapChainImageFormat;
+
+        //The old swapchain keeps presenting while the new one is created from it
+        createSwapChain(oldSwapChain);
+
+        retireSizeDependentResources();
+
+        deletionQueue.destroyLater(oldSwapChain);
+
+        createImageViews();
+
+        const bool depthChanged{ m_pendingDepthEnabled && *m_pendingDepthEnabled != m_depthEnabled };
+
+        if (m_pendingDepthEnabled)
+        {
+            m_depthEnabled = *m_pendingDepthEnabled;
+
+            m_pendingDepthEnabled.reset();
+
+            log::info("Swapchain depth buffer {}", m_depthEnabled ? "enabled" : "disabled");
+        }
+
+        //Pipelines are built for the render pass or, with dynamic rendering, for the color and depth formats,
+        //a plain resize keeps all of them
+        const bool targetChanged{ m_swapChainImageFormat != oldImageFormat || depthChanged };
+
+        if (targetChanged && !usesDynamicRendering())
         {
-            vkDestroySwapchainKHR(m_gpuWrapper. m_gpuWrapper(), m_swapChain, nullptr);
+            deletionQueue.destroyLater(m_renderPass);
+
+            m_renderPass = VK_NULL_HANDLE;
 
-            m_swapChain = nullptr;
+            createRenderPass();
         }
 
-        for (Size_t i{ 0 }; i < m_depthImages.size(); ++i)
+        if (targetChanged)
         {
-            vkDestroyImageView(m_gpuWrapper. m_gpuWrapper(), m_depthImageViews[i], nullptr);
-            vkDestroyImage(m_gpuWrapper. m_gpuWrapper(), m_depthImages[i], nullptr);
-            vkFreeMemory(m_gpuWrapper. m_gpuWrapper(), m_depthImageMemories[i], nullptr);
+            ++m_renderTargetVersion;
+
+            log::info("Swapchain render target changed, pipelines configured for it have to be requested again");
+        }
+
+        createDepthResources();
+
+        if (!usesDynamicRendering())
+        {
+            createFramebuffers();
+        }
+
+        //Fences of the old images do not map to the new ones
+        m_imagesInFlight.assign(imageCount(), VK_NULL_HANDLE);
+
+        //Present ids are per swapchain, the old ones cannot be waited on through the new one
+        m_lastPresentId = 0;
+
+        m_recreateRequested = false;
+
+        log::info("Swapchain recreated {}x{}", m_swapChainExtent.width, m_swapChainExtent.height);
+
+        return true;
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::retireSizeDependentResources()
+    {
+        auto gpuWrapper = m_gpuWrapper.lock();
+        auto& deletionQueue = gpuWrapper->getDeletionQueue();
+
+        //Tagged with the current frame, so they are released once every frame that may use them has finished
+        for (auto imageView : m_swapChainImageViews)
+        {
+            deletionQueue.destroyLater(imageView);
         }
 
         for (auto framebuffer : m_swapChainFramebuffers)
         {
-            vkDestroyFramebuffer(m_gpuWrapper. m_gpuWrapper(), framebuffer, nullptr);
+            deletionQueue.destroyLater(framebuffer);
+        }
+
+        if (m_depthImage != VK_NULL_HANDLE)
+        {
+            deletionQueue.destroyLater(m_depthImageView);
+            deletionQueue.destroyLater(m_depthImage);
+            gpuWrapper->releaseMemory(m_depthImageMemory);
+        }
+
+        m_swapChainImageViews.clear();
+        m_swapChainFramebuffers.clear();
+
+        m_depthImageView = VK_NULL_HANDLE;
+        m_depthImage = VK_NULL_HANDLE;
+        m_depthImageMemory = VK_NULL_HANDLE;
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::beginRendering(VkCommandBuffer commandBuffer, Index_t imageIndex, VkClearColorValue clearColor) const
+    {
+        if (usesDynamicRendering())
+        {
+            const bool hasStencil{ m_depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || m_depthFormat == VK_FORMAT_D24_UNORM_S8_UINT };
+
+            m_dynamicRendering->begin(commandBuffer, RenderTarget
+            {
+                .colorImage = m_swapChainImages[imageIndex],
+                .colorView = m_swapChainImageViews[imageIndex],
+                .depthImage = m_depthImage,
+                .depthView = m_depthImageView,
+                .depthAspect = hasStencil ? VkImageAspectFlags{ VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT } : VkImageAspectFlags{ VK_IMAGE_ASPECT_DEPTH_BIT },
+                .extent = m_swapChainExtent,
+                .clearColor = clearColor
+            });
+
+            return;
+        }
+
+        const std::array<VkClearValue, 2> clearValues
+        {
+            VkClearValue{ .color = clearColor },
+            VkClearValue{ .depthStencil = { 1.0f, 0 } }
+        };
+
+        const VkRenderPassBeginInfo renderPassInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .renderPass = m_renderPass,
+            .framebuffer = m_swapChainFramebuffers[imageIndex],
+            .renderArea = { { 0, 0 }, m_swapChainExtent },
+            .clearValueCount = m_depthEnabled ? to_u32(clearValues.size()) : 1u,
+            .pClearValues = clearValues.data()
+        };
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::endRendering(VkCommandBuffer commandBuffer, Index_t imageIndex) const
+    {
+        if (usesDynamicRendering())
+        {
+            m_dynamicRendering->end(commandBuffer, RenderTarget
+            {
+                .colorImage = m_swapChainImages[imageIndex],
+                .colorView = m_swapChainImageViews[imageIndex]
+            });
+
+            return;
         }
 
-        vkDestroyRenderPass(m_gpuWrapper. m_gpuWrapper(), m_renderPass, nullptr);
+        vkCmdEndRenderPass(commandBuffer);
+    }
 
-        for (Size_t i{ 0 }; i < ImagesInFlight; ++i)
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::configurePipeline(PipelineConfigInfo& config) const
+    {
+        if (usesDynamicRendering())
         {
-            vkDestroySemaphore(m_gpuWrapper. m_gpuWrapper(), m_renderFinishedSemaphores[i], nullptr);
-            vkDestroySemaphore(m_gpuWrapper. m_gpuWrapper(), m_imageAvailableSemaphores[i], nullptr);
-            vkDestroyFence(m_gpuWrapper. m_gpuWrapper(), m_inFlightFences[i], nullptr);
+            //Formats survive swapchain recreation, so do the pipelines built from them
+            config.renderPass = VK_NULL_HANDLE;
+            config.colorAttachmentFormat = m_swapChainImageFormat;
+            config.depthAttachmentFormat = m_depthEnabled ? m_depthFormat : VK_FORMAT_UNDEFINED;
+
+            return;
         }
+
+        config.renderPass = m_renderPass;
+        config.colorAttachmentFormat = VK_FORMAT_UNDEFINED;
+        config.depthAttachmentFormat = VK_FORMAT_UNDEFINED;
     }
 
     template<bool ValidationEnabled>
     VkResult
     SwapChain<ValidationEnabled>::acquireNextImage(Index_t *imageIndex)
     {
-        vkWaitForFences(m_gpuWrapper. m_gpuWrapper(), 1, &m_inFlightFences[m_currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
+        //Nothing can be presented until the owner recreated the surface, see setSurface
+        if (m_surfaceLost)
+        {
+            return VK_ERROR_SURFACE_LOST_KHR;
+        }
+
+        if (m_pendingPacing)
+        {
+            applyPacing();
+        }
+
+        if (m_recreateRequested && !recreate())
+        {
+            return VK_NOT_READY;
+        }
+
+        const auto limiterStart = FrameTiming::Clock::now();
+
+        m_frameLimiter.wait();
+
+        m_frameTiming.add(FrameMetric::Idle, FrameTiming::Clock::now() - limiterStart);
+
+        if (m_pacing.waitForPresent)
+        {
+            waitForPresent();
+        }
+
+        m_frameStart = PresentTimer::Clock::now();
+
+        m_latencyTracker.beginFrame(m_frameNumber);
+
+        const auto logicalDevice = device();
 
-        VkResult result = vkAcquireNextImageKHR(m_gpuWrapper. m_gpuWrapper(), m_swapChain, std::numeric_limits<uint64_t>::max(), m_imageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE, imageIndex);
+        waitForFences({ &m_inFlightFences[m_currentFrame], 1 });
+
+        //The fence we just waited on belongs to the frame submitted framesInFlight frames ago,
+        //its handles are only released once the other windows finished that frame as well
+        completeSlot(m_currentFrame);
+
+        m_gpuWrapper.lock()->getDeletionQueue().collect(logicalDevice);
+
+        u32 acquiredIndex{ 0 };
+
+        VkResult result = vkAcquireNextImageKHR(logicalDevice, m_swapChain, std::numeric_limits<uint64_t>::max(), m_imageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE, &acquiredIndex);
+
+        //Suboptimal images are still presentable, the rebuild waits for the next frame
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+        {
+            m_recreateRequested = true;
+        }
+
+        if (result == VK_ERROR_SURFACE_LOST_KHR)
+        {
+            m_surfaceLost = true;
+        }
+
+        *imageIndex = acquiredIndex;
+
+        m_frameTiming.add(FrameMetric::AcquireWait, FrameTiming::Clock::now() - m_frameStart);
 
         return result;
      }
 
     template<bool ValidationEnabled>
     VkResult
-    SwapChain<ValidationEnabled>::submitCommandBuffers(const VkCommandBuffer *buffers, Index_t *imageIndex)
+    SwapChain<ValidationEnabled>::submitCommandBuffers(const VkCommandBuffer *buffers, Index_t *imageIndex, std::span<const VkRect2D> damage)
+    {
+        submit(buffers, *imageIndex, damage);
+
+        SwapChain* const swapChains[]{ this };
+
+        return present(swapChains);
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::submit(const VkCommandBuffer *buffers, Index_t imageIndex, std::span<const VkRect2D> damage)
     {
-        if (m_imagesInFlight[*imageIndex] != VK_NULL_HANDLE)
+        const auto logicalDevice = device();
+
+        if (m_imagesInFlight[imageIndex] != VK_NULL_HANDLE)
         {
-            vkWaitForFences(m_gpuWrapper. m_gpuWrapper(), 1, &m_imagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
+            waitForFences({ &m_imagesInFlight[imageIndex], 1 });
         }
 
-        m_imagesInFlight[*imageIndex] = m_inFlightFences[m_currentFrame];
+        m_imagesInFlight[imageIndex] = m_inFlightFences[m_currentFrame];
 
         VkSemaphore waitSemaphores[] = { m_imageAvailableSemaphores[m_currentFrame] };
 
@@ -107,94 +667,269 @@ namespace xk::graphics_engine::vulkan
             .pSignalSemaphores = signalSemaphores
         };
 
-        vkResetFences(m_gpuWrapper. m_gpuWrapper(), 1, &m_inFlightFences[m_currentFrame]);
+        vkResetFences(logicalDevice, 1, &m_inFlightFences[m_currentFrame]);
+
+        auto gpuWrapper = m_gpuWrapper.lock();
+
+        if (const auto result = vkQueueSubmit(gpuWrapper->getGraphicsQueue(), 1, &submitInfo, m_inFlightFences[m_currentFrame]); result != VK_SUCCESS)
+        {
+            throw Exception::SwapChainError("failed to submit draw command buffer!", result);
+        }
+
+        auto& deletionQueue = gpuWrapper->getDeletionQueue();
+
+        m_slotFrames[m_currentFrame] = deletionQueue.currentFrame();
 
-        if (vkQueueSubmit(m_gpuWrapper.graphicsQueue(), 1, &submitInfo, m_inFlightFences[m_currentFrame]) != VK_SUCCESS)
+        deletionQueue.markSubmitted(deletionQueue.currentFrame());
+
+        //Increasing across swapchains, 0 is never used so it can mean no present
+        PendingPresent pending{ .imageIndex = static_cast<u32>(imageIndex), .presentId = m_frameNumber + 1 };
+
+        //The window may already have a new size, damage outside of the image is clipped
+        if (m_incrementalPresent)
         {
-            throw Exception::SwapChainError("failed to submit draw command buffer!");
+            pending.damage.reserve(damage.size());
+
+            for (const auto& rect : damage)
+            {
+                const auto x = std::clamp(rect.offset.x, 0, static_cast<s32>(m_swapChainExtent.width));
+                const auto y = std::clamp(rect.offset.y, 0, static_cast<s32>(m_swapChainExtent.height));
+
+                const u32 width = std::min(rect.extent.width, m_swapChainExtent.width - static_cast<u32>(x));
+                const u32 height = std::min(rect.extent.height, m_swapChainExtent.height - static_cast<u32>(y));
+
+                if (width > 0 && height > 0)
+                {
+                    pending.damage.push_back({ .offset = { x, y }, .extent = { width, height }, .layer = 0 });
+                }
+            }
         }
 
-        VkSwapchainKHR swapChains[] = { m_swapChain };
+        m_pendingPresent = std::move(pending);
+    }
+
+    template<bool ValidationEnabled>
+    VkResult
+    SwapChain<ValidationEnabled>::present(std::span<SwapChain* const> swapChains)
+    {
+        std::vector<SwapChain*> pending{};
+
+        std::ranges::copy_if(swapChains, std::back_inserter(pending), [](const SwapChain* swapChain) { return swapChain->hasPendingPresent(); });
 
-        VkPresentInfoKHR presentInfo
+        if (pending.empty())
+        {
+            return VK_SUCCESS;
+        }
+
+        const auto count = to_u32(pending.size());
+
+        std::vector<VkSwapchainKHR> handles{};
+        std::vector<u32> imageIndices{};
+        std::vector<VkSemaphore> waitSemaphores{};
+        std::vector<u64> presentIds{};
+        std::vector<VkPresentRegionKHR> regions{};
+        std::vector<VkResult> results(count, VK_SUCCESS);
+
+        bool hasDamage{ false };
+
+        for (const auto* swapChain : pending)
+        {
+            const auto& request = *swapChain->m_pendingPresent;
+
+            handles.push_back(swapChain->m_swapChain);
+            imageIndices.push_back(request.imageIndex);
+            waitSemaphores.push_back(swapChain->m_renderFinishedSemaphores[swapChain->m_currentFrame]);
+            presentIds.push_back(request.presentId);
+
+            //No rectangles stands for the whole image
+            regions.push_back({ .rectangleCount = to_u32(request.damage.size()), .pRectangles = request.damage.data() });
+
+            hasDamage = hasDamage || !request.damage.empty();
+        }
+
+        //Present wait and incremental present are enabled per device, so they hold for every swapchain of it
+        const auto* first = pending.front();
+
+        const VkPresentIdKHR presentIdInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+            .swapchainCount = count,
+            .pPresentIds = presentIds.data()
+        };
+
+        const VkPresentRegionsKHR presentRegions
+        {
+            .sType = VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR,
+            .pNext = first->usesPresentWait() ? &presentIdInfo : nullptr,
+            .swapchainCount = count,
+            .pRegions = regions.data()
+        };
+
+        const void* presentChain = first->usesPresentWait() ? static_cast<const void*>(&presentIdInfo) : nullptr;
+
+        //Without regions every image counts as changed
+        if (first->m_incrementalPresent && hasDamage)
+        {
+            presentChain = &presentRegions;
+        }
+
+        const VkPresentInfoKHR presentInfo
         {
             .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-            .waitSemaphoreCount = 1,
-            .pWaitSemaphores = signalSemaphores,
-            .swapchainCount = 1,
-            .pSwapchains = swapChains,
-            .pImageIndices = imageIndex
+            .pNext = presentChain,
+            .waitSemaphoreCount = count,
+            .pWaitSemaphores = waitSemaphores.data(),
+            .swapchainCount = count,
+            .pSwapchains = handles.data(),
+            .pImageIndices = imageIndices.data(),
+            .pResults = results.data()
         };
 
-        auto result = vkQueuePresentKHR(m_gpuWrapper.presentQueue(), &presentInfo);
+        const auto presentStart = FrameTiming::Clock::now();
+
+        const auto result = vkQueuePresentKHR(first->m_gpuWrapper.lock()->getPresentQueue(), &presentInfo);
+
+        //Every window of the batch waited for the whole present
+        const auto presentTime = FrameTiming::Clock::now() - presentStart;
 
-        m_currentFrame = (m_currentFrame + 1) % ImagesInFlight;
+        for (u32 i{ 0 }; i < count; ++i)
+        {
+            pending[i]->m_frameTiming.add(FrameMetric::PresentWait, presentTime);
+
+            pending[i]->finishPresent(results[i]);
+        }
 
         return result;
-     }
+    }
 
     template<bool ValidationEnabled>
     void
-    SwapChain<ValidationEnabled>::createSwapChain()
+    SwapChain<ValidationEnabled>::finishPresent(VkResult result)
     {
-        SwapChainSupportDetails swapChainSupport =  m_gpuWrapper.getSwapChainSupport();
+        if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+        {
+            m_lastPresentId = m_pendingPresent->presentId;
+        }
+
+        m_pendingPresent.reset();
+
+        //When waiting for presents the sample is closed by waitForPresent() once the frame is shown
+        if (!m_pacing.waitForPresent)
+        {
+            m_latencyTracker.markPresent(m_frameNumber);
+        }
+
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+        {
+            m_recreateRequested = true;
+        }
+
+        if (result == VK_ERROR_SURFACE_LOST_KHR)
+        {
+            m_surfaceLost = true;
+        }
+
+        //Frames skipped since the last present add their waits to this one, the CPU time is what is left
+        const auto presentEnd = FrameTiming::Clock::now();
+
+        if (m_lastPresentEnd)
+        {
+            m_frameTiming.frameNumber = m_frameNumber;
+            m_frameTiming.add(FrameMetric::Frame, presentEnd - *m_lastPresentEnd);
+
+            const auto waits = m_frameTiming[FrameMetric::AcquireWait] + m_frameTiming[FrameMetric::PresentWait] + m_frameTiming[FrameMetric::Idle];
+
+            m_frameTiming[FrameMetric::Cpu] = std::max(0.0f, m_frameTiming[FrameMetric::Frame] - waits);
+
+            m_frameStatistics.record(m_frameTiming);
+        }
+
+        m_lastPresentEnd = presentEnd;
+
+        m_frameTiming = FrameTiming{};
+
+        m_currentFrame = (m_currentFrame + 1) % framesInFlight();
+
+        ++m_frameNumber;
+    }
+
+    template<bool ValidationEnabled>
+    void
+    SwapChain<ValidationEnabled>::createSwapChain(VkSwapchainKHR oldSwapChain)
+    {
+        auto gpuWrapper = m_gpuWrapper.lock();
+
+        SwapChainSupportDetails swapChainSupport = gpuWrapper->getSwapChainSupport(m_surface);
+
+        //A lost surface reports nothing, e.g. a monitor that was unplugged
+        if (swapChainSupport.formats.empty())
+        {
+            m_surfaceLost = true;
+
+            throw Exception::SwapChainError("the surface offers no formats", VK_ERROR_SURFACE_LOST_KHR);
+        }
 
         VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
         VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
         VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
-        Size_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+        //More images let the CPU run further ahead of the display, fewer keep the queue to the display short
+        u32 imageCount = swapChainSupport.capabilities.minImageCount + m_pacing.extraImages;
 
         if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount)
         {
             imageCount = swapChainSupport.capabilities.maxImageCount;
         }
 
-        QueueFamilyIndices indices =  m_gpuWrapper.findPhysicalQueueFamilies();
+        QueueFamilyIndices indices = gpuWrapper->findPhysicalQueueFamilies();
 
         std::array queueFamilyIndices { indices.graphicsFamily.value(), indices.presentFamily.value() };
 
+        const bool isConcurrent{ indices.graphicsFamily != indices.presentFamily };
+
         VkSwapchainCreateInfoKHR createInfo
         {
             .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
-            .surface =  m_gpuWrapper.surface(),
+            .surface = m_surface,
             .minImageCount = imageCount,
             .imageFormat = surfaceFormat.format,
             .imageColorSpace = surfaceFormat.colorSpace,
             .imageExtent = extent,
             .imageArrayLayers = 1,
             .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+            .imageSharingMode = isConcurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+            .queueFamilyIndexCount = isConcurrent ? to_u32(queueFamilyIndices.size()) : 0,
+            .pQueueFamilyIndices = isConcurrent ? queueFamilyIndices.data() : nullptr,
+            .preTransform = swapChainSupport.capabilities.currentTransform,
             .compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
             .presentMode = presentMode,
             .clipped = VK_TRUE,
-            .oldSwapchain = VK_NULL_HANDLE,
-            .preTransform = swapChainSupport.capabilities.currentTransform
+            //Lets the driver reuse resources of the retired swapchain, which stays valid until its frames finish
+            .oldSwapchain = oldSwapChain
         };
 
-        if (indices.graphicsFamily != indices.presentFamily)
-        {
-            createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-            createInfo.queueFamilyIndexCount = to_u32(queueFamilyIndices.size());
-            createInfo.pQueueFamilyIndices = queueFamilyIndices.data();
-        }
-        else
-        {
-            createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-            createInfo.queueFamilyIndexCount = 0;
-            createInfo.pQueueFamilyIndices = nullptr;
-        }
+        VkSwapchainKHR swapChain{ VK_NULL_HANDLE };
 
-        if (vkCreateSwapchainKHR(m_gpuWrapper. m_gpuWrapper(), &createInfo, nullptr, &m_swapChain) != VK_SUCCESS)
+        if (const auto result = vkCreateSwapchainKHR(device(), &createInfo, nullptr, &swapChain); result != VK_SUCCESS)
         {
-            throw Exception::SwapChainError("failed to create swap chain!");
+            if (result == VK_ERROR_SURFACE_LOST_KHR)
+            {
+                m_surfaceLost = true;
+            }
+
+            throw Exception::SwapChainError("failed to create swap chain!", result);
         }
 
-        vkGetSwapchainImagesKHR(m_gpuWrapper. m_gpuWrapper(), m_swapChain, &imageCount, nullptr);
+        m_swapChain = swapChain;
+
+        vkGetSwapchainImagesKHR(device(), m_swapChain, &imageCount, nullptr);
         m_swapChainImages.resize(imageCount);
 
-        vkGetSwapchainImagesKHR(m_gpuWrapper. m_gpuWrapper(), m_swapChain, &imageCount, m_swapChainImages.data());
+        vkGetSwapchainImagesKHR(device(), m_swapChain, &imageCount, m_swapChainImages.data());
 
         m_swapChainImageFormat = surfaceFormat.format;
+        m_colorSpace = surfaceFormat.colorSpace;
+        m_presentMode = presentMode;
         m_swapChainExtent = extent;
      }
 
@@ -212,14 +947,10 @@ namespace xk::graphics_engine::vulkan
                 .image = m_swapChainImages[i],
                 .viewType = VK_IMAGE_VIEW_TYPE_2D,
                 .format = m_swapChainImageFormat,
-                .subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                .subresourceRange.baseMipLevel = 0,
-                .subresourceRange.levelCount = 1,
-                .subresourceRange.baseArrayLayer = 0,
-                .subresourceRange.layerCount = 1
+                .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
             };
 
-            if (vkCreateImageView(m_gpuWrapper. m_gpuWrapper(), &viewInfo, nullptr, &m_swapChainImageViews[i]) != VK_SUCCESS)
+            if (vkCreateImageView(device(), &viewInfo, nullptr, &m_swapChainImageViews[i]) != VK_SUCCESS)
             {
                 throw Exception::SwapChainError("failed to create texture image view!");
             }
@@ -232,7 +963,7 @@ namespace xk::graphics_engine::vulkan
     {
         VkAttachmentDescription depthAttachment
         {
-            .format = findDepthFormat(),
+            .format = m_depthFormat,
             .samples = VK_SAMPLE_COUNT_1_BIT,
             .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
             .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
@@ -254,8 +985,8 @@ namespace xk::graphics_engine::vulkan
             .samples = VK_SAMPLE_COUNT_1_BIT,
             .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
             .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
             .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
             .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
             .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
         };
@@ -271,17 +1002,18 @@ namespace xk::graphics_engine::vulkan
             .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
             .colorAttachmentCount = 1,
             .pColorAttachments = &colorAttachmentRef,
-            .pDepthStencilAttachment = &depthAttachmentRef
+            .pDepthStencilAttachment = m_depthEnabled ? &depthAttachmentRef : nullptr
         };
 
+        //The depth buffer is shared by all frames, its clear has to wait for the depth writes of the previous frame
         VkSubpassDependency dependency
         {
             .srcSubpass = VK_SUBPASS_EXTERNAL,
             .dstSubpass = 0,
-            .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-            .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-            .srcAccessMask = 0,
-            .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+            .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
         };
 
         std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
@@ -289,7 +1021,7 @@ namespace xk::graphics_engine::vulkan
         VkRenderPassCreateInfo renderPassInfo
         {
             .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-            .attachmentCount = to_u32(attachments.size()),
+            .attachmentCount = m_depthEnabled ? to_u32(attachments.size()) : 1u,
             .pAttachments = attachments.data(),
             .subpassCount = 1,
             .pSubpasses = &subpass,
@@ -297,7 +1029,7 @@ namespace xk::graphics_engine::vulkan
             .pDependencies = &dependency
         };
 
-        if (vkCreateRenderPass(m_gpuWrapper. m_gpuWrapper(), &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS)
+        if (vkCreateRenderPass(device(), &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS)
         {
             throw Exception::SwapChainError("failed to create render pass!");
         }
@@ -311,21 +1043,21 @@ namespace xk::graphics_engine::vulkan
 
         for (Index_t i{ 0 }; i < imageCount(); ++i)
         {
-            std::array<VkImageView, 2> attachments = {m_swapChainImageViews[i], m_depthImageViews[i]};
+            std::array<VkImageView, 2> attachments = {m_swapChainImageViews[i], m_depthImageView};
 
             VkExtent2D swapChainExtent = getSwapChainExtent();
             VkFramebufferCreateInfo framebufferInfo
             {
                 .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
                 .renderPass = m_renderPass,
-                .attachmentCount = to_u32(attachments.size()),
+                .attachmentCount = m_depthEnabled ? to_u32(attachments.size()) : 1u,
                 .pAttachments = attachments.data(),
                 .width = swapChainExtent.width,
                 .height = swapChainExtent.height,
                 .layers = 1
             };
 
-            if (vkCreateFramebuffer(m_gpuWrapper. m_gpuWrapper(), &framebufferInfo, nullptr, &m_swapChainFramebuffers[i]) != VK_SUCCESS)
+            if (vkCreateFramebuffer(device(), &framebufferInfo, nullptr, &m_swapChainFramebuffers[i]) != VK_SUCCESS)
             {
                 throw Exception::SwapChainError("failed to create framebuffer!");
             }
@@ -336,52 +1068,44 @@ namespace xk::graphics_engine::vulkan
     void
     SwapChain<ValidationEnabled>::createDepthResources()
     {
-        VkFormat depthFormat = findDepthFormat();
-        VkExtent2D swapChainExtent = getSwapChainExtent();
+        if (!m_depthEnabled)
+        {
+            return;
+        }
 
-        m_depthImages.resize(imageCount());
-        m_depthImageMemories.resize(imageCount());
-        m_depthImageViews.resize(imageCount());
+        const VkExtent2D swapChainExtent = getSwapChainExtent();
 
-        for (Index_t i{ 0 }; i < m_depthImages.size(); ++i)
+        //One image for every frame, frames on the one graphics queue are ordered by the barrier in front of the rendering
+        const VkImageCreateInfo imageInfo
         {
-            VkImageCreateInfo imageInfo
-            {
-                .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
-                .imageType = VK_IMAGE_TYPE_2D,
-                .extent.width = swapChainExtent.width,
-                .extent.height = swapChainExtent.height,
-                .extent.depth = 1,
-                .mipLevels = 1,
-                .arrayLayers = 1,
-                .format = depthFormat,
-                .tiling = VK_IMAGE_TILING_OPTIMAL,
-                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-                .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                .samples = VK_SAMPLE_COUNT_1_BIT,
-                .flags = 0,
-                .sharingMode = VK_SHARING_MODE_EXCLUSIVE
-            };
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .flags = 0,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = m_depthFormat,
+            .extent = { swapChainExtent.width, swapChainExtent.height, 1 },
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        };
 
-            m_gpuWrapper.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_depthImages[i], m_depthImageMemories[i]);
+        std::tie(m_depthImage, m_depthImageMemory) = m_gpuWrapper.lock()->createTransientAttachment(imageInfo, MemoryCategory::SwapChain);
 
-            VkImageViewCreateInfo viewInfo
-            {
-                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-                .image = m_depthImages[i],
-                .viewType = VK_IMAGE_VIEW_TYPE_2D,
-                .format = depthFormat,
-                .subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT,
-                .subresourceRange.baseMipLevel = 0,
-                .subresourceRange.levelCount = 1,
-                .subresourceRange.baseArrayLayer = 0,
-                .subresourceRange.layerCount = 1
-            };
+        VkImageViewCreateInfo viewInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = m_depthImage,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = m_depthFormat,
+            .subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 }
+        };
 
-            if (vkCreateImageView(m_gpuWrapper. m_gpuWrapper(), &viewInfo, nullptr, &m_depthImageViews[i]) != VK_SUCCESS)
-            {
-                throw Exception::SwapChainError("failed to create texture image view!");
-            }
+        if (vkCreateImageView(device(), &viewInfo, nullptr, &m_depthImageView) != VK_SUCCESS)
+        {
+            throw Exception::SwapChainError("failed to create texture image view!");
         }
     }
 
@@ -389,14 +1113,15 @@ namespace xk::graphics_engine::vulkan
     void
     SwapChain<ValidationEnabled>::createSyncObjects()
     {
-        m_imageAvailableSemaphores.resize(ImagesInFlight);
-        m_renderFinishedSemaphores.resize(ImagesInFlight);
-        m_inFlightFences.resize(ImagesInFlight);
+        m_imageAvailableSemaphores.resize(framesInFlight());
+        m_renderFinishedSemaphores.resize(framesInFlight());
+        m_inFlightFences.resize(framesInFlight());
         m_imagesInFlight.resize(imageCount(), VK_NULL_HANDLE);
+        m_slotFrames.assign(framesInFlight(), std::nullopt);
 
         VkSemaphoreCreateInfo semaphoreInfo
         {
-            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
         };
 
         VkFenceCreateInfo fenceInfo
@@ -405,17 +1130,17 @@ namespace xk::graphics_engine::vulkan
             .flags = VK_FENCE_CREATE_SIGNALED_BIT
         };
 
-        for (Index_t i{ 0 }; i < ImagesInFlight; ++i)
+        for (Index_t i{ 0 }; i < framesInFlight(); ++i)
         {
-            if (vkCreateSemaphore(m_gpuWrapper.m_gpuWrapper(), &semaphoreInfo, nullptr, &m_imageAvailableSemaphores[i]) != VK_SUCCESS)
+            if (vkCreateSemaphore(device(), &semaphoreInfo, nullptr, &m_imageAvailableSemaphores[i]) != VK_SUCCESS)
             {
                 throw Exception::SwapChainError("failed to create synchronization objects for a frame!");
             }
-            if (vkCreateSemaphore(m_gpuWrapper.m_gpuWrapper(), &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS)
+            if (vkCreateSemaphore(device(), &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS)
             {
                 throw Exception::SwapChainError("failed to create synchronization objects for a frame!");
             }
-            if (vkCreateFence(m_gpuWrapper.m_gpuWrapper(), &fenceInfo, nullptr, &m_inFlightFences[i]) != VK_SUCCESS)
+            if (vkCreateFence(device(), &fenceInfo, nullptr, &m_inFlightFences[i]) != VK_SUCCESS)
             {
                 throw Exception::SwapChainError("failed to create synchronization objects for a frame!");
             }
@@ -425,45 +1150,39 @@ namespace xk::graphics_engine::vulkan
     VkSurfaceFormatKHR
     SwapChain<ValidationEnabled>::chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &availableFormats)
     {
-        for (const auto &availableFormat : availableFormats)
+        const auto surfaceFormat = m_surfaceFormatPolicy.choose(availableFormats);
+
+        //Logged only when it changes, a resize negotiates the same format again
+        if (surfaceFormat.format != m_swapChainImageFormat || surfaceFormat.colorSpace != m_colorSpace || m_swapChain == VK_NULL_HANDLE)
         {
-            if (availableFormat.format == VK_FORMAT_B8G8R8A8_UNORM && availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
-            {
-                return availableFormat;
-            }
+            const auto cost = SurfaceFormatCost::of(surfaceFormat);
+
+            log::info("Surface format: {} in {}, {} bytes per pixel, output transfer {}",
+                      static_cast<u32>(surfaceFormat.format), toString(surfaceFormat.colorSpace), cost.bytesPerPixel, toString(cost.transfer));
         }
 
-        return availableFormats[0];
+        return surfaceFormat;
     }
 
     template<bool ValidationEnabled>
     VkPresentModeKHR
     SwapChain<ValidationEnabled>::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
     {
-         for (const auto &presentMode : availablePresentModes)
-         {
-             if (presentMode == VK_PRESENT_MODE_MAILBOX_KHR)
-             {
-                 log::info("Present mode: Mailbox");
-
-                 return presentMode;
-             }
-         }
-
-        for (const auto &presentMode : availablePresentModes)
+        for (const auto preferred : m_pacing.presentModes)
         {
-            if (presentMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
+            if (std::ranges::find(availablePresentModes, preferred) != availablePresentModes.end())
             {
-                log::info("Present mode: Immediate");
+                log::info("Present mode: {}", toString(preferred));
 
-                return presentMode;
+                return preferred;
             }
         }
 
-        log::info("Present mode: Immediate");
+        //Required to be supported by every surface
+        log::info("Present mode: {}", toString(VK_PRESENT_MODE_FIFO_KHR));
 
-         return VK_PRESENT_MODE_FIFO_KHR;
-     }
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
 
     template<bool ValidationEnabled>
     VkExtent2D
@@ -489,8 +1208,11 @@ namespace xk::graphics_engine::vulkan
     VkFormat
     SwapChain<ValidationEnabled>::findDepthFormat()
     {
-        return m_gpuWrapper.findSupportedFormat( {  VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT },
-                                                    VK_IMAGE_TILING_OPTIMAL,
-                                                    VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+        return m_gpuWrapper.lock()->findSupportedFormat( {  VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT },
+                                                         VK_IMAGE_TILING_OPTIMAL,
+                                                         VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
     }
-}
\ No newline at end of file
+
+    template class SwapChain<true>;
+    template class SwapChain<false>;
+}
@@ -0,0 +1,74 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <catch2/catch.hpp>
+
+#include <window/win_damage_region.h>
+
+using namespace xk::win;
+
+TEST_CASE("Rectangles are clipped to the window", "[damage_region]")
+{
+    DamageRegion damage{};
+
+    damage.setBounds(100, 100);
+
+    damage.add({ .x = -10, .y = 90, .width = 30, .height = 30 });
+    damage.add({ .x = 200, .y = 0, .width = 10, .height = 10 });
+
+    REQUIRE(damage.rects() == std::vector<Rect>{ { .x = 0, .y = 90, .width = 20, .height = 10 } });
+}
+
+TEST_CASE("Overlapping and touching rectangles merge into their bounding box", "[damage_region]")
+{
+    DamageRegion damage{};
+
+    damage.setBounds(100, 100);
+
+    damage.add({ .x = 0, .y = 0, .width = 10, .height = 10 });
+    damage.add({ .x = 10, .y = 0, .width = 10, .height = 10 });
+
+    REQUIRE(damage.rects() == std::vector<Rect>{ { .x = 0, .y = 0, .width = 20, .height = 10 } });
+
+    //Separate from the first, until the third one grows it into both
+    damage.add({ .x = 50, .y = 50, .width = 10, .height = 10 });
+
+    REQUIRE(damage.rects().size() == 2);
+
+    damage.add({ .x = 15, .y = 5, .width = 40, .height = 50 });
+
+    REQUIRE(damage.rects() == std::vector<Rect>{ { .x = 0, .y = 0, .width = 60, .height = 60 } });
+}
+
+TEST_CASE("Too many rectangles collapse into one", "[damage_region]")
+{
+    DamageRegion damage{};
+
+    damage.setBounds(1000, 1000);
+
+    for (s32 i{ 0 }; i <= static_cast<s32>(DamageRegion::MaxRects); ++i)
+    {
+        damage.add({ .x = i * 20, .y = 0, .width = 10, .height = 10 });
+    }
+
+    REQUIRE(damage.rects().size() == 1);
+    REQUIRE(damage.bounds() == Rect{ .x = 0, .y = 0, .width = static_cast<u32>(DamageRegion::MaxRects) * 20 + 10, .height = 10 });
+}
+
+TEST_CASE("Shrinking the window clips the damage", "[damage_region]")
+{
+    DamageRegion damage{};
+
+    damage.setBounds(100, 100);
+    damage.addAll();
+
+    damage.setBounds(40, 30);
+
+    REQUIRE(damage.bounds() == Rect{ .x = 0, .y = 0, .width = 40, .height = 30 });
+
+    damage.clear();
+
+    REQUIRE(damage.isEmpty());
+    REQUIRE(damage.bounds().isEmpty());
+}
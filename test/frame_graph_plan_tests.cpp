@@ -0,0 +1,109 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <catch2/catch.hpp>
+
+#include <xk-graphics-engine/xk-vulkan/vk_frame_graph_plan.h>
+
+using namespace xk::graphics_engine::vulkan;
+
+namespace
+{
+    using Pass = FrameGraphPlan::Pass;
+    using Resource = FrameGraphPlan::Resource;
+    using Transient = FrameGraphPlan::Transient;
+
+    Transient transient(VkDeviceSize size, FrameGraphPlan::Lifetime lifetime, bool lazy = false)
+    {
+        return { .requirements = { .size = size, .alignment = 256, .memoryTypeBits = 0b11 }, .lifetime = lifetime, .lazy = lazy };
+    }
+}
+
+TEST_CASE("Passes writing imported resources survive, unread chains are culled", "[frame_graph]")
+{
+    //0 is imported, the back buffer, 1 and 2 are transients
+    const std::vector<Resource> resources{ { .imported = true }, {}, {} };
+
+    const std::vector<Pass> passes
+    {
+        //Feeds the composition
+        { .writes = { 1 } },
+        //Feeds nothing anyone reads
+        { .writes = { 2 } },
+        { .reads = { 2 } },
+        { .reads = { 1 }, .writes = { 0 } }
+    };
+
+    REQUIRE(FrameGraphPlan::cull(passes, resources) == std::vector<bool>{ false, true, true, false });
+}
+
+TEST_CASE("Kept passes are never culled and keep their inputs alive", "[frame_graph]")
+{
+    const std::vector<Resource> resources{ {}, {} };
+
+    const std::vector<Pass> passes
+    {
+        { .writes = { 0 } },
+        { .reads = { 0 }, .writes = { 1 }, .kept = true }
+    };
+
+    REQUIRE(FrameGraphPlan::cull(passes, resources) == std::vector<bool>{ false, false });
+}
+
+TEST_CASE("A resource released by a pass without outputs is visited once", "[frame_graph]")
+{
+    //The producer also writes the back buffer, visiting the transient twice would cull it
+    const std::vector<Resource> resources{ { .imported = true }, {} };
+
+    const std::vector<Pass> passes
+    {
+        { .writes = { 1, 0 } },
+        { .reads = { 1 } }
+    };
+
+    REQUIRE(FrameGraphPlan::cull(passes, resources) == std::vector<bool>{ false, true });
+}
+
+TEST_CASE("Transients with disjoint lifetimes share a block", "[frame_graph]")
+{
+    const std::vector transients
+    {
+        transient(4096, { 0, 1 }),
+        transient(2048, { 2, 3 }),
+        transient(1024, { 1, 2 })
+    };
+
+    const auto aliasing = FrameGraphPlan::alias(transients);
+
+    REQUIRE(aliasing.blocks.size() == 2);
+    REQUIRE(aliasing.blockOf[0] == aliasing.blockOf[1]);
+    REQUIRE(aliasing.blockOf[2] != aliasing.blockOf[0]);
+
+    //Sized by the largest occupant
+    REQUIRE(aliasing.blocks[aliasing.blockOf[0]].requirements.size == 4096);
+}
+
+TEST_CASE("Larger, lazy or incompatible transients get their own block", "[frame_graph]")
+{
+    auto otherMemory = transient(1024, { 2, 2 });
+
+    otherMemory.requirements.memoryTypeBits = 0b100;
+
+    const std::vector transients
+    {
+        transient(1024, { 0, 0 }),
+        //Placed first, so the smaller one above fits behind it
+        transient(4096, { 1, 1 }),
+        transient(512, { 3, 3 }, true),
+        otherMemory
+    };
+
+    const auto aliasing = FrameGraphPlan::alias(transients);
+
+    REQUIRE(aliasing.blockOf[0] == aliasing.blockOf[1]);
+    REQUIRE(aliasing.blocks[aliasing.blockOf[2]].lazy);
+    REQUIRE(aliasing.blockOf[2] != aliasing.blockOf[0]);
+    REQUIRE(aliasing.blockOf[3] != aliasing.blockOf[0]);
+    REQUIRE(aliasing.blocks.size() == 3);
+}
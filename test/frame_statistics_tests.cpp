@@ -0,0 +1,76 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <catch2/catch.hpp>
+
+#include <xk-graphics-engine/xk-vulkan/vk_frame_statistics.h>
+
+using namespace xk::graphics_engine::vulkan;
+
+namespace
+{
+    void recordFrames(FrameStatistics& statistics, u64 count, f32 (*frameTime)(u64))
+    {
+        for (u64 i{ 0 }; i < count; ++i)
+        {
+            FrameTiming timing{ .frameNumber = i };
+
+            timing[FrameMetric::Frame] = frameTime(i);
+
+            statistics.record(timing);
+        }
+    }
+}
+
+TEST_CASE("Percentiles use the nearest rank of the window", "[frame_statistics]")
+{
+    FrameStatistics statistics{};
+
+    //1 to 100 ms in a shuffled order, the summary sorts its copy
+    recordFrames(statistics, 100, [](u64 i) { return static_cast<f32>((i * 37) % 100 + 1); });
+
+    const auto summary = statistics.summary(100);
+
+    REQUIRE(summary.samples == 100);
+    REQUIRE(summary[FrameMetric::Frame].p50 == 50.0f);
+    REQUIRE(summary[FrameMetric::Frame].p95 == 95.0f);
+    REQUIRE(summary[FrameMetric::Frame].p99 == 99.0f);
+    REQUIRE(summary[FrameMetric::Frame].max == 100.0f);
+}
+
+TEST_CASE("Summaries only cover the most recent frames", "[frame_statistics]")
+{
+    FrameStatistics statistics{};
+
+    recordFrames(statistics, FrameStatistics::Capacity + 10, [](u64 i) { return i < FrameStatistics::Capacity ? 100.0f : 10.0f; });
+
+    const auto summary = statistics.summary(10);
+
+    REQUIRE(summary.samples == 10);
+    REQUIRE(summary[FrameMetric::Frame].max == 10.0f);
+
+    const auto latest = statistics.latest(3);
+
+    REQUIRE(latest.size() == 3);
+    REQUIRE(latest.back().frameNumber == FrameStatistics::Capacity + 9);
+}
+
+TEST_CASE("Frames above twice the median are hitches", "[frame_statistics]")
+{
+    FrameStatistics statistics{};
+
+    recordFrames(statistics, 20, [](u64 i) { return i % 10 == 9 ? 40.0f : 16.0f; });
+
+    REQUIRE(statistics.summary(20).hitches == 2);
+}
+
+TEST_CASE("An empty window has no samples", "[frame_statistics]")
+{
+    const FrameStatistics statistics{};
+
+    const auto summary = statistics.summary();
+
+    REQUIRE(summary.samples == 0);
+    REQUIRE(summary[FrameMetric::Frame].max == 0.0f);
+}
@@ -0,0 +1,88 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <catch2/catch.hpp>
+
+#include <xk-graphics-engine/xk-vulkan/vk_gpu_selector.h>
+
+using namespace xk::graphics_engine::vulkan;
+
+namespace
+{
+    GpuCandidate candidate(VkPhysicalDeviceType type, u64 deviceLocalBytes, std::string_view name, bool isSuitable = true)
+    {
+        GpuCandidate gpu{ .isSuitable = isSuitable };
+
+        gpu.properties.deviceType = type;
+
+        name.copy(gpu.properties.deviceName, name.size());
+
+        gpu.memoryProperties.memoryHeapCount = 1;
+        gpu.memoryProperties.memoryHeaps[0] = { .size = deviceLocalBytes, .flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT };
+
+        gpu.queueFamilies.push_back({ .queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT, .queueCount = 1 });
+
+        return gpu;
+    }
+
+    constexpr u64 GiB{ 1024ull * 1024 * 1024 };
+}
+
+TEST_CASE("Device type dominates the GPU score", "[gpu_selector]")
+{
+    const auto discrete = candidate(VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 2 * GiB, "Discrete");
+    const auto integrated = candidate(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 32 * GiB, "Integrated");
+
+    REQUIRE(GpuSelector::score(discrete) > GpuSelector::score(integrated));
+}
+
+TEST_CASE("VRAM and queue topology break ties between devices of the same type", "[gpu_selector]")
+{
+    const auto small = candidate(VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 4 * GiB, "Small");
+    const auto large = candidate(VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 8 * GiB, "Large");
+
+    REQUIRE(GpuSelector::score(large) > GpuSelector::score(small));
+
+    auto asyncCompute = small;
+
+    asyncCompute.queueFamilies.push_back({ .queueFlags = VK_QUEUE_COMPUTE_BIT, .queueCount = 1 });
+
+    REQUIRE(GpuSelector::score(asyncCompute) == GpuSelector::score(small) + 200);
+}
+
+TEST_CASE("Unsuitable devices rank last and are never selected", "[gpu_selector]")
+{
+    const std::vector candidates
+    {
+        candidate(VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 8 * GiB, "Unsuitable", false),
+        candidate(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 1 * GiB, "Suitable")
+    };
+
+    const auto ranking = GpuSelector::rank(candidates);
+
+    REQUIRE(ranking.size() == 2);
+    REQUIRE(ranking.front().candidate == 1);
+    REQUIRE_FALSE(ranking.back().isSuitable);
+
+    REQUIRE(GpuSelector::select(candidates) == std::optional<Index_t>{ 1 });
+
+    REQUIRE_FALSE(GpuSelector::select(std::span{ candidates }.first(1)).has_value());
+}
+
+TEST_CASE("A preference matching a suitable device overrides the score", "[gpu_selector]")
+{
+    auto integrated = candidate(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 1 * GiB, "Intel UHD Graphics");
+
+    integrated.uuid = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef };
+
+    const std::vector candidates{ candidate(VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 8 * GiB, "NVIDIA GeForce"), integrated };
+
+    REQUIRE(GpuSelector::select(candidates, GpuPreference{ .nameOrUuid = "intel" }) == std::optional<Index_t>{ 1 });
+
+    REQUIRE(GpuSelector::formatUuid(integrated.uuid) == "01234567-89ab-cdef-0123-456789abcdef");
+    REQUIRE(GpuSelector::select(candidates, GpuPreference{ .nameOrUuid = "01234567-89AB-CDEF-0123-456789ABCDEF" }) == std::optional<Index_t>{ 1 });
+
+    //Nothing matches, the best score wins
+    REQUIRE(GpuSelector::select(candidates, GpuPreference{ .nameOrUuid = "radeon" }) == std::optional<Index_t>{ 0 });
+}
@@ -0,0 +1,117 @@
+//
+// Created by kafka on 10/19/2026.
+//
+
+#include <catch2/catch.hpp>
+
+#include <xk-graphics-engine/xk-vulkan/vk_exceptions.h>
+#include <xk-graphics-engine/xk-vulkan/vk_pipeline_key.h>
+
+using namespace xk::graphics_engine::vulkan;
+
+TEST_CASE("Equal configs give equal keys and hashes", "[pipeline_key]")
+{
+    const auto config = PipelineConfigInfo::defaultPipelineConfigInfo();
+
+    const auto first = PipelineKey::fromConfig(config, 1, 2);
+    const auto second = PipelineKey::fromConfig(config, 1, 2);
+
+    REQUIRE(first == second);
+    REQUIRE(first.hash() == second.hash());
+}
+
+TEST_CASE("Every part of the state changes the key", "[pipeline_key]")
+{
+    const auto base = PipelineKey::fromConfig(PipelineConfigInfo::defaultPipelineConfigInfo(), 1, 2);
+
+    REQUIRE(PipelineKey::fromConfig(PipelineConfigInfo::defaultPipelineConfigInfo(), 1, 3) != base);
+
+    auto config = PipelineConfigInfo::defaultPipelineConfigInfo();
+
+    SECTION("line width")
+    {
+        config.rasterizationStateCreateInfo.lineWidth = 2.0f;
+    }
+
+    SECTION("blend constants")
+    {
+        config.colorBlendStateCreateInfo.blendConstants[2] = 0.5f;
+    }
+
+    SECTION("dynamic states")
+    {
+        config.dynamicStateEnables.push_back(VK_DYNAMIC_STATE_LINE_WIDTH);
+    }
+
+    SECTION("color format")
+    {
+        config.colorAttachmentFormat = VK_FORMAT_B8G8R8A8_SRGB;
+    }
+
+    SECTION("depth format")
+    {
+        config.depthAttachmentFormat = VK_FORMAT_D32_SFLOAT;
+    }
+
+    const auto changed = PipelineKey::fromConfig(config, 1, 2);
+
+    REQUIRE(changed != base);
+    REQUIRE(changed.hash() != base.hash());
+}
+
+TEST_CASE("toConfig is the inverse of fromConfig", "[pipeline_key]")
+{
+    auto config = PipelineConfigInfo::defaultPipelineConfigInfo();
+
+    config.rasterizationStateCreateInfo.cullMode = VK_CULL_MODE_BACK_BIT;
+    config.rasterizationStateCreateInfo.depthBiasEnable = VK_TRUE;
+    config.rasterizationStateCreateInfo.depthBiasConstantFactor = 1.25f;
+    config.rasterizationStateCreateInfo.lineWidth = 3.0f;
+    config.multisampleStateCreateInfo.sampleShadingEnable = VK_TRUE;
+    config.multisampleStateCreateInfo.minSampleShading = 0.5f;
+    config.colorBlendStateCreateInfo.logicOpEnable = VK_TRUE;
+    config.colorBlendStateCreateInfo.logicOp = VK_LOGIC_OP_XOR;
+    config.colorBlendStateCreateInfo.blendConstants[0] = 0.25f;
+    config.colorAttachmentFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+    config.depthAttachmentFormat = VK_FORMAT_D32_SFLOAT;
+
+    config.bindingDescriptions = { { .binding = 0, .stride = 20, .inputRate = VK_VERTEX_INPUT_RATE_VERTEX } };
+    config.attributeDescriptions =
+    {
+        { .location = 0, .binding = 0, .format = VK_FORMAT_R32G32_SFLOAT, .offset = 0 },
+        { .location = 1, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT, .offset = 8 }
+    };
+
+    const auto key = PipelineKey::fromConfig(config, 4, 5);
+
+    const auto restored = key.toConfig();
+
+    REQUIRE(restored.rasterizationStateCreateInfo.lineWidth == 3.0f);
+    REQUIRE(restored.multisampleStateCreateInfo.minSampleShading == 0.5f);
+    REQUIRE(restored.colorBlendStateCreateInfo.logicOp == VK_LOGIC_OP_XOR);
+    REQUIRE(restored.attributeDescriptions.size() == 2);
+
+    REQUIRE(PipelineKey::fromConfig(restored, 4, 5) == key);
+}
+
+TEST_CASE("State the key cannot represent is rejected", "[pipeline_key]")
+{
+    auto config = PipelineConfigInfo::defaultPipelineConfigInfo();
+
+    SECTION("depth bounds")
+    {
+        config.depthStencilStateCreateInfo.depthBoundsTestEnable = VK_TRUE;
+    }
+
+    SECTION("alpha to coverage")
+    {
+        config.multisampleStateCreateInfo.alphaToCoverageEnable = VK_TRUE;
+    }
+
+    SECTION("dynamic state of an extension")
+    {
+        config.dynamicStateEnables.push_back(VK_DYNAMIC_STATE_CULL_MODE_EXT);
+    }
+
+    REQUIRE_THROWS_AS(PipelineKey::fromConfig(config, 1, 2), Exception);
+}